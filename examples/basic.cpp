@@ -6,23 +6,74 @@
 
 
 #include <memory>
-#include <thread>
+#include <string>
+#include <string_view>
 
+#include <unistd.h>
+
+#include <eltau/event_loop.hpp>
+#include <eltau/input.hpp>
+#include <eltau/task.hpp>
 #include <eltau/terminal.hpp>
 #include <eltau/text.hpp>
 
 namespace {
 using namespace std::chrono_literals;
 constexpr auto c_tick = 100ms;
+constexpr std::size_t c_ticks = 100;
+constexpr std::string_view c_hello = "Hello world, press q or Ctrl+C to quit. ";
+
+/*******************************************************************************
+ * @brief Update the counter every tick.
+ ******************************************************************************/
+eltau::Task
+counter(eltau::Scheduler& sched, eltau::EagerTerminal& term, eltau::ascii::Text& hello, eltau::EventLoop& loop) {
+    for (std::size_t ticks = 1; ticks <= c_ticks; ++ticks) {
+        co_await sched.sleep_for(c_tick);
+        hello.replace(c_hello.size(), std::string::npos, std::to_string(ticks));
+        term.compositor().invalidate(term.root_layer());
+        loop.request_redraw();
+    }
+    loop.stop();
+}
+
+/*******************************************************************************
+ * @brief Stop on q or Ctrl+C, raw mode does not turn it into a signal.
+ ******************************************************************************/
+eltau::Task
+quit(eltau::Scheduler& sched, eltau::EventLoop& loop) {
+    while (true) {
+        const auto event = co_await sched.next_input();
+        if (event.m_key == eltau::Key::Char &&
+            ((event.m_char == 'q' && event.m_mods == 0) || (event.m_char == 'c' && event.m_mods == eltau::Ctrl)))
+            break;
+    }
+    loop.stop();
+}
 } // namespace
 int
 main() {
-    eltau::EagerTerminal term{std::make_unique<eltau::ascii::Text>("Hello world")};
+    // Created first, other threads would inherit its signal mask.
+    eltau::EventLoop loop{STDIN_FILENO};
+    eltau::Scheduler sched{loop};
 
-    for (std::size_t i = 0; i < 100; ++i) {
-        term.draw();
-        std::this_thread::sleep_for(c_tick);
-    }
+    auto text = std::make_unique<eltau::ascii::Text>(c_hello);
+    auto& hello = *text;
+    eltau::EagerTerminal term{std::move(text)};
+    term.attach(loop);
+
+    eltau::InputDecoder decoder;
+    loop.on_input([&](std::string_view input) {
+        while (!input.empty()) {
+            input.remove_prefix(decoder.feed(input));
+            while (const auto event = decoder.pop())
+                sched.dispatch(*event);
+        }
+    });
+
+    sched.spawn(counter(sched, term, hello, loop));
+    sched.spawn(quit(sched, loop));
+    loop.run();
 
     return 0;
 }
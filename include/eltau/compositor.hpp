@@ -0,0 +1,267 @@
+/*******************************************************************************
+ * @file compositor.hpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <eltau/element.hpp>
+#include <eltau/hit_map.hpp>
+#include <eltau/memory.hpp>
+#include <eltau/screen.hpp>
+
+namespace eltau {
+
+/*******************************************************************************
+ * @brief Z-ordered stack of opaque layers composed into one screen.
+ *
+ * Each layer is an element tree drawn into its own Screen covering the layer's
+ * area. Layers are laid out and drawn only when invalidated or resized, moving,
+ * raising, adding or removing a layer only re-composes the exposed rectangles
+ * from the layers' screens.
+ *
+ * Composition is occlusion-aware: every damaged cell is copied once, from the
+ * top-most layer covering it, lower layers are never touched there. Layers
+ * fully covered by the ones above are not drawn at all until exposed. Cells
+ * not covered by any layer are blank.
+ *
+ * Drawing a layer also fills its HitMap, hit_test() then finds the element
+ * under a mouse event without walking the trees.
+ *
+ * Elements draw with scratch memory from the compositor's FrameArena, which is
+ * reset after every compose(). Steady-state frames do not touch the heap.
+ ******************************************************************************/
+class Compositor {
+public:
+    /*! Stable identifier of a layer. */
+    using LayerId = std::uint32_t;
+
+    /*! Initial size of the scratch arena, it grows to fit the largest frame. */
+    inline constexpr static std::size_t c_arena_bytes = 4096;
+    /*! Pending rectangles kept between frames, more collapse into the whole screen. */
+    inline constexpr static std::size_t c_max_pending = 16;
+
+    /*******************************************************************************
+     * @brief New compositor without layers.
+     *
+     * @param size Size of the composed screen.
+     ******************************************************************************/
+    explicit Compositor(Vec2 size);
+
+    /*******************************************************************************
+     * @brief Add a layer on top of all others.
+     *
+     * @param root Owned element tree, must not be null.
+     * @param area Placement of the layer, clipped by the composed screen.
+     * @return Identifier of the new layer.
+     * @throw EltauException if @p root is null.
+     ******************************************************************************/
+    LayerId
+    add_layer(std::unique_ptr<Element> root, Window area);
+
+    /*******************************************************************************
+     * @brief Remove the layer, its area is exposed.
+     *
+     * @return Root element of the removed layer.
+     * @throw EltauException if @p id is unknown.
+     ******************************************************************************/
+    std::unique_ptr<Element>
+    remove_layer(LayerId id);
+
+    /*******************************************************************************
+     * @brief Move or resize the layer.
+     *
+     * A moved layer is only re-composed, a resized one is laid out again.
+     *
+     * @throw EltauException if @p id is unknown.
+     ******************************************************************************/
+    void
+    move_layer(LayerId id, Window area);
+
+    /*******************************************************************************
+     * @brief Change the size of the composed screen.
+     *
+     * Layers are clipped by the new size, those whose size changed are laid out
+     * again. The clip is taken from the areas passed to add_layer() and
+     * move_layer(), layers cut off by a smaller screen grow back with a larger
+     * one. The whole screen is re-composed. Storage is reused where possible.
+     ******************************************************************************/
+    void
+    resize(Vec2 size);
+
+    /*******************************************************************************
+     * @brief Move the layer on top of all others.
+     *
+     * @throw EltauException if @p id is unknown.
+     ******************************************************************************/
+    void
+    raise_layer(LayerId id);
+
+    /*******************************************************************************
+     * @brief Lay out and draw the layer again at the next compose().
+     *
+     * Must be called whenever the layer's content changes.
+     *
+     * @throw EltauException if @p id is unknown.
+     ******************************************************************************/
+    void
+    invalidate(LayerId id);
+
+    /*******************************************************************************
+     * @brief Current placement of the layer.
+     *
+     * @throw EltauException if @p id is unknown.
+     ******************************************************************************/
+    Window
+    area(LayerId id) const;
+
+    /*******************************************************************************
+     * @brief Root element of the layer.
+     *
+     * @throw EltauException if @p id is unknown.
+     ******************************************************************************/
+    Element&
+    root(LayerId id) const;
+
+    /*******************************************************************************
+     * @brief Number of layers.
+     ******************************************************************************/
+    std::size_t
+    layer_count() const noexcept;
+
+    /*******************************************************************************
+     * @brief Bring the composed screen up-to-date.
+     *
+     * Draws invalidated layers that are not fully covered, then re-composes the
+     * damaged rectangles. Scratch memory of the draws is released afterwards.
+     *
+     * @return Composed screen.
+     ******************************************************************************/
+    const Screen&
+    compose();
+
+    /*******************************************************************************
+     * @brief Inner-most element drawn at @p pos as of the last compose().
+     *
+     * Looks only at the top-most layer at @p pos, O(layers).
+     *
+     * @return Null if there is no layer or no element at @p pos.
+     ******************************************************************************/
+    Element*
+    hit_test(Vec2 pos) const noexcept;
+
+    /*******************************************************************************
+     * @brief Rectangles re-composed by the last compose(), they may overlap, none lies within an earlier one.
+     ******************************************************************************/
+    std::span<const Window>
+    damage() const noexcept;
+
+    /*******************************************************************************
+     * @brief Composed screen as of the last compose().
+     ******************************************************************************/
+    const Screen&
+    screen() const noexcept;
+
+    /*******************************************************************************
+     * @brief Number of layer draws in total, for statistics.
+     ******************************************************************************/
+    std::size_t
+    draw_count() const noexcept;
+
+    /*******************************************************************************
+     * @brief Arena providing the scratch memory of the draws.
+     ******************************************************************************/
+    const FrameArena&
+    arena() const noexcept;
+
+private:
+    /*******************************************************************************
+     * @brief One layer of the stack.
+     ******************************************************************************/
+    struct Layer {
+        LayerId m_id = 0;
+        std::unique_ptr<Element> m_root;
+        /*! Placement as requested, possibly outside of the composed screen. */
+        Window m_requested{{}, {}};
+        /*! m_requested clipped by the composed screen. */
+        Window m_area{{}, {}};
+        /*! Content drawn by m_root, m_area-sized. */
+        Screen m_screen{{}};
+        /*! Elements drawn in m_screen. */
+        HitMap m_hits{{}};
+        /*! Part of m_screen that must be drawn again, in layer coordinates. */
+        Window m_dirty{{}, {}};
+    };
+
+    /*! Columns [first, second) of one row. */
+    using Span = std::pair<std::size_t, std::size_t>;
+
+    /*******************************************************************************
+     * @brief Index of the layer @p id in m_layers.
+     *
+     * @throw EltauException if @p id is unknown.
+     ******************************************************************************/
+    std::size_t
+    find(LayerId id) const;
+
+    /*******************************************************************************
+     * @brief Whether layers above @p idx cover all of @p rect.
+     ******************************************************************************/
+    bool
+    covered(std::size_t idx, const Window& rect);
+
+    /*******************************************************************************
+     * @brief Clip the requested area of @p layer by the composed screen.
+     *
+     * The layer is laid out again if the size of its clipped area changed.
+     ******************************************************************************/
+    void
+    clip(Layer& layer);
+
+    /*******************************************************************************
+     * @brief Re-compose @p rect at the next compose().
+     *
+     * Rectangles inside a pending one are dropped, so are all of them past
+     * c_max_pending in favour of the whole screen. Bounded even if compose() is
+     * not called for a while, e.g. while the terminal's output is stalled.
+     ******************************************************************************/
+    void
+    add_pending(const Window& rect);
+
+    /*******************************************************************************
+     * @brief Copy @p rect from the top-most layers covering it.
+     ******************************************************************************/
+    void
+    blit(const Window& rect);
+
+    /*******************************************************************************
+     * @brief Remove columns of @p area on the composed @p row from m_uncovered.
+     *
+     * @param layer Layer at @p area, the removed columns are copied from it
+     * unless null.
+     ******************************************************************************/
+    void
+    cover(const Window& area, std::size_t row, const Layer* layer);
+
+    Screen m_screen;
+    /*! Bottom to top. */
+    std::vector<Layer> m_layers;
+    LayerId m_next_id = 0;
+    /*! Rectangles to re-compose at the next compose(). */
+    std::vector<Window> m_pending;
+    /*! Rectangles re-composed by the last compose(). */
+    std::vector<Window> m_damage;
+    /*! Columns not covered yet, scratch of cover(). */
+    std::vector<Span> m_uncovered;
+    std::vector<Span> m_next;
+    std::size_t m_draw_count = 0;
+    FrameArena m_arena{c_arena_bytes};
+};
+
+} // namespace eltau
@@ -5,11 +5,16 @@
  ******************************************************************************/
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
 #include <functional>
 #include <memory>
+#include <memory_resource>
 #include <string>
+#include <tuple>
 #include <type_traits>
 
+#include <eltau/hit_map.hpp>
 #include <eltau/screen.hpp>
 
 namespace eltau {
@@ -61,6 +66,8 @@ public:
      *
      * The element can use this window in its entirety. Calculated based on the
      * previously queried preferred size via calc_pref_size().
+     * Nothing is drawn if the window is fully clipped, see DrawingWindow::visible().
+     * The visible part is marked in the window's hit map, if any.
      *
      * @param window Window assigned to this element.
      ******************************************************************************/
@@ -75,6 +82,30 @@ public:
     Vec2
     get_last_pref_size() const noexcept;
 
+    /*******************************************************************************
+     * @brief Allocate an element from the default memory resource.
+     ******************************************************************************/
+    static void*
+    operator new(std::size_t size);
+
+    /*******************************************************************************
+     * @brief Allocate an element from @p resource, see make_element().
+     ******************************************************************************/
+    static void*
+    operator new(std::size_t size, std::pmr::memory_resource* resource);
+
+    /*******************************************************************************
+     * @brief Return an element to the resource it was allocated from.
+     ******************************************************************************/
+    static void
+    operator delete(void* ptr) noexcept;
+
+    /*******************************************************************************
+     * @brief Same as operator delete(void*), used if a constructor throws.
+     ******************************************************************************/
+    static void
+    operator delete(void* ptr, std::pmr::memory_resource* resource) noexcept;
+
 private:
     /*******************************************************************************
      * @brief Virtual version of calc_pref_size().
@@ -92,10 +123,52 @@ private:
     virtual void
     do_draw(DrawingWindow& window) = 0;
 
+    /*******************************************************************************
+     * @brief Part of calc_pref_size() before do_calc_pref_size().
+     *
+     * @return Whether do_calc_pref_size() should be called, m_last_pref_size is
+     * zeroed if not.
+     ******************************************************************************/
+    bool
+    begin_calc_pref_size(Vec2 max_size) noexcept;
+
+    /*******************************************************************************
+     * @brief Part of draw() before do_draw(), marks the visible part as hit.
+     *
+     * @return Whether do_draw() should be called, false if culled.
+     ******************************************************************************/
+    bool
+    begin_draw(DrawingWindow& window);
+
+    friend class ElementAccess;
+
     /*! Cached preferred size. */
     Vec2 m_last_pref_size{};
 };
 
+/*******************************************************************************
+ * @brief Create an element in @p resource, e.g. a pool holding a whole tree.
+ *
+ * The element is returned to @p resource when deleted, the usual owners of
+ * std::unique_ptr<Element> need no changes. If @p E is constructible with a
+ * leading std::allocator_arg, it gets an allocator of @p resource for its own
+ * storage as well.
+ *
+ * @param resource Must outlive the element.
+ ******************************************************************************/
+template <typename E, typename... Args>
+std::unique_ptr<E>
+make_element(std::pmr::memory_resource* resource, Args&&... args) {
+    static_assert(std::is_base_of_v<Element, E>);
+    static_assert(alignof(E) <= alignof(std::max_align_t), "Over-aligned elements are not supported.");
+
+    using Alloc = std::pmr::polymorphic_allocator<>;
+    if constexpr (std::is_constructible_v<E, std::allocator_arg_t, Alloc, Args...>)
+        return std::unique_ptr<E>{new (resource) E(std::allocator_arg, Alloc{resource}, std::forward<Args>(args)...)};
+    else
+        return std::unique_ptr<E>{new (resource) E(std::forward<Args>(args)...)};
+}
+
 // Notes:
 // Is container aligned or should parent control that?
 // Element | hcenter | vcenter | hleft | hright | vup | vdown | hflex | vflex(weight) |  center | flex | scrollable
@@ -106,17 +179,156 @@ private:
 // VContainer{elems...,fmt_string=""}
 // VContainer{{weights,elems}...,fmt_string=" =-+"}
 
+/*******************************************************************************
+ * @brief Non-virtual access to elements of statically known types.
+ *
+ * Elements befriending this class let the static containers call their do_*()
+ * directly, which the compiler can inline. Others go through the virtual
+ * Element interface.
+ ******************************************************************************/
+class ElementAccess {
+public:
+    /*******************************************************************************
+     * @brief Same as @p elem.calc_pref_size(), without virtual dispatch if possible.
+     *
+     * @tparam E Dynamic type of @p elem.
+     ******************************************************************************/
+    template <typename E>
+    static Vec2
+    calc_pref_size(E& elem, Vec2 max_size);
+
+    /*******************************************************************************
+     * @brief Same as @p elem.draw(), without virtual dispatch if possible.
+     *
+     * @tparam E Dynamic type of @p elem.
+     ******************************************************************************/
+    template <typename E>
+    static void
+    draw(E& elem, DrawingWindow& window);
+
+private:
+    /*! Whether E is concrete, overrides do_*() itself and they are accessible. */
+    template <typename E>
+    static constexpr bool c_direct = requires(E& elem, Vec2 size, DrawingWindow& window) {
+        requires !std::is_abstract_v<E>;
+        requires std::is_same_v<decltype(&E::do_calc_pref_size), Vec2 (E::*)(Vec2)>;
+        requires std::is_same_v<decltype(&E::do_draw), void (E::*)(DrawingWindow&)>;
+        elem.E::do_calc_pref_size(size);
+        elem.E::do_draw(window);
+    };
+};
+
+template <typename E>
+Vec2
+ElementAccess::calc_pref_size(E& elem, Vec2 max_size) {
+    static_assert(std::is_base_of_v<Element, E>);
+    if constexpr (c_direct<E>) {
+        auto& base = static_cast<Element&>(elem);
+        if (!base.begin_calc_pref_size(max_size))
+            return base.m_last_pref_size;
+        return base.m_last_pref_size = elem.E::do_calc_pref_size(max_size);
+    } else {
+        return elem.calc_pref_size(max_size);
+    }
+}
+
+template <typename E>
+void
+ElementAccess::draw(E& elem, DrawingWindow& window) {
+    static_assert(std::is_base_of_v<Element, E>);
+    if constexpr (c_direct<E>) {
+        if (static_cast<Element&>(elem).begin_draw(window))
+            elem.E::do_draw(window);
+    } else {
+        elem.draw(window);
+    }
+}
+
+namespace detail {
+/*******************************************************************************
+ * @brief Stack elements along the @p Main axis, return the total size.
+ *
+ * Each element gets what remains along the main axis and the whole cross axis.
+ * Elements left without space are not measured, see Element::calc_pref_size().
+ ******************************************************************************/
+template <std::size_t Vec2::*Main, std::size_t Vec2::*Cross, typename... Elems>
+Vec2
+stack_pref_size(std::tuple<Elems...>& elems, Vec2 max_size) {
+    Vec2 size{};
+    const auto place = [&](auto& elem) {
+        auto limit{max_size};
+        limit.*Main -= size.*Main;
+        const auto elem_size = ElementAccess::calc_pref_size(elem, limit);
+        size.*Main += elem_size.*Main;
+        size.*Cross = std::max(size.*Cross, elem_size.*Cross);
+    };
+    std::apply([&](auto&... e) { (place(e), ...); }, elems);
+    return size;
+}
+
+/*******************************************************************************
+ * @brief Draw elements stacked along the @p Main axis.
+ *
+ * Each element is given its last preferred size along the main axis and the
+ * whole window along the cross axis.
+ ******************************************************************************/
+template <std::size_t Vec2::*Main, typename... Elems>
+void
+stack_draw(std::tuple<Elems...>& elems, DrawingWindow& window) {
+    Vec2 offset{};
+    const auto place = [&](auto& elem) {
+        auto size{window.size()};
+        size.*Main = elem.get_last_pref_size().*Main;
+        auto sub = window.sub_win(offset, size);
+        offset.*Main += size.*Main;
+        // Past the end of the window or off the screen.
+        if (sub.visible().empty())
+            return;
+        ElementAccess::draw(elem, sub);
+    };
+    std::apply([&](auto&... e) { (place(e), ...); }, elems);
+}
+} // namespace detail
+
+/*******************************************************************************
+ * @brief Elements placed left to right.
+ *
+ * Children are stored by value and their types are known statically, layout
+ * and drawing call them directly without virtual dispatch. Containers can be
+ * nested.
+ ******************************************************************************/
 template <typename... Elems>
 class HContainer : public Element {
-
 public:
+    /*******************************************************************************
+     * @brief New container with the passed children, in order.
+     ******************************************************************************/
     template <typename... Ts>
     explicit HContainer(Ts&&... elems);
 
+    /*******************************************************************************
+     * @brief Access the child at @p Idx.
+     ******************************************************************************/
+    template <std::size_t Idx>
+    auto&
+    get() noexcept;
+
 private:
+    friend class ElementAccess;
+
+    /*******************************************************************************
+     * @brief Children side by side.
+     *
+     * Each child is limited by the columns left by its predecessors.
+     *
+     * @return Sum of the columns, maximum of the rows.
+     ******************************************************************************/
     Vec2
     do_calc_pref_size(Vec2 max_size) override;
 
+    /*******************************************************************************
+     * @brief Draw children with their preferred widths and the full height.
+     ******************************************************************************/
     void
     do_draw(DrawingWindow& window) override;
 
@@ -130,34 +342,92 @@ template <typename... Elems>
 template <typename... Ts>
 HContainer<Elems...>::HContainer(Ts&&... elems) : m_elems{std::forward<Ts>(elems)...} {}
 
+template <typename... Elems>
+template <std::size_t Idx>
+auto&
+HContainer<Elems...>::get() noexcept {
+    return std::get<Idx>(m_elems);
+}
+
 template <typename... Elems>
 Vec2
 HContainer<Elems...>::do_calc_pref_size(Vec2 max_size) {
-    // Without alignment and flex.
-    // 	If we are flex, claim maximum but still calc them.
-
-    auto elems = std::apply([](auto&... v) { return std::array{static_cast<Element&>(v)...}; });
-
-    auto remaining{max_size};
-    for (std::size_t i = 0; i < elems.size(); ++i) {
-        remaining -= elems[i]->calc_pref_size(remaining);
-    };
-    return max_size - remaining;
+    return detail::stack_pref_size<&Vec2::m_col, &Vec2::m_row>(m_elems, max_size);
 }
 
 template <typename... Elems>
 void
 HContainer<Elems...>::do_draw(DrawingWindow& window) {
+    detail::stack_draw<&Vec2::m_col>(m_elems, window);
+}
 
-    // Sane iteration
-    auto elems = std::apply([](auto&... v) { return std::array{static_cast<Element&>(v)...}; });
-    for (std::size_t i = 0; i < elems.size(); ++i) {
-        // Restrict to its preferred size.
-        auto s = elems[i]->get_last_pref_size();
-        auto r = elems[i]->draw(window.sub_win(0, s));
-        // Shift right (because we are horizontal container, rows are fixed globally for us).
-        window = window.sub_win({.m_row = 0, .m_col = s.m_col});
-    };
+/*******************************************************************************
+ * @brief Elements placed top to bottom.
+ *
+ * Vertical counterpart of HContainer.
+ ******************************************************************************/
+template <typename... Elems>
+class VContainer : public Element {
+public:
+    /*******************************************************************************
+     * @brief New container with the passed children, in order.
+     ******************************************************************************/
+    template <typename... Ts>
+    explicit VContainer(Ts&&... elems);
+
+    /*******************************************************************************
+     * @brief Access the child at @p Idx.
+     ******************************************************************************/
+    template <std::size_t Idx>
+    auto&
+    get() noexcept;
+
+private:
+    friend class ElementAccess;
+
+    /*******************************************************************************
+     * @brief Children below each other.
+     *
+     * Each child is limited by the rows left by its predecessors.
+     *
+     * @return Sum of the rows, maximum of the columns.
+     ******************************************************************************/
+    Vec2
+    do_calc_pref_size(Vec2 max_size) override;
+
+    /*******************************************************************************
+     * @brief Draw children with their preferred heights and the full width.
+     ******************************************************************************/
+    void
+    do_draw(DrawingWindow& window) override;
+
+    std::tuple<Elems...> m_elems;
+};
+
+template <typename... Ts>
+VContainer(Ts...) -> VContainer<std::decay_t<Ts>...>;
+
+template <typename... Elems>
+template <typename... Ts>
+VContainer<Elems...>::VContainer(Ts&&... elems) : m_elems{std::forward<Ts>(elems)...} {}
+
+template <typename... Elems>
+template <std::size_t Idx>
+auto&
+VContainer<Elems...>::get() noexcept {
+    return std::get<Idx>(m_elems);
+}
+
+template <typename... Elems>
+Vec2
+VContainer<Elems...>::do_calc_pref_size(Vec2 max_size) {
+    return detail::stack_pref_size<&Vec2::m_row, &Vec2::m_col>(m_elems, max_size);
+}
+
+template <typename... Elems>
+void
+VContainer<Elems...>::do_draw(DrawingWindow& window) {
+    detail::stack_draw<&Vec2::m_row>(m_elems, window);
 }
 
 } // namespace eltau
@@ -0,0 +1,220 @@
+/*******************************************************************************
+ * @file event_loop.hpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <functional>
+#include <map>
+#include <string_view>
+
+namespace eltau {
+
+/*******************************************************************************
+ * @brief Single-threaded epoll loop dispatching terminal events.
+ *
+ * Waits for input, SIGWINCH, SIGTERM, timers and wake-ups from other threads
+ * at once and sleeps in between, nothing is polled. Rendering is driven by the
+ * events only: handlers and other threads request a redraw, which is done once
+ * after the current batch of events.
+ *
+ * SIGWINCH and SIGTERM are blocked in the constructing thread and read through
+ * a signalfd, the loop should be created before any other thread so that they
+ * inherit the mask. SIGTERM stops the loop.
+ ******************************************************************************/
+class EventLoop {
+public:
+    /*! Handler of an event without data. */
+    using Callback = std::function<void()>;
+    /*! Handler of the bytes read from the input. */
+    using InputHandler = std::function<void(std::string_view)>;
+    /*! Identifier of a timer. */
+    using TimerId = int;
+
+    /*******************************************************************************
+     * @brief New loop, registers its event sources.
+     *
+     * @param input_fd Input to watch, switched to non-blocking mode for the
+     * lifetime of the loop. Not watched if negative.
+     * @throw EltauException if a source cannot be created.
+     ******************************************************************************/
+    explicit EventLoop(int input_fd);
+
+    EventLoop(const EventLoop& other) = delete;
+    EventLoop(EventLoop&& other) noexcept = delete;
+    EventLoop&
+    operator=(const EventLoop& other) = delete;
+    EventLoop&
+    operator=(EventLoop&& other) noexcept = delete;
+
+    /*******************************************************************************
+     * @brief Close the sources, restore the signal mask and the input flags.
+     ******************************************************************************/
+    ~EventLoop() noexcept;
+
+    /*******************************************************************************
+     * @brief Set the handler of the input bytes, called as they arrive.
+     ******************************************************************************/
+    void
+    on_input(InputHandler handler);
+
+    /*******************************************************************************
+     * @brief Set the handler of terminal resizes.
+     ******************************************************************************/
+    void
+    on_resize(Callback handler);
+
+    /*******************************************************************************
+     * @brief Set the renderer, called after events that requested a redraw.
+     ******************************************************************************/
+    void
+    on_render(Callback handler);
+
+    /*******************************************************************************
+     * @brief Start a timer.
+     *
+     * @param delay Time until the first expiration, at least one nanosecond.
+     * @param interval Period of the following expirations, zero for a one-shot timer.
+     * @param handler Called on each expiration, expirations missed meanwhile are merged.
+     * @return Identifier valid until the timer is cancelled or a one-shot timer expires.
+     * @throw EltauException if the timer cannot be created.
+     ******************************************************************************/
+    TimerId
+    add_timer(std::chrono::nanoseconds delay, std::chrono::nanoseconds interval, Callback handler);
+
+    /*******************************************************************************
+     * @brief Stop the timer, unknown timers are ignored.
+     ******************************************************************************/
+    void
+    cancel_timer(TimerId id) noexcept;
+
+    /*******************************************************************************
+     * @brief Watch another descriptor, e.g. a timerfd of a scheduler.
+     *
+     * @param fd Descriptor owned by the caller, watched until remove_reader().
+     * @param handler Called whenever @p fd is readable, must consume the data.
+     * @throw EltauException if @p fd cannot be watched.
+     ******************************************************************************/
+    void
+    add_reader(int fd, Callback handler);
+
+    /*******************************************************************************
+     * @brief Stop watching @p fd, unknown descriptors are ignored.
+     *
+     * Its writer, if any, is removed as well.
+     ******************************************************************************/
+    void
+    remove_reader(int fd) noexcept;
+
+    /*******************************************************************************
+     * @brief Watch a reader's descriptor for writing too, e.g. for stalled output.
+     *
+     * @param fd Descriptor added by add_reader().
+     * @param handler Called whenever @p fd is writable, empty to stop watching.
+     * @throw EltauException if @p fd is not a reader or cannot be watched.
+     ******************************************************************************/
+    void
+    set_writer(int fd, Callback handler);
+
+    /*******************************************************************************
+     * @brief Render after the current batch of events, thread-safe.
+     ******************************************************************************/
+    void
+    request_redraw() noexcept;
+
+    /*******************************************************************************
+     * @brief Make run() return after the current batch of events, thread-safe.
+     ******************************************************************************/
+    void
+    stop() noexcept;
+
+    /*******************************************************************************
+     * @brief Whether the loop has been stopped.
+     ******************************************************************************/
+    bool
+    stopped() const noexcept;
+
+    /*******************************************************************************
+     * @brief Dispatch events until stopped.
+     ******************************************************************************/
+    void
+    run();
+
+    /*******************************************************************************
+     * @brief Wait for one batch of events and dispatch it.
+     *
+     * @param timeout Maximum time to wait, negative waits indefinitely.
+     * @return Number of dispatched events.
+     * @throw EltauException if waiting fails.
+     ******************************************************************************/
+    std::size_t
+    poll(std::chrono::milliseconds timeout);
+
+private:
+    /*******************************************************************************
+     * @brief Handler of a timer.
+     ******************************************************************************/
+    struct Timer {
+        Callback m_handler;
+        /*! Whether the timer is periodic. */
+        bool m_repeat = false;
+    };
+
+    /*******************************************************************************
+     * @brief Close all the sources and restore the process state.
+     ******************************************************************************/
+    void
+    release() noexcept;
+
+    /*******************************************************************************
+     * @brief Watch @p fd for reading.
+     ******************************************************************************/
+    void
+    watch(int fd) const;
+
+    /*******************************************************************************
+     * @brief Read all the available input.
+     ******************************************************************************/
+    void
+    read_input();
+
+    /*******************************************************************************
+     * @brief Read pending signals.
+     ******************************************************************************/
+    void
+    read_signals();
+
+    /*******************************************************************************
+     * @brief Acknowledge the timer and call its handler.
+     ******************************************************************************/
+    void
+    expire(int fd);
+
+    int m_epoll = -1;
+    int m_input = -1;
+    /*! Flags of m_input before the loop. */
+    int m_input_flags = 0;
+    int m_signals = -1;
+    int m_wakeup = -1;
+    /*! Signal mask before the loop. */
+    sigset_t m_old_mask{};
+
+    InputHandler m_on_input;
+    Callback m_on_resize;
+    Callback m_on_render;
+    /*! Timer handlers by their timerfd. */
+    std::map<int, Timer> m_timers;
+    /*! Handlers of the descriptors added by add_reader(). */
+    std::map<int, Callback> m_readers;
+    /*! Handlers of the readers also watched for writing, see set_writer(). */
+    std::map<int, Callback> m_writers;
+
+    std::atomic<bool> m_redraw{false};
+    std::atomic<bool> m_stopped{false};
+};
+
+} // namespace eltau
@@ -0,0 +1,192 @@
+/*******************************************************************************
+ * @file flat_tree.hpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+#include <eltau/element.hpp>
+#include <eltau/screen.hpp>
+
+namespace eltau {
+
+/*******************************************************************************
+ * @brief Element tree stored contiguously in pre-order.
+ *
+ * Alternative to nesting containers for large trees. Stacks and leaves are
+ * nodes of one vector, each node knows the end of its subtree, so children are
+ * found by skipping over subtrees instead of chasing pointers. Layout records
+ * live next to the nodes. Leaf elements are separate objects, emplace() creates
+ * them in the tree's resource to keep them close together too.
+ *
+ * Layout is one backward sweep computing preferred sizes bottom-up and one
+ * forward sweep placing the nodes top-down, subtrees placed outside of the
+ * visible part of the window are skipped as a whole. Unlike HContainer/VContainer, all
+ * leaves are measured against the whole tree's limits, not the space left by
+ * their siblings; children that do not fit are cut off. Top-level nodes are
+ * stacked vertically.
+ *
+ * The tree is built in pre-order:
+ * @code
+ * tree.open(FlatTree::Kind::HStack);
+ * tree.add(std::make_unique<ascii::Text>("a"));
+ * tree.add(std::make_unique<ascii::Text>("b"));
+ * tree.close();
+ * @endcode
+ ******************************************************************************/
+class FlatTree : public Element {
+public:
+    /*! Index of a node, in pre-order. */
+    using NodeId = std::uint32_t;
+
+    /*******************************************************************************
+     * @brief Type of a node.
+     ******************************************************************************/
+    enum class Kind : std::uint8_t {
+        /*! Element without children. */
+        Leaf,
+        /*! Children placed left to right. */
+        HStack,
+        /*! Children placed top to bottom. */
+        VStack,
+    };
+
+    /*******************************************************************************
+     * @brief New empty tree.
+     ******************************************************************************/
+    FlatTree() = default;
+
+    /*******************************************************************************
+     * @brief New empty tree keeping its nodes in @p alloc.
+     ******************************************************************************/
+    FlatTree(std::allocator_arg_t, std::pmr::polymorphic_allocator<> alloc);
+
+    /*******************************************************************************
+     * @brief Start a new stack, following nodes are its children until close().
+     *
+     * @param kind HStack or VStack.
+     * @throw EltauException if @p kind is not a stack.
+     ******************************************************************************/
+    NodeId
+    open(Kind kind);
+
+    /*******************************************************************************
+     * @brief Finish the innermost open stack.
+     *
+     * @throw EltauException if there is none.
+     ******************************************************************************/
+    void
+    close();
+
+    /*******************************************************************************
+     * @brief Add a leaf element to the innermost open stack.
+     *
+     * @param elem Owned element, must not be null.
+     * @throw EltauException if @p elem is null.
+     ******************************************************************************/
+    NodeId
+    add(std::unique_ptr<Element> elem);
+
+    /*******************************************************************************
+     * @brief Create a leaf element in the tree's storage and add it.
+     *
+     * The element comes from the same resource as the nodes, see make_element().
+     * With a pool or an arena, consecutive leaves then sit next to each other.
+     ******************************************************************************/
+    template <typename E, typename... Args>
+    NodeId
+    emplace(Args&&... args) {
+        return add(make_element<E>(m_nodes.get_allocator().resource(), std::forward<Args>(args)...));
+    }
+
+    /*******************************************************************************
+     * @brief Number of nodes.
+     ******************************************************************************/
+    std::size_t
+    size() const noexcept;
+
+    /*******************************************************************************
+     * @brief Element of the leaf @p id, null for stacks.
+     ******************************************************************************/
+    Element*
+    element(NodeId id) const noexcept;
+
+    /*******************************************************************************
+     * @brief Area assigned to the node @p id by the last draw().
+     *
+     * The root of a subtree culled by the last draw() keeps the area assigned by
+     * its parent, the nodes below it were not placed.
+     *
+     * @return Empty for nodes below a culled subtree root, or not placed at all.
+     ******************************************************************************/
+    Window
+    placement(NodeId id) const noexcept;
+
+private:
+    friend class ElementAccess;
+
+    /*******************************************************************************
+     * @brief Node together with its layout record.
+     ******************************************************************************/
+    struct Node {
+        /*! Element of a leaf, null for stacks. */
+        Element* m_elem = nullptr;
+        /*! One past the last node of the subtree. */
+        NodeId m_end = 0;
+        Kind m_kind = Kind::Leaf;
+        /*! Draw that placed the node last. */
+        std::uint32_t m_frame = 0;
+        /*! Preferred size, result of the backward sweep. */
+        Vec2 m_pref{};
+        /*! Assigned area, result of the forward sweep. */
+        Vec2 m_origin{};
+        Vec2 m_size{};
+    };
+
+    /*******************************************************************************
+     * @brief Backward sweep, computes preferred sizes of all the nodes.
+     *
+     * @return Preferred size of the roots stacked vertically.
+     * @throw EltauException if a stack is still open.
+     ******************************************************************************/
+    Vec2
+    do_calc_pref_size(Vec2 max_size) override;
+
+    /*******************************************************************************
+     * @brief Forward sweep placing the nodes, then draws the visible leaves.
+     ******************************************************************************/
+    void
+    do_draw(DrawingWindow& window) override;
+
+    /*******************************************************************************
+     * @brief Stacked size of sibling subtrees in [@p first, @p last).
+     ******************************************************************************/
+    Vec2
+    stack(NodeId first, NodeId last, Kind kind) const noexcept;
+
+    /*******************************************************************************
+     * @brief Assign areas to sibling subtrees in [@p first, @p last).
+     *
+     * @param origin Top-left corner of the area of the whole stack.
+     * @param size Size of the area of the whole stack.
+     ******************************************************************************/
+    void
+    place(NodeId first, NodeId last, Kind kind, Vec2 origin, Vec2 size) noexcept;
+
+    /*! All nodes, in pre-order. */
+    std::pmr::vector<Node> m_nodes;
+    /*! Currently open stacks, innermost last. */
+    std::pmr::vector<NodeId> m_open;
+    /*! Elements of the leaves. */
+    std::pmr::vector<std::unique_ptr<Element>> m_elems;
+    /*! Number of draws, stamps the placed nodes. */
+    std::uint32_t m_frame = 0;
+};
+
+} // namespace eltau
@@ -0,0 +1,228 @@
+/*******************************************************************************
+ * @file flex.hpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+#include <eltau/element.hpp>
+#include <eltau/screen.hpp>
+
+namespace eltau {
+
+/*******************************************************************************
+ * @brief Placement of an element within a larger area.
+ ******************************************************************************/
+enum class Align : std::uint8_t {
+    /*! Top or left. */
+    Start,
+    Center,
+    /*! Bottom or right. */
+    End,
+    /*! Fill the whole area. */
+    Stretch,
+};
+
+/*******************************************************************************
+ * @brief Flex properties of one child along the main axis of its container.
+ ******************************************************************************/
+struct FlexItem {
+    /*! Share of the free space, zero keeps the preferred size. */
+    std::size_t m_weight = 0;
+    /*! Never shrunk below. */
+    std::size_t m_min = 0;
+    /*! Never grown above, wins over m_min. */
+    std::size_t m_max = std::numeric_limits<std::size_t>::max();
+    /*! Placement along the cross axis. */
+    Align m_align = Align::Start;
+
+    bool
+    operator==(const FlexItem&) const noexcept = default;
+};
+
+/*******************************************************************************
+ * @brief Distributes space along one axis among flex items.
+ *
+ * Each item starts at its preferred size clamped to its limits. Free space is
+ * then split among the weighted items proportionally to their weights, missing
+ * space is taken from them the same way, down to their minimum. Items reaching
+ * a limit drop out and the rest is redistributed, each pass is O(items).
+ *
+ * The last solution is cached and returned as long as the inputs are the same.
+ ******************************************************************************/
+class FlexSolver {
+public:
+    /*******************************************************************************
+     * @brief New solver without a solution.
+     ******************************************************************************/
+    FlexSolver() = default;
+
+    /*******************************************************************************
+     * @brief New solver keeping its solution in @p alloc.
+     ******************************************************************************/
+    explicit FlexSolver(std::pmr::polymorphic_allocator<> alloc);
+
+    /*******************************************************************************
+     * @brief Sizes of the items along the axis.
+     *
+     * @param available Space to distribute.
+     * @param items Flex properties, same items as in the previous call unless
+     * invalidate() has been called.
+     * @param prefs Preferred sizes of the items.
+     * @return One size per item, valid until the next call. Their sum can exceed
+     * @p available if the minimums do not fit.
+     ******************************************************************************/
+    std::span<const std::size_t>
+    solve(std::size_t available, std::span<const FlexItem> items, std::span<const std::size_t> prefs);
+
+    /*******************************************************************************
+     * @brief Forget the cached solution, must be called if the items change.
+     ******************************************************************************/
+    void
+    invalidate() noexcept;
+
+    /*******************************************************************************
+     * @brief Number of solutions computed, cached ones are not counted.
+     ******************************************************************************/
+    std::size_t
+    solve_count() const noexcept;
+
+private:
+    /*******************************************************************************
+     * @brief Grow (@p grow) or shrink the weighted items by up to @p amount.
+     ******************************************************************************/
+    void
+    distribute(std::span<const FlexItem> items, std::size_t amount, bool grow) noexcept;
+
+    /*! Inputs of the cached solution. */
+    std::size_t m_available = 0;
+    std::pmr::vector<std::size_t> m_prefs;
+    /*! Cached solution. */
+    std::pmr::vector<std::size_t> m_sizes;
+    bool m_valid = false;
+    std::size_t m_solve_count = 0;
+};
+
+/*******************************************************************************
+ * @brief Direction of the main axis.
+ ******************************************************************************/
+enum class Direction : std::uint8_t {
+    /*! Left to right. */
+    Horizontal,
+    /*! Top to bottom. */
+    Vertical,
+};
+
+/*******************************************************************************
+ * @brief Container distributing its space among children by weights.
+ *
+ * Children are measured against the whole container. Once the container is
+ * drawn, they are sized along the main axis by FlexSolver and aligned along the
+ * cross axis according to their FlexItem. The solution is reused until the
+ * container size or a preferred size of a child changes, so nested flex panes
+ * re-solve only what changed.
+ ******************************************************************************/
+class FlexContainer : public Element {
+public:
+    /*******************************************************************************
+     * @brief New empty container.
+     *
+     * @param direction Main axis.
+     * @param justify Placement of the children along the main axis if they do not
+     * fill it. Align::Stretch behaves as Align::Start.
+     ******************************************************************************/
+    explicit FlexContainer(Direction direction, Align justify = Align::Start) noexcept;
+
+    /*******************************************************************************
+     * @brief Same as FlexContainer(Direction, Align), keeps its children in @p alloc.
+     ******************************************************************************/
+    FlexContainer(std::allocator_arg_t, std::pmr::polymorphic_allocator<> alloc, Direction direction,
+                  Align justify = Align::Start);
+
+    /*******************************************************************************
+     * @brief Append a child.
+     *
+     * @param elem Owned element, must not be null.
+     * @param item Flex properties of the child.
+     * @return Index of the child.
+     * @throw EltauException if @p elem is null.
+     ******************************************************************************/
+    std::size_t
+    add(std::unique_ptr<Element> elem, FlexItem item = {});
+
+    /*******************************************************************************
+     * @brief Change flex properties of the child at @p idx.
+     *
+     * @throw EltauException if @p idx is out of range.
+     ******************************************************************************/
+    void
+    set_item(std::size_t idx, FlexItem item);
+
+    /*******************************************************************************
+     * @brief Number of children.
+     ******************************************************************************/
+    std::size_t
+    size() const noexcept;
+
+    /*******************************************************************************
+     * @brief Child at @p idx, null if out of range.
+     ******************************************************************************/
+    Element*
+    child(std::size_t idx) const noexcept;
+
+    /*******************************************************************************
+     * @brief Solver of the main axis, for statistics.
+     ******************************************************************************/
+    const FlexSolver&
+    solver() const noexcept;
+
+private:
+    friend class ElementAccess;
+
+    /*******************************************************************************
+     * @brief Measure children.
+     *
+     * @return Sum of the preferred sizes clamped to the limits, free space is
+     * distributed only once the actual size is known. Largest child along the
+     * cross axis.
+     ******************************************************************************/
+    Vec2
+    do_calc_pref_size(Vec2 max_size) override;
+
+    /*******************************************************************************
+     * @brief Solve the main axis for the window and draw children into their areas.
+     *
+     * The solution is cached, see FlexSolver.
+     ******************************************************************************/
+    void
+    do_draw(DrawingWindow& window) override;
+
+    /*******************************************************************************
+     * @brief Size along the main axis.
+     ******************************************************************************/
+    std::size_t&
+    main(Vec2& v) const noexcept;
+
+    /*******************************************************************************
+     * @brief Size along the cross axis.
+     ******************************************************************************/
+    std::size_t&
+    cross(Vec2& v) const noexcept;
+
+    Direction m_direction;
+    Align m_justify;
+    std::pmr::vector<std::unique_ptr<Element>> m_children;
+    std::pmr::vector<FlexItem> m_items;
+    /*! Preferred sizes of children along the main axis, from the last measurement. */
+    std::pmr::vector<std::size_t> m_prefs;
+    FlexSolver m_solver;
+};
+
+} // namespace eltau
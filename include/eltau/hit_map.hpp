@@ -0,0 +1,69 @@
+/*******************************************************************************
+ * @file hit_map.hpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+#pragma once
+
+#include <memory_resource>
+#include <vector>
+
+#include <eltau/screen.hpp>
+
+namespace eltau {
+
+class Element;
+
+/*******************************************************************************
+ * @brief Per-cell plane of the elements drawn there, for mouse hit-testing.
+ *
+ * Filled by the draw pass when passed to DrawingWindow: every drawn element
+ * marks its visible window before its children, so each cell ends up with the
+ * inner-most element covering it. Lookups are O(1), only the redrawn parts are
+ * updated.
+ ******************************************************************************/
+class HitMap {
+public:
+    /*******************************************************************************
+     * @brief New map without any elements.
+     *
+     * @param size Size of the mapped screen.
+     * @param resource Memory of the cells.
+     ******************************************************************************/
+    explicit HitMap(Vec2 size, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    /*******************************************************************************
+     * @brief Size of the mapped screen.
+     ******************************************************************************/
+    Vec2
+    size() const noexcept;
+
+    /*******************************************************************************
+     * @brief Change the size, all cells are cleared.
+     ******************************************************************************/
+    void
+    resize(Vec2 size);
+
+    /*******************************************************************************
+     * @brief Assign @p elem to all cells of @p rect, clipped by the map.
+     *
+     * @param elem Null clears the cells.
+     ******************************************************************************/
+    void
+    mark(const Window& rect, Element* elem) noexcept;
+
+    /*******************************************************************************
+     * @brief Element drawn at @p pos.
+     *
+     * @return Null outside of the map or if no element has been drawn there.
+     ******************************************************************************/
+    Element*
+    at(Vec2 pos) const noexcept;
+
+private:
+    Vec2 m_size;
+    /*! Row-major, same as Screen. */
+    std::pmr::vector<Element*> m_cells;
+};
+
+} // namespace eltau
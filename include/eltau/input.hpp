@@ -0,0 +1,254 @@
+/*******************************************************************************
+ * @file input.hpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include <eltau/screen.hpp>
+
+namespace eltau {
+
+/*******************************************************************************
+ * @brief Key of an InputEvent.
+ ******************************************************************************/
+enum class Key : std::uint8_t {
+    /*! Unknown or no key. */
+    None = 0,
+    /*! Printable character in InputEvent::m_char. */
+    Char,
+    Enter,
+    Tab,
+    Backspace,
+    Escape,
+    Up,
+    Down,
+    Right,
+    Left,
+    Home,
+    End,
+    Insert,
+    Delete,
+    PageUp,
+    PageDown,
+    F1,
+    F2,
+    F3,
+    F4,
+    F5,
+    F6,
+    F7,
+    F8,
+    F9,
+    F10,
+    F11,
+    F12,
+};
+
+/*******************************************************************************
+ * @brief Modifiers held during a key or mouse event.
+ ******************************************************************************/
+enum Modifier : std::uint8_t {
+    Shift = 1 << 0,
+    Alt = 1 << 1,
+    Ctrl = 1 << 2,
+};
+
+/*******************************************************************************
+ * @brief Button of a mouse event.
+ ******************************************************************************/
+enum class MouseButton : std::uint8_t {
+    None = 0,
+    Left,
+    Middle,
+    Right,
+    WheelUp,
+    WheelDown,
+};
+
+/*******************************************************************************
+ * @brief One decoded input event.
+ ******************************************************************************/
+struct InputEvent {
+    enum class Type : std::uint8_t {
+        Key,
+        MousePress,
+        MouseRelease,
+        MouseMove,
+        /*! Part of a bracketed paste, one paste may be split into many. */
+        Paste,
+        /*! End of a bracketed paste. */
+        PasteEnd,
+    };
+
+    Type m_type = Type::Key;
+    Key m_key = Key::None;
+    /*! Combination of Modifier flags. */
+    std::uint8_t m_mods = 0;
+    /*! Code point of Key::Char, lower-case letter of Ctrl+letter. */
+    char32_t m_char = 0;
+    MouseButton m_button = MouseButton::None;
+    /*! Zero-based position of a mouse event. */
+    Vec2 m_pos{};
+    /*! Pasted bytes, points into the decoded input. */
+    std::string_view m_text{};
+
+    bool
+    operator==(const InputEvent&) const noexcept = default;
+};
+
+/*******************************************************************************
+ * @brief Incremental decoder of raw terminal input.
+ *
+ * Table-driven state machine decoding keys, CSI/SS3 sequences with modifiers,
+ * SGR mouse reports and bracketed paste byte by byte. The state survives
+ * between feed() calls, so sequences may be split across reads arbitrarily.
+ * Nothing is allocated, decoded events go into a fixed-size queue.
+ *
+ * Pasted text is not copied, Paste events point into the fed bytes, whole runs
+ * without an escape character at once.
+ *
+ * A lone ESC is ambiguous with a start of a sequence, it becomes Key::Escape
+ * when followed by another ESC or when expire() is called after the timeout.
+ ******************************************************************************/
+class InputDecoder {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /*! Capacity of the event queue. */
+    inline constexpr static std::size_t c_queue_size = 64;
+    /*! Default time a lone ESC waits for the rest of a sequence. */
+    inline constexpr static std::chrono::milliseconds c_default_escape_timeout{25};
+
+    /*******************************************************************************
+     * @brief New decoder in the ground state.
+     *
+     * @param escape_timeout Time after which a lone ESC is a key.
+     ******************************************************************************/
+    explicit InputDecoder(std::chrono::milliseconds escape_timeout = c_default_escape_timeout) noexcept;
+
+    /*******************************************************************************
+     * @brief Decode @p bytes into the queue.
+     *
+     * Stops when the queue is full, the rest must be fed again after popping.
+     * Paste events point into @p bytes, they must be popped before it changes.
+     *
+     * @param bytes Input read from the terminal.
+     * @param now Arrival time of @p bytes, for the ESC timeout.
+     * @return Number of consumed bytes.
+     ******************************************************************************/
+    std::size_t
+    feed(std::string_view bytes, Clock::time_point now = Clock::now()) noexcept;
+
+    /*******************************************************************************
+     * @brief Resolve a lone ESC if its timeout has passed at @p now.
+     *
+     * @return Whether an Escape event was queued.
+     ******************************************************************************/
+    bool
+    expire(Clock::time_point now = Clock::now()) noexcept;
+
+    /*******************************************************************************
+     * @brief When expire() should be called, if at all.
+     ******************************************************************************/
+    std::optional<Clock::time_point>
+    deadline() const noexcept;
+
+    /*******************************************************************************
+     * @brief Take the oldest decoded event.
+     ******************************************************************************/
+    std::optional<InputEvent>
+    pop() noexcept;
+
+    /*******************************************************************************
+     * @brief Number of queued events.
+     ******************************************************************************/
+    std::size_t
+    size() const noexcept;
+
+private:
+    enum class State : std::uint8_t {
+        Ground,
+        /*! Inside a multi-byte UTF-8 character. */
+        Utf8,
+        /*! After ESC. */
+        Escape,
+        /*! After ESC [, collecting parameters. */
+        Csi,
+        /*! After ESC O. */
+        Ss3,
+        Paste,
+    };
+
+    /*! Maximum number of CSI parameters. */
+    inline constexpr static std::size_t c_max_params = 4;
+
+    /*******************************************************************************
+     * @brief Decode one byte in the ground state.
+     ******************************************************************************/
+    void
+    ground(char byte, std::uint8_t mods) noexcept;
+
+    /*******************************************************************************
+     * @brief Dispatch a complete CSI sequence ending with @p final.
+     ******************************************************************************/
+    void
+    csi(char final) noexcept;
+
+    /*******************************************************************************
+     * @brief Queue an SGR mouse report.
+     ******************************************************************************/
+    void
+    mouse(bool release) noexcept;
+
+    /*******************************************************************************
+     * @brief Consume pasted bytes from @p bytes at @p pos.
+     ******************************************************************************/
+    void
+    paste(std::string_view bytes, std::size_t& pos) noexcept;
+
+    /*******************************************************************************
+     * @brief Queue a key event.
+     ******************************************************************************/
+    void
+    push_key(Key key, std::uint8_t mods, char32_t chr = 0) noexcept;
+
+    /*******************************************************************************
+     * @brief Queue @p event, the queue must not be full.
+     ******************************************************************************/
+    void
+    push(const InputEvent& event) noexcept;
+
+    std::chrono::milliseconds m_escape_timeout;
+    State m_state = State::Ground;
+    /*! Arrival of the pending ESC. */
+    Clock::time_point m_escape_time{};
+
+    /*! Partial UTF-8 character. */
+    std::array<char, 4> m_utf8{};
+    std::uint8_t m_utf8_len = 0;
+    std::uint8_t m_utf8_need = 0;
+
+    /*! Parameters of the current CSI sequence. */
+    std::array<std::uint32_t, c_max_params> m_params{};
+    std::uint8_t m_param_count = 0;
+    /*! Whether the rest of the current parameter is a ':' sub-parameter, ignored. */
+    bool m_sub_param = false;
+    /*! Private marker of the current CSI sequence, e.g. '<' of SGR mouse. */
+    char m_marker = 0;
+    /*! Number of matched bytes of the paste terminator. */
+    std::uint8_t m_paste_match = 0;
+
+    /*! Ring buffer of decoded events. */
+    std::array<InputEvent, c_queue_size> m_queue{};
+    std::size_t m_head = 0;
+    std::size_t m_count = 0;
+};
+
+} // namespace eltau
@@ -0,0 +1,256 @@
+/*******************************************************************************
+ * @file line_index.hpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+
+#include <eltau/screen.hpp>
+
+namespace eltau::ascii {
+
+/*******************************************************************************
+ * @brief Line-break index of an ASCII text.
+ *
+ * Paragraphs (newline-separated parts) of the text are indexed once per content
+ * change. Wrapped lines are derived from them lazily and cached for the last used
+ * wrap limit, so repeated size queries are O(1) and any wrapped line can be
+ * accessed directly.
+ *
+ * The index does not keep the text, only offsets into it. Its storage comes from
+ * the passed allocator and is reused by rebuild().
+ ******************************************************************************/
+class LineIndex {
+public:
+    /*******************************************************************************
+     * @brief Part of the indexed text.
+     ******************************************************************************/
+    struct Segment {
+        /*! Offset of the first character. */
+        std::size_t m_begin = 0;
+        /*! Number of characters, excluding the newline. */
+        std::size_t m_length = 0;
+
+        bool
+        operator==(const Segment&) const noexcept = default;
+    };
+
+    /*******************************************************************************
+     * @brief Index of an empty text.
+     ******************************************************************************/
+    LineIndex() = default;
+
+    /*******************************************************************************
+     * @brief Index of an empty text, storing the index in @p alloc.
+     ******************************************************************************/
+    explicit LineIndex(std::pmr::polymorphic_allocator<> alloc) noexcept;
+
+    /*******************************************************************************
+     * @brief Index the passed text.
+     ******************************************************************************/
+    explicit LineIndex(std::string_view text);
+
+    /*******************************************************************************
+     * @brief Re-index after the content has changed.
+     *
+     * Invalidates the cached layout.
+     ******************************************************************************/
+    void
+    rebuild(std::string_view text);
+
+    /*******************************************************************************
+     * @brief Update the index after a part of the text has been replaced.
+     *
+     * Only the paragraphs touching the edited range are re-indexed and, if cached,
+     * re-wrapped. The rest is shifted. The result is the same as rebuild(@p text).
+     *
+     * Appending costs O(appended text), other edits additionally O(paragraphs and
+     * lines after the edit).
+     *
+     * @param text The whole text after the edit.
+     * @param pos Offset of the edit.
+     * @param removed Number of characters removed from the original text at @p pos.
+     * @param inserted Number of characters inserted into @p text at @p pos.
+     ******************************************************************************/
+    void
+    update(std::string_view text, std::size_t pos, std::size_t removed, std::size_t inserted);
+
+    /*******************************************************************************
+     * @brief Number of newline-separated paragraphs.
+     ******************************************************************************/
+    std::size_t
+    paragraph_count() const noexcept;
+
+    /*******************************************************************************
+     * @brief Access the paragraph at @p idx.
+     *
+     * @return Empty segment if @p idx is out of range.
+     ******************************************************************************/
+    Segment
+    paragraph(std::size_t idx) const noexcept;
+
+    /*******************************************************************************
+     * @brief Size of the text wrapped at @p wrap_limit characters.
+     *
+     * A newline always starts a new line, a line longer than @p wrap_limit
+     * continues on the next one. Zero limit is treated as one.
+     ******************************************************************************/
+    Vec2
+    size(std::size_t wrap_limit);
+
+    /*******************************************************************************
+     * @brief Wrapped line at @p row.
+     *
+     * @param row Line index, valid range given by size().
+     * @param wrap_limit Same meaning as in size().
+     * @return Empty segment if @p row is out of range.
+     ******************************************************************************/
+    Segment
+    line(std::size_t row, std::size_t wrap_limit);
+
+private:
+    /*******************************************************************************
+     * @brief Split @p text into paragraphs, appended to @p out.
+     *
+     * @param offset Offset of @p text in the indexed text.
+     ******************************************************************************/
+    static void
+    split(std::string_view text, std::size_t offset, std::pmr::vector<Segment>& out);
+
+    /*******************************************************************************
+     * @brief Append wrapped lines of paragraphs [@p first, @p last) to @p out.
+     ******************************************************************************/
+    void
+    wrap(std::size_t first, std::size_t last, std::pmr::vector<Segment>& out) const;
+
+    /*******************************************************************************
+     * @brief (Re)compute wrapped lines if the limit changed.
+     ******************************************************************************/
+    void
+    layout(std::size_t wrap_limit);
+
+    /*! Newline-separated paragraphs, in order. */
+    std::pmr::vector<Segment> m_paragraphs;
+    /*! Length of the longest paragraph. */
+    std::size_t m_max_length = 0;
+
+    /*! Wrap limit of the cached layout, zero means no layout. */
+    std::size_t m_limit = 0;
+    /*! Size of the cached layout. */
+    Vec2 m_size;
+    /*! Wrapped lines, empty if no paragraph is wrapped - m_paragraphs are used instead. */
+    std::pmr::vector<Segment> m_lines;
+};
+
+} // namespace eltau::ascii
+
+namespace eltau::utf8 {
+
+/*******************************************************************************
+ * @brief Line-break index of an UTF-8 text.
+ *
+ * Same as ascii::LineIndex but wraps on grapheme boundaries based on their
+ * display width. Pure-ASCII paragraphs are wrapped arithmetically.
+ *
+ * The index keeps a view of the text, it must be rebuilt if the text changes.
+ ******************************************************************************/
+class LineIndex {
+public:
+    /*******************************************************************************
+     * @brief Part of the indexed text.
+     ******************************************************************************/
+    struct Segment {
+        /*! Offset of the first byte. */
+        std::size_t m_begin = 0;
+        /*! Number of bytes, excluding the newline. */
+        std::size_t m_length = 0;
+        /*! Display width. */
+        std::size_t m_width = 0;
+
+        bool
+        operator==(const Segment&) const noexcept = default;
+    };
+
+    /*******************************************************************************
+     * @brief Index of an empty text.
+     ******************************************************************************/
+    LineIndex() = default;
+
+    /*******************************************************************************
+     * @brief Index the passed text, see rebuild().
+     ******************************************************************************/
+    explicit LineIndex(std::string_view text);
+
+    /*******************************************************************************
+     * @brief Re-index after the content has changed.
+     *
+     * @param text UTF-8 text, must outlive the index or the next rebuild().
+     ******************************************************************************/
+    void
+    rebuild(std::string_view text);
+
+    /*******************************************************************************
+     * @brief Number of newline-separated paragraphs.
+     ******************************************************************************/
+    std::size_t
+    paragraph_count() const noexcept;
+
+    /*******************************************************************************
+     * @brief Access the paragraph at @p idx.
+     *
+     * @return Empty segment if @p idx is out of range.
+     ******************************************************************************/
+    Segment
+    paragraph(std::size_t idx) const noexcept;
+
+    /*******************************************************************************
+     * @brief Size of the text wrapped at @p wrap_limit cells.
+     *
+     * A grapheme is never split, a line always holds at least one. Zero limit is
+     * treated as one.
+     ******************************************************************************/
+    Vec2
+    size(std::size_t wrap_limit);
+
+    /*******************************************************************************
+     * @brief Wrapped line at @p row.
+     *
+     * @return Empty segment if @p row is out of range.
+     ******************************************************************************/
+    Segment
+    line(std::size_t row, std::size_t wrap_limit);
+
+private:
+    /*******************************************************************************
+     * @brief Wrap one paragraph into m_lines.
+     ******************************************************************************/
+    void
+    wrap(const Segment& paragraph, std::size_t limit);
+
+    /*******************************************************************************
+     * @brief Normalize the limit and (re)compute wrapped lines if it changed.
+     ******************************************************************************/
+    void
+    layout(std::size_t wrap_limit);
+
+    /*! Indexed text. */
+    std::string_view m_text;
+    /*! Newline-separated paragraphs, in order. */
+    std::vector<Segment> m_paragraphs;
+    /*! Width of the widest paragraph. */
+    std::size_t m_max_width = 0;
+
+    /*! Effective wrap limit of the cached layout, zero means no layout. */
+    std::size_t m_limit = 0;
+    /*! Size of the cached layout. */
+    Vec2 m_size;
+    /*! Wrapped lines, empty if no paragraph is wrapped - m_paragraphs are used instead. */
+    std::vector<Segment> m_lines;
+};
+
+} // namespace eltau::utf8
@@ -0,0 +1,162 @@
+/*******************************************************************************
+ * @file log_view.hpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <eltau/element.hpp>
+#include <eltau/screen.hpp>
+
+namespace eltau {
+
+/*******************************************************************************
+ * @brief Read-only view of a possibly huge ASCII file, one line per row.
+ *
+ * The file is memory-mapped, never read as a whole. Its lines are indexed by a
+ * background thread, the view is usable right away and shows what has been
+ * indexed so far. Once the whole file is indexed, the thread keeps polling it
+ * and indexes anything appended.
+ *
+ * Only the visible lines are touched when drawn, they are escaped as in
+ * ascii::Text and cut off at the window width.
+ *
+ * The file must not be truncated while viewed.
+ ******************************************************************************/
+class LogView : public Element {
+public:
+    /*! Default period of checking the file for appended data. */
+    inline constexpr static std::chrono::milliseconds c_default_poll{100};
+
+    /*******************************************************************************
+     * @brief Open the file and start indexing it.
+     *
+     * @param path File to view.
+     * @param poll Period of checking the file for appended data.
+     * @throw EltauException if the file cannot be opened or mapped.
+     ******************************************************************************/
+    explicit LogView(const std::string& path, std::chrono::milliseconds poll = c_default_poll);
+
+    LogView(const LogView& other) = delete;
+    LogView(LogView&& other) noexcept = delete;
+    LogView&
+    operator=(const LogView& other) = delete;
+    LogView&
+    operator=(LogView&& other) noexcept = delete;
+
+    /*******************************************************************************
+     * @brief Stop indexing and close the file.
+     ******************************************************************************/
+    ~LogView() noexcept override;
+
+    /*******************************************************************************
+     * @brief Number of lines indexed so far.
+     *
+     * Unterminated last line is counted, an empty one after the last newline is not.
+     ******************************************************************************/
+    std::size_t
+    line_count() const;
+
+    /*******************************************************************************
+     * @brief Number of bytes indexed so far.
+     ******************************************************************************/
+    std::size_t
+    indexed_bytes() const;
+
+    /*******************************************************************************
+     * @brief Copy of the indexed line at @p idx, without the newline.
+     *
+     * @return Empty if @p idx is out of range.
+     ******************************************************************************/
+    std::string
+    line(std::size_t idx) const;
+
+    /*******************************************************************************
+     * @brief Show the line @p idx at the top.
+     *
+     * Clamped when drawn so that the view is filled if possible.
+     ******************************************************************************/
+    void
+    scroll_to(std::size_t idx) noexcept;
+
+    /*******************************************************************************
+     * @brief Current scroll offset, in lines.
+     ******************************************************************************/
+    std::size_t
+    offset() const noexcept;
+
+    /*******************************************************************************
+     * @brief Whether to keep showing the last lines as the file grows.
+     ******************************************************************************/
+    void
+    set_follow(bool follow) noexcept;
+
+private:
+    friend class ElementAccess;
+
+    /*! Read-only mapping of a file prefix. */
+    class Mapping;
+
+    /*******************************************************************************
+     * @brief Indexed lines, limited, and all the offered columns.
+     ******************************************************************************/
+    Vec2
+    do_calc_pref_size(Vec2 max_size) override;
+
+    /*******************************************************************************
+     * @brief Draw the visible lines straight from the mapping.
+     ******************************************************************************/
+    void
+    do_draw(DrawingWindow& window) override;
+
+    /*******************************************************************************
+     * @brief Background indexing, runs until @p stop is requested.
+     ******************************************************************************/
+    void
+    index(const std::stop_token& stop);
+
+    /*******************************************************************************
+     * @brief Map the current file size if it grew.
+     *
+     * @return New mapping or null if the size is the same or mapping failed.
+     ******************************************************************************/
+    std::shared_ptr<const Mapping>
+    remap(std::size_t mapped) const;
+
+    /*******************************************************************************
+     * @brief Same as line_count(), m_mutex must be held.
+     ******************************************************************************/
+    std::size_t
+    locked_line_count() const noexcept;
+
+    int m_fd;
+    std::chrono::milliseconds m_poll;
+
+    /*! Guards m_map, m_starts and m_indexed. */
+    mutable std::mutex m_mutex;
+    std::condition_variable_any m_cv;
+    /*! Latest mapping, kept alive by readers while in use. */
+    std::shared_ptr<const Mapping> m_map;
+    /*! Offsets of the indexed lines. */
+    std::vector<std::size_t> m_starts{0};
+    /*! Number of indexed bytes. */
+    std::size_t m_indexed = 0;
+
+    std::size_t m_offset = 0;
+    bool m_follow = false;
+
+    /*! Indexing thread, started last and stopped first. */
+    std::jthread m_indexer;
+};
+
+} // namespace eltau
@@ -0,0 +1,125 @@
+/*******************************************************************************
+ * @file memory.hpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <optional>
+
+namespace eltau {
+
+/*******************************************************************************
+ * @brief Memory resource counting what passes through it to another one.
+ *
+ * Not thread-safe, same as std::pmr::unsynchronized_pool_resource.
+ ******************************************************************************/
+class CountingResource : public std::pmr::memory_resource {
+public:
+    /*******************************************************************************
+     * @brief Count allocations served by @p upstream.
+     *
+     * @param upstream Must outlive this resource.
+     ******************************************************************************/
+    explicit CountingResource(std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) noexcept;
+
+    /*******************************************************************************
+     * @brief Number of allocations in total.
+     ******************************************************************************/
+    std::size_t
+    allocations() const noexcept;
+
+    /*******************************************************************************
+     * @brief Number of bytes currently allocated.
+     ******************************************************************************/
+    std::size_t
+    bytes() const noexcept;
+
+private:
+    void*
+    do_allocate(std::size_t bytes, std::size_t alignment) override;
+
+    void
+    do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override;
+
+    bool
+    do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    std::pmr::memory_resource* m_upstream;
+    std::size_t m_allocations = 0;
+    std::size_t m_bytes = 0;
+};
+
+/*******************************************************************************
+ * @brief Monotonic arena for temporaries of one frame.
+ *
+ * Allocation is a pointer bump, deallocation is a no-op and everything is
+ * released at once by reset(). The arena owns one buffer, a frame that does not
+ * fit takes more memory from the upstream resource and the buffer grows at the
+ * next reset() to fit such frames. Repeated frames of the same shape therefore
+ * stop touching the upstream resource after the first one.
+ *
+ * Pass resource() to DrawingWindow, elements take their scratch memory from it.
+ * Compositor does so for every layer it draws.
+ ******************************************************************************/
+class FrameArena {
+public:
+    /*! Default size of the initial buffer. */
+    inline constexpr static std::size_t c_default_bytes = std::size_t{1} << 16U;
+
+    /*******************************************************************************
+     * @brief New arena.
+     *
+     * @param initial_bytes Size of the initial buffer, at least one.
+     * @param upstream Source of the buffers, must outlive the arena.
+     ******************************************************************************/
+    explicit FrameArena(std::size_t initial_bytes = c_default_bytes,
+                        std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+
+    FrameArena(const FrameArena& other) = delete;
+    FrameArena(FrameArena&& other) noexcept = delete;
+    FrameArena&
+    operator=(const FrameArena& other) = delete;
+    FrameArena&
+    operator=(FrameArena&& other) noexcept = delete;
+
+    /*******************************************************************************
+     * @brief Release the buffers.
+     ******************************************************************************/
+    ~FrameArena() noexcept;
+
+    /*******************************************************************************
+     * @brief Resource allocating from the arena, valid until the next reset().
+     ******************************************************************************/
+    std::pmr::memory_resource*
+    resource() noexcept;
+
+    /*******************************************************************************
+     * @brief Release everything allocated since the last reset.
+     *
+     * Grows the buffer if the frame did not fit into it. Nothing allocated from
+     * the arena may be used afterwards.
+     ******************************************************************************/
+    void
+    reset();
+
+    /*******************************************************************************
+     * @brief Size of the owned buffer.
+     ******************************************************************************/
+    std::size_t
+    capacity() const noexcept;
+
+private:
+    /*! Source of the owned buffer. */
+    std::pmr::memory_resource* m_upstream;
+    std::size_t m_capacity;
+    void* m_buffer;
+    /*! Counts buffers allocated beyond the owned one. */
+    CountingResource m_overflow;
+    std::optional<std::pmr::monotonic_buffer_resource> m_arena;
+};
+
+} // namespace eltau
@@ -0,0 +1,266 @@
+/*******************************************************************************
+ * @file metrics.hpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include <eltau/element.hpp>
+#include <eltau/screen.hpp>
+
+namespace eltau {
+
+/*! Assumed size of a cache line, shared atomics are padded to it. */
+inline constexpr std::size_t c_cache_line = 64;
+
+namespace detail {
+/*******************************************************************************
+ * @brief Shard of the calling thread, assigned round-robin on first use.
+ ******************************************************************************/
+std::size_t
+shard_index() noexcept;
+} // namespace detail
+
+/*******************************************************************************
+ * @brief Counter incremented by many threads and read once per frame.
+ *
+ * Split into shards padded to cache lines, each thread adds to its own shard
+ * with one relaxed atomic operation. Workers share a cache line only if there
+ * are more of them than shards, the cost of add() does not depend on readers.
+ * There are enough shards for a worker per core on common machines, at the
+ * price of 4 KiB per counter.
+ *
+ * load() sums the shards, it is not an atomic snapshot of all the threads, but
+ * it never decreases while the counter is only added to.
+ ******************************************************************************/
+class Counter {
+public:
+    /*! Number of shards. */
+    inline constexpr static std::size_t c_shards = 64;
+
+    Counter() noexcept = default;
+    Counter(const Counter& other) = delete;
+    Counter(Counter&& other) noexcept = delete;
+    Counter&
+    operator=(const Counter& other) = delete;
+    Counter&
+    operator=(Counter&& other) noexcept = delete;
+    ~Counter() noexcept = default;
+
+    /*******************************************************************************
+     * @brief Add @p value, lock-free, callable from any thread.
+     ******************************************************************************/
+    void
+    add(std::uint64_t value = 1) noexcept {
+        m_shards[detail::shard_index()].m_value.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    /*******************************************************************************
+     * @brief Sum of all added values, callable from any thread.
+     ******************************************************************************/
+    std::uint64_t
+    load() const noexcept;
+
+private:
+    struct alignas(c_cache_line) Shard {
+        std::atomic<std::uint64_t> m_value{0};
+    };
+
+    std::array<Shard, c_shards> m_shards;
+};
+
+/*******************************************************************************
+ * @brief Smoothed rate of a growing value.
+ *
+ * Exponential moving average of the rate between consecutive samples, older
+ * samples lose weight with the time constant. Time is passed in by the caller.
+ ******************************************************************************/
+class RateMeter {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /*! Default time constant of the smoothing. */
+    inline constexpr static std::chrono::milliseconds c_default_window{1000};
+
+    /*******************************************************************************
+     * @brief New meter without samples.
+     *
+     * @param window Time constant, at least one nanosecond.
+     ******************************************************************************/
+    explicit RateMeter(std::chrono::nanoseconds window = c_default_window) noexcept;
+
+    /*******************************************************************************
+     * @brief Take the sample @p value at @p now.
+     *
+     * @return The updated rate, per second. Zero after the first sample.
+     ******************************************************************************/
+    double
+    sample(std::uint64_t value, Clock::time_point now) noexcept;
+
+    /*******************************************************************************
+     * @brief Rate as of the last sample, per second.
+     ******************************************************************************/
+    double
+    rate() const noexcept;
+
+private:
+    std::chrono::nanoseconds m_window;
+    /*! Time of the last sample, none before the first one. */
+    std::optional<Clock::time_point> m_last_time;
+    std::uint64_t m_last_value = 0;
+    double m_rate = 0.0;
+};
+
+/*******************************************************************************
+ * @brief Progress bar of a Counter, e.g. "[####    ]  50%".
+ *
+ * The counter is sampled once per draw, i.e. once per frame of the layer
+ * showing it, however many times the layout measures the bar. Workers only add
+ * to the counter, the layer is invalidated by the UI at its own pace, e.g. every
+ * frame.
+ ******************************************************************************/
+class ProgressBar : public Element {
+public:
+    /*******************************************************************************
+     * @brief New bar of @p done out of @p total.
+     *
+     * @param done Must not be null.
+     * @throw EltauException if @p done is null.
+     ******************************************************************************/
+    ProgressBar(std::shared_ptr<const Counter> done, std::uint64_t total);
+
+    /*******************************************************************************
+     * @brief Change the value of a full bar.
+     ******************************************************************************/
+    void
+    set_total(std::uint64_t total) noexcept;
+
+private:
+    friend class ElementAccess;
+
+    /*******************************************************************************
+     * @brief One row and all the offered columns.
+     ******************************************************************************/
+    Vec2
+    do_calc_pref_size(Vec2 max_size) override;
+
+    /*******************************************************************************
+     * @brief Sample the counter, draw the bar with the percentage.
+     *
+     * Only the percentage is drawn if the window is too narrow.
+     ******************************************************************************/
+    void
+    do_draw(DrawingWindow& window) override;
+
+    std::shared_ptr<const Counter> m_done;
+    std::uint64_t m_total;
+    /*! Drawn text, the capacity is reused. */
+    std::string m_text;
+};
+
+/*******************************************************************************
+ * @brief Label with the value of a Counter, e.g. "files: 42".
+ *
+ * Sampled once per draw like ProgressBar. The layout measures the text of the
+ * last sample, a longer value is cut off for one frame.
+ ******************************************************************************/
+class CounterLabel : public Element {
+public:
+    /*******************************************************************************
+     * @brief New label of @p counter.
+     *
+     * @param counter Must not be null.
+     * @param label Shown before the value, with a colon, unless empty.
+     * @throw EltauException if @p counter is null.
+     ******************************************************************************/
+    CounterLabel(std::shared_ptr<const Counter> counter, std::string label);
+
+private:
+    friend class ElementAccess;
+
+    /*******************************************************************************
+     * @brief One row as wide as the text of the last sample.
+     ******************************************************************************/
+    Vec2
+    do_calc_pref_size(Vec2 max_size) override;
+
+    /*******************************************************************************
+     * @brief Sample the counter and draw it.
+     ******************************************************************************/
+    void
+    do_draw(DrawingWindow& window) override;
+
+    /*******************************************************************************
+     * @brief Format the current value of the counter into m_text.
+     ******************************************************************************/
+    void
+    sample();
+
+    std::shared_ptr<const Counter> m_counter;
+    std::string m_label;
+    /*! Drawn text, the capacity is reused. */
+    std::string m_text;
+};
+
+/*******************************************************************************
+ * @brief Label with the rate of a Counter, e.g. "1234.5/s".
+ *
+ * Sampled once per draw like CounterLabel, the rate is smoothed by a RateMeter
+ * over the times of the samples.
+ ******************************************************************************/
+class RateLabel : public Element {
+public:
+    /*******************************************************************************
+     * @brief New label of @p counter's rate.
+     *
+     * @param counter Must not be null.
+     * @param unit Shown after the rate.
+     * @param window Time constant of the smoothing, see RateMeter.
+     * @throw EltauException if @p counter is null.
+     ******************************************************************************/
+    RateLabel(std::shared_ptr<const Counter> counter, std::string unit = "/s",
+              std::chrono::nanoseconds window = RateMeter::c_default_window);
+
+    /*******************************************************************************
+     * @brief Rate as of the last sample, per second.
+     ******************************************************************************/
+    double
+    rate() const noexcept;
+
+private:
+    friend class ElementAccess;
+
+    /*******************************************************************************
+     * @brief One row as wide as the text of the last sample.
+     ******************************************************************************/
+    Vec2
+    do_calc_pref_size(Vec2 max_size) override;
+
+    /*******************************************************************************
+     * @brief Sample the counter and draw the rate.
+     ******************************************************************************/
+    void
+    do_draw(DrawingWindow& window) override;
+
+    /*******************************************************************************
+     * @brief Sample the counter, format the updated rate into m_text.
+     ******************************************************************************/
+    void
+    sample();
+
+    std::shared_ptr<const Counter> m_counter;
+    std::string m_unit;
+    RateMeter m_meter;
+    /*! Drawn text, the capacity is reused. */
+    std::string m_text;
+};
+
+} // namespace eltau
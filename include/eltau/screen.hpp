@@ -7,6 +7,7 @@
 
 #include <array>
 #include <cstdint>
+#include <memory_resource>
 #include <ostream>
 #include <span>
 #include <vector>
@@ -168,6 +169,20 @@ public:
     bool
     is_inside(Vec2 pos) const noexcept;
 
+    /*******************************************************************************
+     * @brief Whether the window has no cells.
+     ******************************************************************************/
+    bool
+    empty() const noexcept;
+
+    /*******************************************************************************
+     * @brief Part of the window also covered by @p other.
+     *
+     * @return Empty window if they do not overlap.
+     ******************************************************************************/
+    Window
+    intersect(const Window& other) const noexcept;
+
     /*******************************************************************************
      * @brief Return a sub-window.
      *
@@ -202,15 +217,28 @@ public:
      * @brief Construct a new screen with the given dimensions.
      *
      * @param size Size of the screen.
+     * @param resource Storage of the cells.
      ******************************************************************************/
-    explicit Screen(Vec2 size);
+    explicit Screen(Vec2 size, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 
     /*******************************************************************************
-     * @brief Return screen dimensions passed in the ctor.
+     * @brief Return screen dimensions passed in the ctor or to resize().
      ******************************************************************************/
     Vec2
     size() const noexcept;
 
+    /*******************************************************************************
+     * @brief Change the dimensions, keeping the overlapping content in place.
+     *
+     * Rows are moved within the current storage, which is reallocated only if
+     * the screen grows beyond its largest size so far. New cells are the same as
+     * in a new screen.
+     *
+     * @param size New size of the screen.
+     ******************************************************************************/
+    void
+    resize(Vec2 size);
+
     /*******************************************************************************
      * @brief Line-based access to the screen.
      *
@@ -244,9 +272,23 @@ public:
 private:
     Vec2 m_size;
     /*! Row-major storage. */
-    std::vector<Cell> m_buffer;
+    std::pmr::vector<Cell> m_buffer;
 };
 
+/*******************************************************************************
+ * @brief Fill the cells with unstyled spaces.
+ ******************************************************************************/
+void
+blank(std::span<Cell> cells) noexcept;
+
+/*******************************************************************************
+ * @brief Fill the whole screen with unstyled spaces.
+ ******************************************************************************/
+void
+blank(Screen& screen) noexcept;
+
+class HitMap;
+
 /*******************************************************************************
  * @brief Drawable area in a screen.
  ******************************************************************************/
@@ -257,15 +299,51 @@ public:
      *
      * @param win Window to draw on, copied.
      * @param screen Screen to use, reference is captured.
+     * @param scratch Memory for temporaries of the drawn elements, must outlive
+     * the drawing. Usually a FrameArena reset after each frame.
+     * @param hits Filled with the drawn elements if not null, same size as
+     * @p screen.
      ******************************************************************************/
-    DrawingWindow(const Window& win, Screen& screen) noexcept;
+    DrawingWindow(const Window& win, Screen& screen,
+                  std::pmr::memory_resource* scratch = std::pmr::get_default_resource(),
+                  HitMap* hits = nullptr) noexcept;
 
     /*******************************************************************************
-     * @brief Same as Window::sub_win .
+     * @brief Same as Window::sub_win , shares the screen, the scratch memory and the hit map.
      ******************************************************************************/
     DrawingWindow
     sub_win(Vec2 offset, Vec2 size);
 
+    /*******************************************************************************
+     * @brief Part of the window within the screen, the rest is clipped.
+     *
+     * Elements need not draw outside of it, nothing is drawn if it is empty.
+     ******************************************************************************/
+    Window
+    visible() const noexcept;
+
+    /*******************************************************************************
+     * @brief Memory for temporaries needed only while drawing.
+     ******************************************************************************/
+    std::pmr::memory_resource*
+    scratch() const noexcept;
+
+    /*******************************************************************************
+     * @brief Map of the drawn elements, null if not collected.
+     ******************************************************************************/
+    HitMap*
+    hit_map() const noexcept;
+
+    /*******************************************************************************
+     * @brief Line-based access to the window.
+     *
+     * @param row Screen row, valid values in range [origin, origin+size).
+     * @return Part of the screen line covered by the window, empty if @p row is
+     * not within the window or the screen.
+     ******************************************************************************/
+    Screen::Line
+    line(std::size_t row) noexcept;
+
     /*******************************************************************************
      * @brief Cell-based access to the window.
      *
@@ -284,6 +362,9 @@ public:
 private:
     /*! Used screen, valid unless moved-from. */
     Screen* m_screen;
+    /*! Per-frame memory, never null. */
+    std::pmr::memory_resource* m_scratch;
+    HitMap* m_hits;
 };
 
 
@@ -0,0 +1,185 @@
+/*******************************************************************************
+ * @file server.hpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+#pragma once
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <eltau/element.hpp>
+#include <eltau/event_loop.hpp>
+#include <eltau/input.hpp>
+#include <eltau/terminal.hpp>
+
+namespace eltau {
+
+/*******************************************************************************
+ * @brief Serves many terminal sessions, e.g. ptys or SSH channels, from one loop.
+ *
+ * Each session is one descriptor used for both input and output, with its own
+ * EagerTerminal and InputDecoder. Sessions share nothing but the loop, only
+ * the sessions that requested a redraw are drawn, once per batch of events.
+ *
+ * Output never blocks the loop. A session whose client cannot keep up skips
+ * frames and is watched for writability, its changes are written at once
+ * when the client catches up. Writing to a closed socket raises SIGPIPE, which
+ * servers should ignore.
+ *
+ * Single-threaded, everything must be called from the loop's thread.
+ ******************************************************************************/
+class Server {
+public:
+    /*! Identifier of a session, its descriptor. */
+    using SessionId = int;
+    /*! Handler of the decoded input of a session. */
+    using InputHandler = std::function<void(SessionId, const InputEvent&)>;
+    /*! Handler of a session closed by its client. */
+    using CloseHandler = std::function<void(SessionId)>;
+
+    /*******************************************************************************
+     * @brief New server without sessions.
+     *
+     * @param loop Must outlive the server, its renderer is replaced.
+     ******************************************************************************/
+    explicit Server(EventLoop& loop);
+
+    Server(const Server& other) = delete;
+    Server(Server&& other) noexcept = delete;
+    Server&
+    operator=(const Server& other) = delete;
+    Server&
+    operator=(Server&& other) noexcept = delete;
+
+    /*******************************************************************************
+     * @brief Remove all the sessions.
+     ******************************************************************************/
+    ~Server() noexcept;
+
+    /*******************************************************************************
+     * @brief Start serving @p fd, the first frame is drawn with the next batch.
+     *
+     * @param fd Descriptor owned by the caller, non-blocking until removed.
+     * @param root The root of the session's TUI. Must not be null.
+     * @param size Size of the terminal, queried from @p fd if not set.
+     * @throw EltauException if the size is unknown or @p fd cannot be watched.
+     ******************************************************************************/
+    SessionId
+    add_session(int fd, std::unique_ptr<Element> root, std::optional<Vec2> size = std::nullopt);
+
+    /*******************************************************************************
+     * @brief Stop serving the session, unknown sessions are ignored.
+     *
+     * Its terminal is restored, the descriptor is left open.
+     ******************************************************************************/
+    void
+    remove_session(SessionId id) noexcept;
+
+    /*******************************************************************************
+     * @brief Number of served sessions.
+     ******************************************************************************/
+    std::size_t
+    session_count() const noexcept;
+
+    /*******************************************************************************
+     * @brief Terminal of the session, layers are invalidated through it.
+     *
+     * @throw EltauException if the session is unknown.
+     ******************************************************************************/
+    EagerTerminal&
+    terminal(SessionId id);
+
+    /*******************************************************************************
+     * @brief Draw the session after the current batch of events.
+     ******************************************************************************/
+    void
+    request_redraw(SessionId id) noexcept;
+
+    /*******************************************************************************
+     * @brief Resize the session, e.g. on an SSH window-change request.
+     *
+     * @throw EltauException if the session is unknown.
+     ******************************************************************************/
+    void
+    resize(SessionId id, Vec2 size);
+
+    /*******************************************************************************
+     * @brief Set the handler of the sessions' input.
+     *
+     * The handler may remove any session, including its own.
+     ******************************************************************************/
+    void
+    on_input(InputHandler handler);
+
+    /*******************************************************************************
+     * @brief Set the handler called before removing a session closed by its client.
+     ******************************************************************************/
+    void
+    on_close(CloseHandler handler);
+
+private:
+    /*******************************************************************************
+     * @brief State of one client.
+     ******************************************************************************/
+    struct Session {
+        Session(int fd, int flags, std::unique_ptr<Element> root, std::optional<Vec2> size);
+
+        int m_fd;
+        /*! Flags of m_fd before the session. */
+        int m_flags;
+        EagerTerminal m_terminal;
+        InputDecoder m_decoder;
+        /*! Timer resolving a lone ESC, if any. */
+        std::optional<EventLoop::TimerId> m_escape_timer;
+        /*! Whether the session is in m_dirty. */
+        bool m_dirty = false;
+        /*! Whether m_fd is watched for writing, while output is pending. */
+        bool m_writing = false;
+    };
+
+    /*******************************************************************************
+     * @brief Read and dispatch all the available input of the session.
+     ******************************************************************************/
+    void
+    read_input(SessionId id);
+
+    /*******************************************************************************
+     * @brief Set the timer resolving a lone ESC of the session, unless already set.
+     ******************************************************************************/
+    void
+    arm_escape_timer(SessionId id);
+
+    /*******************************************************************************
+     * @brief Pass the decoded events of the session to the handler.
+     *
+     * @return Whether the session still exists.
+     ******************************************************************************/
+    bool
+    dispatch(SessionId id);
+
+    /*******************************************************************************
+     * @brief Draw the dirty sessions.
+     ******************************************************************************/
+    void
+    render();
+
+    /*******************************************************************************
+     * @brief Find the session or throw.
+     ******************************************************************************/
+    Session&
+    session(SessionId id);
+
+    EventLoop* m_loop;
+    std::map<SessionId, std::unique_ptr<Session>> m_sessions;
+    /*! Sessions to draw at the next render. */
+    std::vector<SessionId> m_dirty;
+
+    InputHandler m_on_input;
+    CloseHandler m_on_close;
+};
+
+} // namespace eltau
@@ -0,0 +1,130 @@
+/*******************************************************************************
+ * @file shape_cache.hpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include <eltau/screen.hpp>
+
+namespace eltau {
+
+/*******************************************************************************
+ * @brief Bounded LRU cache of ASCII texts converted into cells.
+ *
+ * Meant for short, frequently drawn labels. An entry is keyed on the text, its
+ * style and the wrap limit and holds the measured size together with the cells
+ * ready to be copied into a window.
+ ******************************************************************************/
+class ShapeCache {
+public:
+    /*! Default memory budget. */
+    inline constexpr static std::size_t c_default_max_bytes = std::size_t{1} << 20U;
+    /*! Default limit on the length of cached texts. */
+    inline constexpr static std::size_t c_default_max_text = 256;
+
+    /*******************************************************************************
+     * @brief Usage statistics.
+     ******************************************************************************/
+    struct Stats {
+        std::size_t m_hits = 0;
+        std::size_t m_misses = 0;
+        std::size_t m_evictions = 0;
+        /*! Number of cached entries. */
+        std::size_t m_entries = 0;
+        /*! Approximate memory used by the entries. */
+        std::size_t m_bytes = 0;
+
+        /*******************************************************************************
+         * @brief Ratio of hits to all lookups, zero if there were none.
+         ******************************************************************************/
+        double
+        hit_rate() const noexcept;
+    };
+
+    /*******************************************************************************
+     * @brief New empty cache.
+     *
+     * @param max_bytes Memory budget, least recently used entries are evicted to
+     * stay within it. The most recent entry is always kept.
+     * @param max_text Longest text worth caching, see cacheable().
+     ******************************************************************************/
+    explicit ShapeCache(std::size_t max_bytes = c_default_max_bytes, std::size_t max_text = c_default_max_text);
+
+    /*******************************************************************************
+     * @brief Whether @p text should be cached or rather drawn directly.
+     ******************************************************************************/
+    bool
+    cacheable(std::string_view text) const noexcept;
+
+    /*******************************************************************************
+     * @brief Shaped text, computed on a miss.
+     *
+     * Shaping follows ascii::Text rules.
+     *
+     * @param text ASCII text.
+     * @param style Style of all the cells.
+     * @param wrap_limit Character-based wrapping, see ascii::Text.
+     * @return Cells of the text, size() is the measured size. Valid until the next
+     * call to shape() or clear().
+     ******************************************************************************/
+    const Screen&
+    shape(std::string_view text, Style style, std::size_t wrap_limit);
+
+    /*******************************************************************************
+     * @brief Drop all entries, statistics are kept.
+     ******************************************************************************/
+    void
+    clear() noexcept;
+
+    /*******************************************************************************
+     * @brief Current statistics.
+     ******************************************************************************/
+    Stats
+    stats() const noexcept;
+
+private:
+    /*******************************************************************************
+     * @brief Lookup key, views the text of the entry or the queried text.
+     ******************************************************************************/
+    struct Key {
+        std::string_view m_text;
+        Style m_style;
+        std::size_t m_wrap_limit;
+        /*! Precomputed hash of the members above. */
+        std::size_t m_hash;
+
+        bool
+        operator==(const Key& other) const noexcept;
+    };
+
+    struct KeyHash {
+        std::size_t
+        operator()(const Key& key) const noexcept;
+    };
+
+    struct Entry {
+        /*! Owned copy of the text, viewed by m_key. */
+        std::string m_text;
+        Key m_key;
+        Screen m_cells;
+        /*! Memory used by the entry. */
+        std::size_t m_bytes = 0;
+    };
+
+    /*! Most recently used first. */
+    std::list<Entry> m_lru;
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> m_map;
+
+    std::size_t m_max_bytes;
+    std::size_t m_max_text;
+    Stats m_stats;
+};
+
+} // namespace eltau
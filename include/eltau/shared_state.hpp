@@ -3,42 +3,118 @@
  * @copyright Copyright 2022 Jan Waltl.
  * @license	This file is released under ElTau project's license, see LICENSE.
  ******************************************************************************/
+#pragma once
+
 #include <concepts>
 #include <cstdint>
-#include <memory>
+#include <utility>
+
+#include <eltau/task.hpp>
 
 namespace eltau {
+namespace detail {
 
-struct SharedStateBaseImpl {
+/*******************************************************************************
+ * @brief Version and waiters of a SharedState, independent of its type.
+ ******************************************************************************/
+class StateBase {
 public:
+    StateBase() noexcept = default;
+    StateBase(const StateBase& other) = delete;
+    StateBase(StateBase&& other) noexcept = delete;
+    StateBase&
+    operator=(const StateBase& other) = delete;
+    StateBase&
+    operator=(StateBase&& other) noexcept = delete;
+    ~StateBase() noexcept = default;
+
+    /*******************************************************************************
+     * @brief Number of changes so far.
+     ******************************************************************************/
+    std::uint64_t
+    version() const noexcept;
+
+protected:
+    /*******************************************************************************
+     * @brief Bump the version and wake up the awaiting tasks.
+     ******************************************************************************/
     void
-    next() noexcept;
-    std::size_t
-    current() const noexcept;
+    notify() noexcept;
 
 private:
-    std::size_t m_version;
-};
+    friend class eltau::Scheduler;
 
+    std::uint64_t m_version = 0;
+    /*! Scheduler::StateAwaiters. */
+    WaitList m_waiters;
+};
+} // namespace detail
 
+/*******************************************************************************
+ * @brief Value observed by Tasks, see Scheduler::changed().
+ *
+ * Every change bumps the version and resumes the awaiting tasks later in the
+ * same frame, changing the state repeatedly resumes them only once.
+ * Single-threaded like the Scheduler.
+ ******************************************************************************/
 template <typename State>
-struct SharedStateImpl : public SharedStateBaseImpl {
+class SharedState : public detail::StateBase {
 public:
+    /*******************************************************************************
+     * @brief New state constructed from @p args.
+     ******************************************************************************/
     template <typename... Args>
-    requires(std::constructible_from<State, Args...>) explicit SharedStateImpl(Args&&... args);
+    requires(std::constructible_from<State, Args...>) explicit SharedState(Args&&... args);
 
-    const State*
-    get() const;
+    /*******************************************************************************
+     * @brief Current value.
+     ******************************************************************************/
+    const State&
+    get() const noexcept;
 
-    // Will inc count in ~(), but we either have to hope this object does not go out of scope
-    // or it too has to have its own m_state.
-    auto
-    borrow();
+    /*******************************************************************************
+     * @brief Replace the value.
+     ******************************************************************************/
+    void
+    set(State state);
+
+    /*******************************************************************************
+     * @brief Modify the value in-place.
+     *
+     * @param func Called with State&.
+     ******************************************************************************/
+    template <typename F>
+    void
+    update(F&& func);
 
 private:
-    std::shared_ptr<State> m_state;
+    State m_state;
 };
 
 template <typename State>
-using SharedState = std::shared_ptr<SharedStateImpl<State>>;
+template <typename... Args>
+requires(std::constructible_from<State, Args...>) SharedState<State>::SharedState(Args&&... args) :
+    m_state(std::forward<Args>(args)...) {}
+
+template <typename State>
+const State&
+SharedState<State>::get() const noexcept {
+    return m_state;
+}
+
+template <typename State>
+void
+SharedState<State>::set(State state) {
+    m_state = std::move(state);
+    notify();
+}
+
+template <typename State>
+template <typename F>
+void
+SharedState<State>::update(F&& func) {
+    std::forward<F>(func)(m_state);
+    notify();
+}
+
 } // namespace eltau
@@ -0,0 +1,189 @@
+/*******************************************************************************
+ * @file shared_subtree.hpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+#include <eltau/element.hpp>
+#include <eltau/screen.hpp>
+
+namespace eltau {
+
+/*******************************************************************************
+ * @brief Element subtree laid out and drawn once for many terminals.
+ *
+ * The subtree does not change between versions, it is modified only through
+ * update() or replace(), which bump the version. Preferred sizes are cached per
+ * (version, maximum size) and rendered cells per (version, window size), so
+ * each distinct size is laid out and drawn once per change, no matter how many
+ * SharedElements show it. Entries of old versions are redrawn in place.
+ *
+ * Owned by std::shared_ptr, see SharedElement. Not thread-safe, meant for
+ * terminals driven by one loop, see Server.
+ ******************************************************************************/
+class SharedSubtree {
+public:
+    /*! Default number of cached sizes. */
+    inline constexpr static std::size_t c_default_max_sizes = 8;
+
+    /*******************************************************************************
+     * @brief New subtree at version zero.
+     *
+     * @param root Must not be null.
+     * @param max_sizes Number of sizes cached at once, the oldest one is evicted.
+     * @throw EltauException if @p root is null.
+     ******************************************************************************/
+    explicit SharedSubtree(std::unique_ptr<Element> root, std::size_t max_sizes = c_default_max_sizes);
+
+    SharedSubtree(const SharedSubtree& other) = delete;
+    SharedSubtree(SharedSubtree&& other) noexcept = delete;
+    SharedSubtree&
+    operator=(const SharedSubtree& other) = delete;
+    SharedSubtree&
+    operator=(SharedSubtree&& other) noexcept = delete;
+    ~SharedSubtree() noexcept = default;
+
+    /*******************************************************************************
+     * @brief Number of changes so far.
+     ******************************************************************************/
+    std::uint64_t
+    version() const noexcept;
+
+    /*******************************************************************************
+     * @brief Swap the whole subtree, starts a new version.
+     *
+     * @throw EltauException if @p root is null.
+     ******************************************************************************/
+    void
+    replace(std::unique_ptr<Element> root);
+
+    /*******************************************************************************
+     * @brief Modify the subtree, starts a new version.
+     *
+     * @param func Called with the root Element&.
+     ******************************************************************************/
+    template <typename F>
+    void
+    update(F&& func);
+
+    /*******************************************************************************
+     * @brief Preferred size of the root, see Element::calc_pref_size().
+     ******************************************************************************/
+    Vec2
+    pref_size(Vec2 max_size);
+
+    /*******************************************************************************
+     * @brief Cells of the subtree drawn into a window of @p size.
+     *
+     * @param scratch Scratch memory of the draw, see DrawingWindow::scratch().
+     * @return Valid until the next call to render(), replace() or update().
+     ******************************************************************************/
+    const Screen&
+    render(Vec2 size, std::pmr::memory_resource* scratch = std::pmr::get_default_resource());
+
+    /*******************************************************************************
+     * @brief Number of times the subtree has been drawn, cache misses of render().
+     ******************************************************************************/
+    std::size_t
+    draw_count() const noexcept;
+
+private:
+    /*******************************************************************************
+     * @brief Cached preferred size.
+     ******************************************************************************/
+    struct Layout {
+        std::uint64_t m_version;
+        Vec2 m_max_size;
+        Vec2 m_pref_size;
+    };
+
+    /*******************************************************************************
+     * @brief Cached drawing, m_cells.size() is the window size.
+     ******************************************************************************/
+    struct Block {
+        std::uint64_t m_version;
+        Screen m_cells;
+    };
+
+    /*******************************************************************************
+     * @brief Start a new version.
+     ******************************************************************************/
+    void
+    bump() noexcept;
+
+    std::unique_ptr<Element> m_root;
+    std::uint64_t m_version = 0;
+    std::size_t m_max_sizes;
+    std::size_t m_draw_count = 0;
+
+    /*! Entries in the order of insertion, evicted round-robin. */
+    std::vector<Layout> m_layouts;
+    std::size_t m_next_layout = 0;
+    std::vector<Block> m_blocks;
+    std::size_t m_next_block = 0;
+};
+
+template <typename F>
+void
+SharedSubtree::update(F&& func) {
+    std::forward<F>(func)(*m_root);
+    bump();
+}
+
+/*******************************************************************************
+ * @brief Shows a SharedSubtree, copies its cached cells into the window.
+ *
+ * Every terminal has its own SharedElement, they share the subtree. The hit
+ * map is marked with the SharedElement, not with the elements of the subtree.
+ ******************************************************************************/
+class SharedElement : public Element {
+public:
+    /*******************************************************************************
+     * @brief New element showing @p subtree.
+     *
+     * @param subtree Must not be null.
+     * @throw EltauException if @p subtree is null.
+     ******************************************************************************/
+    explicit SharedElement(std::shared_ptr<SharedSubtree> subtree);
+
+    /*******************************************************************************
+     * @brief The shown subtree.
+     ******************************************************************************/
+    SharedSubtree&
+    subtree() const noexcept;
+
+    /*******************************************************************************
+     * @brief Whether the subtree changed since the last draw, i.e. the layer
+     * showing the element should be invalidated.
+     ******************************************************************************/
+    bool
+    stale() const noexcept;
+
+private:
+    friend class ElementAccess;
+
+    /*******************************************************************************
+     * @brief Cached preferred size of the subtree.
+     ******************************************************************************/
+    Vec2
+    do_calc_pref_size(Vec2 max_size) override;
+
+    /*******************************************************************************
+     * @brief Copy the cached cells of the subtree, rendered at the window size.
+     ******************************************************************************/
+    void
+    do_draw(DrawingWindow& window) override;
+
+    std::shared_ptr<SharedSubtree> m_subtree;
+    /*! Version of the subtree drawn last, none before the first draw. */
+    std::uint64_t m_drawn_version = UINT64_MAX;
+};
+
+} // namespace eltau
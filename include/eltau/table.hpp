@@ -0,0 +1,199 @@
+/*******************************************************************************
+ * @file table.hpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <eltau/element.hpp>
+#include <eltau/flex.hpp>
+#include <eltau/screen.hpp>
+
+namespace eltau {
+
+/*******************************************************************************
+ * @brief Column of a Table.
+ ******************************************************************************/
+struct TableColumn {
+    /*! Header, ASCII. */
+    std::string m_title;
+    /*! Sizing of the column, m_align is ignored. */
+    FlexItem m_flex{};
+};
+
+/*******************************************************************************
+ * @brief Grid of ASCII cells with a header row.
+ *
+ * Natural width of a column is its widest cell. It is kept up-to-date
+ * incrementally as cells are added or changed, so the table is never
+ * re-measured as a whole. Columns are then sized by FlexSolver according to
+ * their FlexItem, cells that do not fit are cut off.
+ *
+ * Rows are addressed by the order in which they were added, independent of the
+ * displayed order. Sorting only permutes the displayed order.
+ *
+ * Only the visible rows and columns are drawn, one bulk write per line.
+ ******************************************************************************/
+class Table : public Element {
+public:
+    /*! Cells of one row. */
+    using Row = std::vector<std::string>;
+
+    /*******************************************************************************
+     * @brief New empty table.
+     ******************************************************************************/
+    explicit Table(std::vector<TableColumn> columns);
+
+    /*******************************************************************************
+     * @brief Number of columns.
+     ******************************************************************************/
+    std::size_t
+    column_count() const noexcept;
+
+    /*******************************************************************************
+     * @brief Number of rows, without the header.
+     ******************************************************************************/
+    std::size_t
+    row_count() const noexcept;
+
+    /*******************************************************************************
+     * @brief Append a row, shown last until sorted again.
+     *
+     * @param row Cells, missing ones are empty.
+     * @return Index of the row.
+     * @throw EltauException if @p row has too many cells.
+     ******************************************************************************/
+    std::size_t
+    add_row(Row row);
+
+    /*******************************************************************************
+     * @brief Replace the row @p idx, its displayed position is kept.
+     *
+     * @throw EltauException if @p idx is out of range or @p row has too many cells.
+     ******************************************************************************/
+    void
+    set_row(std::size_t idx, Row row);
+
+    /*******************************************************************************
+     * @brief Replace one cell.
+     *
+     * @throw EltauException if @p row or @p column is out of range.
+     ******************************************************************************/
+    void
+    set_cell(std::size_t row, std::size_t column, std::string text);
+
+    /*******************************************************************************
+     * @brief Access one cell.
+     *
+     * @throw EltauException if @p row or @p column is out of range.
+     ******************************************************************************/
+    const std::string&
+    cell(std::size_t row, std::size_t column) const;
+
+    /*******************************************************************************
+     * @brief Index of the row displayed at @p pos.
+     ******************************************************************************/
+    std::size_t
+    displayed(std::size_t pos) const noexcept;
+
+    /*******************************************************************************
+     * @brief Stable sort of the displayed rows by the cells of @p column.
+     *
+     * @throw EltauException if @p column is out of range.
+     ******************************************************************************/
+    void
+    sort(std::size_t column, bool descending = false);
+
+    /*******************************************************************************
+     * @brief Natural width of @p column - its widest cell, the header included.
+     ******************************************************************************/
+    std::size_t
+    natural_width(std::size_t column) const noexcept;
+
+    /*******************************************************************************
+     * @brief Show the displayed row @p pos first.
+     ******************************************************************************/
+    void
+    scroll_to(std::size_t pos) noexcept;
+
+    /*******************************************************************************
+     * @brief Show @p column as the left-most one.
+     ******************************************************************************/
+    void
+    scroll_to_column(std::size_t column) noexcept;
+
+    /*******************************************************************************
+     * @brief Solver of the column widths, for statistics.
+     ******************************************************************************/
+    const FlexSolver&
+    solver() const noexcept;
+
+private:
+    friend class ElementAccess;
+
+    /*******************************************************************************
+     * @brief Header and rows, natural widths of the columns and separators.
+     ******************************************************************************/
+    Vec2
+    do_calc_pref_size(Vec2 max_size) override;
+
+    /*******************************************************************************
+     * @brief Draw the header and the visible rows.
+     ******************************************************************************/
+    void
+    do_draw(DrawingWindow& window) override;
+
+    /*******************************************************************************
+     * @brief Count the cell @p text in or out of the natural width of @p column.
+     ******************************************************************************/
+    void
+    measure(std::size_t column, std::string_view text, bool add);
+
+    /*******************************************************************************
+     * @brief Throw if @p row has too many cells, pad it with empty ones.
+     ******************************************************************************/
+    void
+    normalize(Row& row) const;
+
+    /*******************************************************************************
+     * @brief Widths of the visible columns for @p width columns, cached.
+     ******************************************************************************/
+    std::span<const std::size_t>
+    layout(std::size_t width);
+
+    /*******************************************************************************
+     * @brief Compose one line of visible cells into m_line.
+     *
+     * @param widths Widths of the visible columns.
+     * @param row Row to compose, the header if null.
+     * @param width Width of the line.
+     ******************************************************************************/
+    void
+    compose(std::span<const std::size_t> widths, const Row* row, std::size_t width);
+
+    std::vector<TableColumn> m_columns;
+    /*! Per column: cell width -> number of such cells, the header included. */
+    std::vector<std::map<std::size_t, std::size_t>> m_widths;
+    std::vector<Row> m_rows;
+    /*! Displayed order of the rows. */
+    std::vector<std::size_t> m_order;
+
+    std::size_t m_first_row = 0;
+    std::size_t m_first_column = 0;
+
+    /*! Sizing of the visible columns. */
+    FlexSolver m_solver;
+    std::vector<FlexItem> m_items;
+    std::vector<std::size_t> m_prefs;
+    /*! Line being composed. */
+    std::string m_line;
+};
+
+} // namespace eltau
@@ -0,0 +1,119 @@
+/*******************************************************************************
+ * @file tail_view.hpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include <eltau/element.hpp>
+#include <eltau/screen.hpp>
+
+namespace eltau {
+
+/*******************************************************************************
+ * @brief Last lines of a fast stream of ASCII lines.
+ *
+ * Lines are kept in a fixed-capacity ring of line records over a single byte
+ * arena, both allocated up-front. Appending never allocates nor blocks, the
+ * oldest lines are overwritten once either the ring or the arena is full. Lines
+ * whose text has been overwritten are drawn empty, so the arena should hold at
+ * least a screenful of lines.
+ *
+ * One producer thread may append while another thread draws. The drawing side
+ * copies only the visible parts of the visible lines and discards any it finds
+ * overwritten meanwhile. More producers must be serialized externally.
+ ******************************************************************************/
+class TailView : public Element {
+public:
+    /*! Default number of kept lines. */
+    inline constexpr static std::size_t c_default_lines = 1024;
+    /*! Default size of the byte arena. */
+    inline constexpr static std::size_t c_default_bytes = std::size_t{1} << 16U;
+
+    /*******************************************************************************
+     * @brief New empty view.
+     *
+     * @param max_lines Maximum number of kept lines, at least one.
+     * @param arena_bytes Size of the arena for the lines' text, at least one.
+     ******************************************************************************/
+    explicit TailView(std::size_t max_lines = c_default_lines, std::size_t arena_bytes = c_default_bytes);
+
+    /*******************************************************************************
+     * @brief Append a line, O(line length), lock-free and allocation-free.
+     *
+     * Single producer only.
+     *
+     * @param line One line of ASCII text, newlines are escaped. Cut off to the
+     * arena size.
+     ******************************************************************************/
+    void
+    append(std::string_view line) noexcept;
+
+    /*******************************************************************************
+     * @brief Number of lines appended in total.
+     ******************************************************************************/
+    std::size_t
+    appended() const noexcept;
+
+private:
+    friend class ElementAccess;
+
+    /*******************************************************************************
+     * @brief Position of a line in the arena.
+     ******************************************************************************/
+    struct Record {
+        /*! Position of the first byte, in bytes appended in total. */
+        std::size_t m_begin = 0;
+        std::size_t m_length = 0;
+    };
+
+    /*******************************************************************************
+     * @brief Kept lines, limited, and all the offered columns.
+     ******************************************************************************/
+    Vec2
+    do_calc_pref_size(Vec2 max_size) override;
+
+    /*******************************************************************************
+     * @brief Draw the last lines, oldest at the top.
+     ******************************************************************************/
+    void
+    do_draw(DrawingWindow& window) override;
+
+    /*******************************************************************************
+     * @brief Number of lines whose records are not overwritten yet.
+     ******************************************************************************/
+    std::size_t
+    kept(std::size_t appended) const noexcept;
+
+    /*******************************************************************************
+     * @brief Copy @p length bytes from the arena @p pos to @p out.
+     ******************************************************************************/
+    void
+    copy_out(std::size_t pos, std::size_t length, char* out) const noexcept;
+
+    const std::size_t m_max_lines;
+    const std::size_t m_arena_bytes;
+    std::unique_ptr<Record[]> m_records;
+    std::unique_ptr<char[]> m_arena;
+
+    /*! Published lines, the producer's release store. */
+    std::atomic<std::size_t> m_appended{0};
+    /*! Lines and bytes the producer has started to write, validate reads. */
+    std::atomic<std::size_t> m_claimed_lines{0};
+    std::atomic<std::size_t> m_claimed_bytes{0};
+    /*! Bytes appended in total, owned by the producer. */
+    std::size_t m_bytes = 0;
+
+    /*! Visible text copied out of the arena, owned by the drawing thread. */
+    std::vector<char> m_scratch;
+    /*! Records of the visible lines, owned by the drawing thread. */
+    std::vector<Record> m_visible;
+};
+
+} // namespace eltau
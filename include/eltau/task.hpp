@@ -0,0 +1,425 @@
+/*******************************************************************************
+ * @file task.hpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+#pragma once
+
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+
+#include <eltau/event_loop.hpp>
+#include <eltau/input.hpp>
+#include <eltau/timer_wheel.hpp>
+
+namespace eltau {
+
+class Scheduler;
+
+namespace detail {
+class StateBase;
+class WaitList;
+
+/*******************************************************************************
+ * @brief Intrusive node of a suspended coroutine.
+ *
+ * Lives in the coroutine frame, waiting never allocates. Unlinks itself when
+ * destroyed, so destroying a suspended coroutine is always safe.
+ ******************************************************************************/
+class WaitNode {
+public:
+    WaitNode() noexcept = default;
+    WaitNode(const WaitNode& other) = delete;
+    WaitNode(WaitNode&& other) noexcept = delete;
+    WaitNode&
+    operator=(const WaitNode& other) = delete;
+    WaitNode&
+    operator=(WaitNode&& other) noexcept = delete;
+    ~WaitNode() noexcept;
+
+    /*******************************************************************************
+     * @brief Remove the node from its list, if any.
+     ******************************************************************************/
+    void
+    unlink() noexcept;
+
+    /*******************************************************************************
+     * @brief Following node in the list, null for the last one.
+     ******************************************************************************/
+    WaitNode*
+    next() const noexcept;
+
+    /*! Coroutine to resume. */
+    std::coroutine_handle<> m_handle;
+
+private:
+    friend class WaitList;
+
+    WaitList* m_list = nullptr;
+    WaitNode* m_prev = nullptr;
+    WaitNode* m_next = nullptr;
+};
+
+/*******************************************************************************
+ * @brief FIFO of WaitNodes.
+ ******************************************************************************/
+class WaitList {
+public:
+    WaitList() noexcept = default;
+    WaitList(const WaitList& other) = delete;
+    WaitList(WaitList&& other) noexcept = delete;
+    WaitList&
+    operator=(const WaitList& other) = delete;
+    WaitList&
+    operator=(WaitList&& other) noexcept = delete;
+
+    /*******************************************************************************
+     * @brief Unlink all the nodes.
+     ******************************************************************************/
+    ~WaitList() noexcept;
+
+    /*******************************************************************************
+     * @brief Append @p node, which must not be in any list.
+     ******************************************************************************/
+    void
+    push_back(WaitNode& node) noexcept;
+
+    /*******************************************************************************
+     * @brief Unlink and return the first node, null if empty.
+     ******************************************************************************/
+    WaitNode*
+    pop_front() noexcept;
+
+    /*******************************************************************************
+     * @brief First node, null if empty.
+     ******************************************************************************/
+    WaitNode*
+    front() const noexcept;
+
+    bool
+    empty() const noexcept;
+
+    /*******************************************************************************
+     * @brief Move all nodes of @p other to the end of this list.
+     ******************************************************************************/
+    void
+    splice(WaitList& other) noexcept;
+
+private:
+    friend class WaitNode;
+
+    WaitNode* m_head = nullptr;
+    WaitNode* m_tail = nullptr;
+};
+} // namespace detail
+
+/*******************************************************************************
+ * @brief Coroutine running UI logic on the event loop thread.
+ *
+ * Created suspended, runs once passed to Scheduler::spawn(). Can await only
+ * the awaiters of a Scheduler, which resume it from the event loop.
+ ******************************************************************************/
+class Task {
+public:
+    class promise_type {
+    public:
+        Task
+        get_return_object() noexcept;
+
+        std::suspend_always
+        initial_suspend() const noexcept {
+            return {};
+        }
+
+        /*! The scheduler destroys finished tasks. */
+        std::suspend_always
+        final_suspend() const noexcept {
+            return {};
+        }
+
+        void
+        return_void() const noexcept {}
+
+        void
+        unhandled_exception() noexcept;
+
+    private:
+        friend class Scheduler;
+
+        /*! Rethrown by the scheduler. */
+        std::exception_ptr m_exception;
+        /*! Node in the scheduler's list of tasks. */
+        detail::WaitNode m_task;
+    };
+
+    Task(const Task& other) = delete;
+    Task(Task&& other) noexcept;
+    Task&
+    operator=(const Task& other) = delete;
+    Task&
+    operator=(Task&& other) noexcept;
+
+    /*******************************************************************************
+     * @brief Destroy the coroutine if it has not been spawned.
+     ******************************************************************************/
+    ~Task() noexcept;
+
+private:
+    friend class Scheduler;
+
+    using Handle = std::coroutine_handle<promise_type>;
+
+    explicit Task(Handle handle) noexcept;
+
+    Handle m_handle;
+};
+
+/*******************************************************************************
+ * @brief Runs Tasks on an event loop without threads or polling.
+ *
+ * Tasks await the next frame, a timer, an input event or a SharedState change.
+ * The awaiters are intrusive nodes in the suspended coroutine's frame, waiting
+ * allocates nothing. Frames are paced by the frame interval: tasks awaiting a
+ * frame are resumed together at most once per interval, followed by one redraw.
+ *
+ * Sleeping tasks are kept in a TimerWheel ticking once per frame interval, so
+ * sleeps are rounded up to frames and all timers due in the same frame resume
+ * together. One timerfd is armed for the next tick or frame to process.
+ *
+ * Single-threaded, everything must be called from the loop's thread.
+ ******************************************************************************/
+class Scheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /*! Default minimum time between frames, ~60 FPS. */
+    inline constexpr static std::chrono::milliseconds c_default_frame_interval{16};
+
+    /*******************************************************************************
+     * @brief Resumes the awaiting task at the next frame.
+     ******************************************************************************/
+    class FrameAwaiter : private detail::WaitNode {
+    public:
+        explicit FrameAwaiter(Scheduler& scheduler) noexcept;
+
+        bool
+        await_ready() const noexcept;
+
+        void
+        await_suspend(std::coroutine_handle<Task::promise_type> handle) noexcept;
+
+        void
+        await_resume() const noexcept {}
+
+    private:
+        friend class Scheduler;
+
+        Scheduler* m_scheduler;
+    };
+
+    /*******************************************************************************
+     * @brief Resumes the awaiting task at a deadline.
+     ******************************************************************************/
+    class TimerAwaiter : private detail::WaitNode, private TimerWheel::Entry {
+    public:
+        TimerAwaiter(Scheduler& scheduler, Clock::time_point deadline) noexcept;
+
+        /*! Past deadlines do not suspend. */
+        bool
+        await_ready() const noexcept;
+
+        void
+        await_suspend(std::coroutine_handle<Task::promise_type> handle) noexcept;
+
+        void
+        await_resume() const noexcept {}
+
+    private:
+        friend class Scheduler;
+
+        Scheduler* m_scheduler;
+        Clock::time_point m_deadline;
+    };
+
+    /*******************************************************************************
+     * @brief Resumes the awaiting task with the next dispatched input event.
+     ******************************************************************************/
+    class InputAwaiter : private detail::WaitNode {
+    public:
+        explicit InputAwaiter(Scheduler& scheduler) noexcept;
+
+        bool
+        await_ready() const noexcept;
+
+        void
+        await_suspend(std::coroutine_handle<Task::promise_type> handle) noexcept;
+
+        /*! Paste text is valid only until the task suspends again. */
+        InputEvent
+        await_resume() const noexcept;
+
+    private:
+        friend class Scheduler;
+
+        Scheduler* m_scheduler;
+        InputEvent m_event{};
+    };
+
+    /*******************************************************************************
+     * @brief Resumes the awaiting task after the next change of a SharedState.
+     ******************************************************************************/
+    class StateAwaiter : private detail::WaitNode {
+    public:
+        StateAwaiter(Scheduler& scheduler, detail::StateBase& state) noexcept;
+
+        bool
+        await_ready() const noexcept;
+
+        void
+        await_suspend(std::coroutine_handle<Task::promise_type> handle) noexcept;
+
+        void
+        await_resume() const noexcept {}
+
+    private:
+        friend class Scheduler;
+        friend class detail::StateBase;
+
+        Scheduler* m_scheduler;
+        detail::StateBase* m_state;
+    };
+
+    /*******************************************************************************
+     * @brief New scheduler running on @p loop.
+     *
+     * @param loop Must outlive the scheduler.
+     * @param frame_interval Minimum time between frames.
+     * @throw EltauException if the timer cannot be created.
+     ******************************************************************************/
+    explicit Scheduler(EventLoop& loop, std::chrono::nanoseconds frame_interval = c_default_frame_interval);
+
+    Scheduler(const Scheduler& other) = delete;
+    Scheduler(Scheduler&& other) noexcept = delete;
+    Scheduler&
+    operator=(const Scheduler& other) = delete;
+    Scheduler&
+    operator=(Scheduler&& other) noexcept = delete;
+
+    /*******************************************************************************
+     * @brief Destroy all unfinished tasks.
+     ******************************************************************************/
+    ~Scheduler() noexcept;
+
+    /*******************************************************************************
+     * @brief Start @p task, it runs until its first suspension.
+     *
+     * Finished tasks are destroyed. Exceptions escaping a task are rethrown
+     * from whatever resumed it, usually EventLoop::poll().
+     ******************************************************************************/
+    void
+    spawn(Task task);
+
+    /*******************************************************************************
+     * @brief Number of unfinished tasks.
+     ******************************************************************************/
+    std::size_t
+    task_count() const noexcept;
+
+    /*******************************************************************************
+     * @brief co_await to continue at the next frame.
+     ******************************************************************************/
+    FrameAwaiter
+    next_frame() noexcept;
+
+    /*******************************************************************************
+     * @brief co_await to continue after @p delay.
+     ******************************************************************************/
+    TimerAwaiter
+    sleep_for(std::chrono::nanoseconds delay) noexcept;
+
+    /*******************************************************************************
+     * @brief co_await to continue at @p deadline.
+     ******************************************************************************/
+    TimerAwaiter
+    sleep_until(Clock::time_point deadline) noexcept;
+
+    /*******************************************************************************
+     * @brief co_await to get the next event passed to dispatch().
+     ******************************************************************************/
+    InputAwaiter
+    next_input() noexcept;
+
+    /*******************************************************************************
+     * @brief co_await to continue after the next change of @p state.
+     *
+     * @param state Must outlive the awaiting.
+     ******************************************************************************/
+    StateAwaiter
+    changed(detail::StateBase& state) noexcept;
+
+    /*******************************************************************************
+     * @brief Resume all tasks awaiting input with @p event.
+     *
+     * Usually called with the events of an InputDecoder fed from
+     * EventLoop::on_input().
+     ******************************************************************************/
+    void
+    dispatch(const InputEvent& event);
+
+private:
+    friend class detail::StateBase;
+
+    /*******************************************************************************
+     * @brief Resume the task waiting at @p node later in this frame.
+     ******************************************************************************/
+    void
+    post(detail::WaitNode& node) noexcept;
+
+    /*******************************************************************************
+     * @brief Make the timer expire at @p deadline unless it already expires sooner.
+     ******************************************************************************/
+    void
+    arm(Clock::time_point deadline) noexcept;
+
+    /*******************************************************************************
+     * @brief Resume everything that is due.
+     ******************************************************************************/
+    void
+    expire();
+
+    /*******************************************************************************
+     * @brief Resume the tasks in @p list in order.
+     *
+     * If a task throws, the rest is resumed later and the exception is rethrown.
+     ******************************************************************************/
+    void
+    resume_all(detail::WaitList& list);
+
+    /*******************************************************************************
+     * @brief Resume one task, destroy it if it finishes.
+     ******************************************************************************/
+    static void
+    resume(std::coroutine_handle<> handle);
+
+    EventLoop* m_loop;
+    std::chrono::nanoseconds m_frame_interval;
+    int m_timer = -1;
+    /*! Expiration of m_timer, max if disarmed. */
+    Clock::time_point m_armed = Clock::time_point::max();
+    Clock::time_point m_last_frame{};
+
+    /*! All unfinished spawned tasks. */
+    detail::WaitList m_tasks;
+    /*! Awaiting the next frame. */
+    detail::WaitList m_frame;
+    /*! TimerAwaiters awaiting their deadlines. */
+    TimerWheel m_wheel;
+    /*! Awaiting input. */
+    detail::WaitList m_input;
+    /*! Ready to be resumed. */
+    detail::WaitList m_ready;
+};
+
+} // namespace eltau
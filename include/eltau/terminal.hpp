@@ -3,36 +3,249 @@
  * @copyright Copyright 2022 Jan Waltl.
  * @license	This file is released under ElTau project's license, see LICENSE.
  ******************************************************************************/
+#pragma once
 
+#include <chrono>
 #include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
 
+#include <termios.h>
+
+#include <eltau/compositor.hpp>
 #include <eltau/element.hpp>
+#include <eltau/event_loop.hpp>
 #include <eltau/screen.hpp>
 
 namespace eltau {
 
 /*******************************************************************************
  * @brief Terminal without caching.
+ *
+ * Bound to a pair of descriptors, there is no global state, so one process may
+ * drive many terminals, see Server. A tty input is switched to raw mode and the
+ * output to the alternate screen for the lifetime of the terminal.
+ *
+ * Output is written without blocking when the descriptor is non-blocking. A
+ * frame that cannot be written at once is kept and finished by flush(), frames
+ * drawn meanwhile are skipped and their changes written by the next one.
  ******************************************************************************/
 class EagerTerminal {
 public:
+    /*! Resizes arriving within this time after the first one are applied at once. */
+    inline constexpr static std::chrono::milliseconds c_resize_debounce{50};
+
     /*******************************************************************************
-     * @brief New full-screen terminal with specified root element.
+     * @brief New full-screen terminal on the standard input and output.
      *
-     * @param root The root of the TUI to draw.
+     * @param root The root of the TUI to draw, the bottom layer. Must not be null.
+     * @throw EltauException if the size of the terminal is unknown.
      ******************************************************************************/
     explicit EagerTerminal(std::unique_ptr<Element> root);
 
+    /*******************************************************************************
+     * @brief New full-screen terminal on the given descriptors.
+     *
+     * @param root The root of the TUI to draw, the bottom layer. Must not be null.
+     * @param input_fd Switched to raw mode if it is a tty, may equal @p output_fd.
+     * @param output_fd Descriptor to write to, must outlive the terminal.
+     * @param size Size of the terminal, queried from @p output_fd if not set.
+     * @throw EltauException if the size is not set and cannot be queried.
+     ******************************************************************************/
+    EagerTerminal(std::unique_ptr<Element> root, int input_fd, int output_fd, std::optional<Vec2> size = std::nullopt);
+
+    EagerTerminal(const EagerTerminal& other) = delete;
+    EagerTerminal(EagerTerminal&& other) noexcept = delete;
+    EagerTerminal&
+    operator=(const EagerTerminal& other) = delete;
+    EagerTerminal&
+    operator=(EagerTerminal&& other) noexcept = delete;
+
+    /*******************************************************************************
+     * @brief Leave the alternate screen and restore the input's mode.
+     ******************************************************************************/
+    ~EagerTerminal() noexcept;
+
     /*******************************************************************************
      * @brief Draw TUI.
      *
-     * Uncached version that always re-draws the whole terminal screen.
+     * Composes the layers and writes out the re-composed rectangles. Skipped
+     * while a previous frame is not fully written, the changes are kept.
      ******************************************************************************/
     void
     draw();
 
+    /*******************************************************************************
+     * @brief Write as much of the pending output as possible without blocking.
+     *
+     * Output that cannot be written, e.g. to a closed peer, is dropped.
+     *
+     * @return Whether everything has been written.
+     ******************************************************************************/
+    bool
+    flush();
+
+    /*******************************************************************************
+     * @brief Whether a part of a frame is waiting for flush().
+     ******************************************************************************/
+    bool
+    output_pending() const noexcept;
+
+    /*******************************************************************************
+     * @brief Layers of the terminal, popups and overlays are added on top.
+     ******************************************************************************/
+    Compositor&
+    compositor() noexcept;
+
+    /*******************************************************************************
+     * @brief Layer of the root element.
+     ******************************************************************************/
+    Compositor::LayerId
+    root_layer() const noexcept;
+
+    /*******************************************************************************
+     * @brief Resize the TUI, the root layer covers the whole new size.
+     *
+     * Everything is laid out and written out again by the next draw().
+     ******************************************************************************/
+    void
+    resize(Vec2 size);
+
+    /*******************************************************************************
+     * @brief Draw from @p loop whenever a redraw is requested.
+     *
+     * Bursts of resizes, e.g. from dragging a window edge, are debounced: the
+     * first one starts a c_resize_debounce timer, the size is queried and applied
+     * once when it expires. The current size is kept if it cannot be queried.
+     * Requests the first draw.
+     *
+     * @param loop Must not outlive the terminal.
+     ******************************************************************************/
+    void
+    attach(EventLoop& loop);
+
 private:
-    std::unique_ptr<Element> m_root;
-    Screen m_screen;
+    int m_input;
+    int m_output;
+    /*! Mode of m_input before the terminal, if it is a tty. */
+    std::optional<termios> m_orig_term;
+    Compositor m_compositor;
+    Compositor::LayerId m_root_layer;
+    /*! Unwritten output, the capacity is reused by all frames. */
+    std::string m_out;
+    /*! Whether a debounced resize is waiting for its timer. */
+    bool m_resize_pending = false;
+};
+
+/*******************************************************************************
+ * @brief Terminal drawing a few lines at the cursor, under the normal output.
+ *
+ * Meant for progress displays of command-line tools. A region of fixed height
+ * is reserved at the cursor, the rest of the terminal and its scrollback are
+ * left alone and the mode of the terminal is not changed. Only the re-composed
+ * rectangles are written, positioned by cursor moves relative to the region,
+ * the cursor rests at its top-left corner in between.
+ *
+ * Permanent lines are printed above the region by log(), the terminal shifts
+ * the region down by inserting lines, so it is not repainted. Nothing else may
+ * write to the terminal while the region is shown.
+ ******************************************************************************/
+class InlineTerminal {
+public:
+    /*******************************************************************************
+     * @brief New region on the standard output.
+     *
+     * @param root The root of the TUI to draw, the bottom layer. Must not be null.
+     * @param height Number of rows of the region, at least one.
+     * @throw EltauException if the height is zero or the width is unknown.
+     ******************************************************************************/
+    InlineTerminal(std::unique_ptr<Element> root, std::size_t height);
+
+    /*******************************************************************************
+     * @brief New region on the given descriptor.
+     *
+     * @param root The root of the TUI to draw, the bottom layer. Must not be null.
+     * @param height Number of rows of the region, at least one.
+     * @param output_fd Descriptor to write to, must outlive the terminal.
+     * @param width Width of the terminal, queried from @p output_fd if not set.
+     * @throw EltauException if the height is zero or the width is unknown.
+     ******************************************************************************/
+    InlineTerminal(std::unique_ptr<Element> root, std::size_t height, int output_fd,
+                   std::optional<std::size_t> width = std::nullopt);
+
+    InlineTerminal(const InlineTerminal& other) = delete;
+    InlineTerminal(InlineTerminal&& other) noexcept = delete;
+    InlineTerminal&
+    operator=(const InlineTerminal& other) = delete;
+    InlineTerminal&
+    operator=(InlineTerminal&& other) noexcept = delete;
+
+    /*******************************************************************************
+     * @brief Leave the last frame in place and move the cursor below it.
+     ******************************************************************************/
+    ~InlineTerminal() noexcept;
+
+    /*******************************************************************************
+     * @brief Draw the region.
+     *
+     * Same as EagerTerminal::draw(), with moves relative to the region.
+     ******************************************************************************/
+    void
+    draw();
+
+    /*******************************************************************************
+     * @brief Print @p text above the region, it scrolls with the normal output.
+     *
+     * Every line of @p text is wrapped to the width of the terminal, control
+     * characters are dropped. The region keeps its content.
+     ******************************************************************************/
+    void
+    log(std::string_view text);
+
+    /*******************************************************************************
+     * @brief Same as EagerTerminal::flush().
+     ******************************************************************************/
+    bool
+    flush();
+
+    /*******************************************************************************
+     * @brief Whether a part of the output is waiting for flush().
+     ******************************************************************************/
+    bool
+    output_pending() const noexcept;
+
+    /*******************************************************************************
+     * @brief Layers of the region.
+     ******************************************************************************/
+    Compositor&
+    compositor() noexcept;
+
+    /*******************************************************************************
+     * @brief Layer of the root element.
+     ******************************************************************************/
+    Compositor::LayerId
+    root_layer() const noexcept;
+
+    /*******************************************************************************
+     * @brief Draw from @p loop whenever a redraw is requested, requests the first draw.
+     *
+     * @param loop Must not outlive the terminal.
+     ******************************************************************************/
+    void
+    attach(EventLoop& loop);
+
+private:
+    /*******************************************************************************
+     * @brief Move the cursor from row @p from of the region to row @p to.
+     ******************************************************************************/
+    void
+    move_rows(std::size_t from, std::size_t to);
+
+    int m_output;
+    Compositor m_compositor;
+    Compositor::LayerId m_root_layer;
+    /*! Unwritten output, the capacity is reused by all frames. */
+    std::string m_out;
 };
 } // namespace eltau
@@ -7,14 +7,48 @@
 
 #include <cstdint>
 #include <limits>
+#include <memory>
+#include <memory_resource>
+#include <span>
 #include <string>
+#include <string_view>
 
 #include <eltau/element.hpp>
+#include <eltau/line_index.hpp>
 #include <eltau/screen.hpp>
 
+namespace eltau {
+class ShapeCache;
+
+/*******************************************************************************
+ * @brief Tag type selecting constructors that borrow their input.
+ ******************************************************************************/
+struct BorrowTag {
+    explicit BorrowTag() = default;
+};
+
+/*! Borrow the passed buffer, the caller guarantees it outlives the borrower. */
+inline constexpr BorrowTag c_borrow{};
+} // namespace eltau
+
 namespace eltau::ascii {
+/*******************************************************************************
+ * @brief Write one line of ASCII text to the cells, pad the rest with spaces.
+ *
+ * Non-printable characters are escaped the same way as in Text.
+ *
+ * @param cells Target cells, @p line is cut off if it does not fit.
+ * @param line Text without newlines.
+ * @param style Style of all the cells.
+ ******************************************************************************/
+void
+draw_line(std::span<Cell> cells, std::string_view line, Style style = {}) noexcept;
+
 /*******************************************************************************
  * @brief Basic styled ASCII text with optional wrapping.
+ *
+ * The text is either owned, shared with other owners, or borrowed. It is never
+ * modified - non-printable characters are escaped only when drawn.
  ******************************************************************************/
 class Text : public Element {
 public:
@@ -27,19 +61,132 @@ public:
      * All non-printable ASCII characters are escaped apart from newline.
      * Which is still respected and correctly wraps the text.
      *
-     * @param text String to show, ASCII-only.
+     * @param text String to show, ASCII-only, copied.
      * @param wrap_limit Optional character-based wrapping. c_no_wrap is no wrapping.
      ******************************************************************************/
     explicit Text(std::string_view text, std::size_t wrap_limit = c_no_wrap);
 
+    /*******************************************************************************
+     * @brief Same as Text(std::string_view, std::size_t), keeps the text in @p alloc.
+     *
+     * Later edits of the text and the line index allocate from @p alloc as well.
+     ******************************************************************************/
+    Text(std::allocator_arg_t, std::pmr::polymorphic_allocator<> alloc, std::string_view text,
+         std::size_t wrap_limit = c_no_wrap);
+
+    /*******************************************************************************
+     * @brief New ASCII Text element sharing the text with other owners.
+     *
+     * @param text String to show, ASCII-only, not copied. Null is an empty text.
+     * @param wrap_limit Same as in Text(std::string_view, std::size_t).
+     ******************************************************************************/
+    explicit Text(std::shared_ptr<const std::string> text, std::size_t wrap_limit = c_no_wrap);
+
+    /*******************************************************************************
+     * @brief Same as Text(std::shared_ptr<const std::string>, std::size_t), keeps
+     * the line index and later edits in @p alloc.
+     ******************************************************************************/
+    Text(std::allocator_arg_t, std::pmr::polymorphic_allocator<> alloc, std::shared_ptr<const std::string> text,
+         std::size_t wrap_limit = c_no_wrap);
+
+    /*******************************************************************************
+     * @brief New ASCII Text element borrowing the text.
+     *
+     * @param text String to show, ASCII-only, not copied. Must outlive the element.
+     * @param wrap_limit Same as in Text(std::string_view, std::size_t).
+     ******************************************************************************/
+    Text(BorrowTag, std::string_view text, std::size_t wrap_limit = c_no_wrap);
+
+    /*******************************************************************************
+     * @brief Same as Text(BorrowTag, std::string_view, std::size_t), keeps the line
+     * index and later edits in @p alloc.
+     *
+     * Texts rebuilt every frame in a FrameArena then allocate only from the arena.
+     ******************************************************************************/
+    Text(std::allocator_arg_t, std::pmr::polymorphic_allocator<> alloc, BorrowTag, std::string_view text,
+         std::size_t wrap_limit = c_no_wrap);
+
+    /*******************************************************************************
+     * @brief Copy sharing the text until either is edited, edits use the same allocator.
+     ******************************************************************************/
+    Text(const Text& other);
+    /*******************************************************************************
+     * @brief Same as Text(const Text&), keeps the line index and edits in @p alloc.
+     *
+     * The line index is not copied, the copy builds its own on the first use.
+     ******************************************************************************/
+    Text(std::allocator_arg_t, std::pmr::polymorphic_allocator<> alloc, const Text& other);
+    /*******************************************************************************
+     * @brief Default move ctor.
+     ******************************************************************************/
+    Text(Text&& other) noexcept = default;
+    /*******************************************************************************
+     * @brief Not assignable, the allocator is fixed for the lifetime of the element.
+     ******************************************************************************/
+    Text&
+    operator=(const Text& other) = delete;
+    /*******************************************************************************
+     * @brief See copy assignment.
+     ******************************************************************************/
+    Text&
+    operator=(Text&& other) noexcept = delete;
+    /*******************************************************************************
+     * @brief Default destructor.
+     ******************************************************************************/
+    ~Text() noexcept override = default;
+
+    /*******************************************************************************
+     * @brief Append to the text.
+     *
+     * Only the last paragraph is re-indexed and re-wrapped, the cost is
+     * proportional to @p text. Shared or borrowed text is copied on the first edit.
+     *
+     * @param text String to append, ASCII-only.
+     ******************************************************************************/
+    void
+    append(std::string_view text);
+
+    /*******************************************************************************
+     * @brief Replace a part of the text.
+     *
+     * Only the paragraphs touching the replaced range are re-indexed and re-wrapped.
+     * Shared or borrowed text is copied on the first edit.
+     *
+     * @param pos Offset of the first replaced character.
+     * @param count Number of replaced characters, clamped to the text size.
+     * @param text Replacement, ASCII-only.
+     * @throw EltauException if @p pos is out of range.
+     ******************************************************************************/
+    void
+    replace(std::size_t pos, std::size_t count, std::string_view text);
+
+    /*******************************************************************************
+     * @brief Set style of all the characters.
+     ******************************************************************************/
+    void
+    set_style(Style style) noexcept;
+
+    /*******************************************************************************
+     * @brief Measure and draw cacheable texts through @p cache.
+     *
+     * Useful for short labels drawn repeatedly by many elements.
+     *
+     * @param cache Shared cache, null disables caching.
+     ******************************************************************************/
+    void
+    set_shape_cache(std::shared_ptr<ShapeCache> cache) noexcept;
+
 private:
+    friend class eltau::ElementAccess;
+
     /*******************************************************************************
      * @brief Return the space needed to render text.
      *
      * By default, the text is rendered in one-line unless wrapped or if contains
      * an explicit newline.
      *
-     * Wrapping is either based on `wrap_limit` or the size limits.
+     * Wrapping is either based on `wrap_limit` or the size limits. O(1) for
+     * repeated queries with the same effective wrap limit.
      *
      * @param max_size limits on the size.
      * @return Calculated necessary size.
@@ -51,15 +198,121 @@ private:
      * @brief Draw text to the assigned window.
      *
      * Wraps the text if necessary, cuts off the rest that cannot fit if there are
-     * not enough lines.
+     * not enough lines. Only the visible lines are touched.
      ******************************************************************************/
     void
     do_draw(DrawingWindow& window) override;
 
-    /*! Text to render. */
-    std::string m_text;
+    /*******************************************************************************
+     * @brief Line breaks in m_text, indexed on the first use.
+     ******************************************************************************/
+    LineIndex&
+    index();
+
+    /*******************************************************************************
+     * @brief Storage that can be modified in-place, copied if needed.
+     ******************************************************************************/
+    std::pmr::string&
+    editable();
+
+    /*! Keeps the text alive, null if borrowed. */
+    std::shared_ptr<const void> m_storage;
+    /*! m_storage if created by this element, modifiable when not shared. */
+    std::pmr::string* m_editable = nullptr;
+    /*! Source of the owned storage. */
+    std::pmr::polymorphic_allocator<> m_alloc;
+    /*! Text to render, unescaped. */
+    std::string_view m_text;
     /*! Hard wrap-limit on the text. */
     std::size_t m_wrap_limit;
+    /*! Line breaks in m_text, valid if m_indexed. */
+    LineIndex m_index;
+    /*! Whether m_index has been built. */
+    bool m_indexed = false;
+    /*! Style of all the characters. */
+    Style m_style{};
+    /*! Optional cache of shaped texts. */
+    std::shared_ptr<ShapeCache> m_cache;
 };
 
 } // namespace eltau::ascii
+
+namespace eltau::utf8 {
+/*******************************************************************************
+ * @brief UTF-8 text with optional wrapping.
+ *
+ * Text is segmented into grapheme clusters, each occupies one or two cells
+ * according to its East Asian width. Wrapping never splits a cluster.
+ * Pure-ASCII parts of the text take the same fast path as ascii::Text.
+ *
+ * Control characters are escaped, invalid sequences are drawn as U+FFFD.
+ * Clusters too long for a Cell are replaced by U+FFFD as well.
+ ******************************************************************************/
+class Text : public Element {
+public:
+    /*! Constant denoting unwrapped text. */
+    inline constexpr static std::size_t c_no_wrap = std::numeric_limits<std::size_t>::max();
+
+    /*******************************************************************************
+     * @brief New UTF-8 Text element.
+     *
+     * @param text String to show, copied.
+     * @param wrap_limit Optional cell-based wrapping. c_no_wrap is no wrapping.
+     ******************************************************************************/
+    explicit Text(std::string_view text, std::size_t wrap_limit = c_no_wrap);
+
+    /*******************************************************************************
+     * @brief New UTF-8 Text element sharing the text with other owners.
+     *
+     * @param text String to show, not copied. Null is an empty text.
+     * @param wrap_limit Same as in Text(std::string_view, std::size_t).
+     ******************************************************************************/
+    explicit Text(std::shared_ptr<const std::string> text, std::size_t wrap_limit = c_no_wrap);
+
+    /*******************************************************************************
+     * @brief New UTF-8 Text element borrowing the text.
+     *
+     * @param text String to show, not copied. Must outlive the element.
+     * @param wrap_limit Same as in Text(std::string_view, std::size_t).
+     ******************************************************************************/
+    Text(BorrowTag, std::string_view text, std::size_t wrap_limit = c_no_wrap);
+
+private:
+    friend class eltau::ElementAccess;
+
+    /*******************************************************************************
+     * @brief Return the space needed to render text, in cells.
+     *
+     * Same rules as ascii::Text::do_calc_pref_size().
+     ******************************************************************************/
+    Vec2
+    do_calc_pref_size(Vec2 max_size) override;
+
+    /*******************************************************************************
+     * @brief Draw text to the assigned window.
+     *
+     * Wide clusters occupy two cells, the second one is left empty. A wide
+     * cluster that does not fit on the line is replaced by a space.
+     ******************************************************************************/
+    void
+    do_draw(DrawingWindow& window) override;
+
+    /*******************************************************************************
+     * @brief Line breaks in m_text, indexed on the first use.
+     ******************************************************************************/
+    LineIndex&
+    index();
+
+    /*! Keeps the text alive, null if borrowed. */
+    std::shared_ptr<const std::string> m_storage;
+    /*! Text to render, unescaped. */
+    std::string_view m_text;
+    /*! Hard wrap-limit on the text. */
+    std::size_t m_wrap_limit;
+    /*! Line breaks in m_text, valid if m_indexed. */
+    LineIndex m_index;
+    /*! Whether m_index has been built. */
+    bool m_indexed = false;
+};
+
+} // namespace eltau::utf8
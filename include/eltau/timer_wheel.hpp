@@ -0,0 +1,207 @@
+/*******************************************************************************
+ * @file timer_wheel.hpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+namespace eltau {
+
+/*******************************************************************************
+ * @brief Hashed hierarchical timer wheel.
+ *
+ * Time is split into ticks, usually one frame long. Timers are intrusive
+ * entries owned by the caller, scheduling and cancelling are O(1). Four levels
+ * of 64 slots cover 2^24 ticks, farther deadlines wait in the last level. An
+ * advance() is O(elapsed ticks + expired timers), timers due within the same
+ * tick expire together.
+ *
+ * Time is passed in by the caller, any clock, including a fake one, works.
+ ******************************************************************************/
+class TimerWheel {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /*! Bits of the tick per level. */
+    inline constexpr static std::size_t c_slot_bits = 6;
+    inline constexpr static std::size_t c_slots = std::size_t{1} << c_slot_bits;
+    inline constexpr static std::size_t c_levels = 4;
+
+    /*******************************************************************************
+     * @brief Timer scheduled in a wheel, cancelled when destroyed.
+     ******************************************************************************/
+    class Entry {
+    public:
+        Entry() noexcept = default;
+        Entry(const Entry& other) = delete;
+        Entry(Entry&& other) noexcept = delete;
+        Entry&
+        operator=(const Entry& other) = delete;
+        Entry&
+        operator=(Entry&& other) noexcept = delete;
+        ~Entry() noexcept;
+
+        /*******************************************************************************
+         * @brief Whether the timer is scheduled and has not expired yet.
+         ******************************************************************************/
+        bool
+        pending() const noexcept;
+
+        /*******************************************************************************
+         * @brief Unschedule the timer, no-op if not pending.
+         ******************************************************************************/
+        void
+        cancel() noexcept;
+
+    private:
+        friend class TimerWheel;
+
+        /*! Null unless pending. */
+        TimerWheel* m_wheel = nullptr;
+        Entry* m_prev = nullptr;
+        Entry* m_next = nullptr;
+        /*! Tick of the expiration. */
+        std::uint64_t m_tick = 0;
+        std::uint8_t m_level = 0;
+        std::uint8_t m_slot = 0;
+    };
+
+    /*******************************************************************************
+     * @brief New empty wheel.
+     *
+     * @param tick Granularity, at least one nanosecond.
+     * @param start Time of the first tick.
+     ******************************************************************************/
+    TimerWheel(std::chrono::nanoseconds tick, Clock::time_point start) noexcept;
+
+    TimerWheel(const TimerWheel& other) = delete;
+    TimerWheel(TimerWheel&& other) noexcept = delete;
+    TimerWheel&
+    operator=(const TimerWheel& other) = delete;
+    TimerWheel&
+    operator=(TimerWheel&& other) noexcept = delete;
+
+    /*******************************************************************************
+     * @brief Cancel all the pending timers.
+     ******************************************************************************/
+    ~TimerWheel() noexcept;
+
+    /*******************************************************************************
+     * @brief Schedule @p entry, rescheduled if already pending.
+     *
+     * @param deadline Rounded up to a tick, past deadlines expire at the next
+     * unprocessed tick.
+     ******************************************************************************/
+    void
+    schedule(Entry& entry, Clock::time_point deadline) noexcept;
+
+    /*******************************************************************************
+     * @brief Expire all timers due at @p now.
+     *
+     * @param expire Called with each expired Entry&, which is no longer pending
+     * and may be scheduled again.
+     ******************************************************************************/
+    template <typename F>
+    void
+    advance(Clock::time_point now, F&& expire);
+
+    /*******************************************************************************
+     * @brief When advance() should be called next, if at all.
+     *
+     * Exact for timers due within the current lap of the lowest level, at most
+     * 64 ticks ahead otherwise.
+     ******************************************************************************/
+    std::optional<Clock::time_point>
+    next_deadline() const noexcept;
+
+    /*******************************************************************************
+     * @brief Number of pending timers.
+     ******************************************************************************/
+    std::size_t
+    size() const noexcept;
+
+    /*******************************************************************************
+     * @brief Granularity of the wheel.
+     ******************************************************************************/
+    std::chrono::nanoseconds
+    tick() const noexcept;
+
+private:
+    /*******************************************************************************
+     * @brief Slots of one level, circular lists with sentinels.
+     ******************************************************************************/
+    struct Level {
+        std::array<Entry, c_slots> m_slots;
+        /*! Non-empty slots. */
+        std::uint64_t m_occupied = 0;
+    };
+
+    /*******************************************************************************
+     * @brief Put @p entry into its slot relative to m_next.
+     ******************************************************************************/
+    void
+    insert(Entry& entry) noexcept;
+
+    /*******************************************************************************
+     * @brief Unlink @p entry from its slot.
+     ******************************************************************************/
+    void
+    remove(Entry& entry) noexcept;
+
+    /*******************************************************************************
+     * @brief Re-insert all entries of the slot of @p level for the current tick.
+     ******************************************************************************/
+    void
+    cascade(std::size_t level) noexcept;
+
+    /*******************************************************************************
+     * @brief Process tick m_next, expired entries are moved to m_expired.
+     ******************************************************************************/
+    void
+    step() noexcept;
+
+    /*******************************************************************************
+     * @brief Tick of @p time, rounded down.
+     ******************************************************************************/
+    std::uint64_t
+    to_tick(Clock::time_point time) const noexcept;
+
+    std::chrono::nanoseconds m_tick;
+    Clock::time_point m_start;
+    /*! Next tick to process. */
+    std::uint64_t m_next = 0;
+    std::size_t m_size = 0;
+    std::array<Level, c_levels> m_levels;
+    /*! Sentinel of the timers expired by step(), not yet reported. */
+    Entry m_expired;
+};
+
+template <typename F>
+void
+TimerWheel::advance(Clock::time_point now, F&& expire) {
+    const auto target = to_tick(now);
+    while (m_next <= target) {
+        if (m_size == 0) {
+            // Nothing to cascade or expire.
+            m_next = target + 1;
+            break;
+        }
+        step();
+    }
+
+    while (m_expired.m_next != &m_expired) {
+        auto& entry = *m_expired.m_next;
+        entry.m_prev->m_next = entry.m_next;
+        entry.m_next->m_prev = entry.m_prev;
+        entry.m_wheel = nullptr;
+        entry.m_prev = entry.m_next = nullptr;
+        expire(entry);
+    }
+}
+
+} // namespace eltau
@@ -0,0 +1,107 @@
+/*******************************************************************************
+ * @file utf8.hpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace eltau::utf8 {
+
+/*! Substitute for invalid UTF-8 sequences. */
+inline constexpr char32_t c_replacement = 0xFFFD;
+
+/*******************************************************************************
+ * @brief Simplified Grapheme_Cluster_Break property of a code point.
+ *
+ * Subset of UAX #29 needed for terminal output, Prepend and Hangul L/V/T
+ * distinctions are not made.
+ ******************************************************************************/
+enum class GraphemeClass : std::uint8_t {
+    Other = 0,
+    Control = 1,
+    Extend = 2,
+    Zwj = 3,
+    RegionalIndicator = 4,
+    ExtPict = 5,
+    SpacingMark = 6,
+};
+
+/*******************************************************************************
+ * @brief One user-perceived character.
+ ******************************************************************************/
+struct Grapheme {
+    /*! Offset of the first byte. */
+    std::size_t m_begin = 0;
+    /*! Number of bytes. */
+    std::size_t m_length = 0;
+    /*! Display width in terminal cells, 1 or 2. */
+    std::size_t m_width = 0;
+    /*! Control character that must be escaped. */
+    bool m_control = false;
+    /*! Contains an invalid sequence (or U+FFFD), drawn as c_replacement. */
+    bool m_replaced = false;
+
+    bool
+    operator==(const Grapheme&) const noexcept = default;
+};
+
+/*******************************************************************************
+ * @brief Decode one code point.
+ *
+ * @param str Input string.
+ * @param pos Position of the first byte, advanced past the decoded sequence,
+ * always at least by one byte.
+ * @return Decoded code point, c_replacement for invalid or truncated sequences.
+ ******************************************************************************/
+char32_t
+decode(std::string_view str, std::size_t& pos) noexcept;
+
+/*******************************************************************************
+ * @brief Display width of a code point - 0, 1 or 2 cells.
+ *
+ * East Asian Wide and Fullwidth characters take two cells, combining marks and
+ * format characters none.
+ ******************************************************************************/
+std::size_t
+width(char32_t cp) noexcept;
+
+/*******************************************************************************
+ * @brief Grapheme_Cluster_Break class of a code point.
+ ******************************************************************************/
+GraphemeClass
+grapheme_class(char32_t cp) noexcept;
+
+/*******************************************************************************
+ * @brief Length of the leading pure-ASCII part of @p str.
+ *
+ * Vectorized, processes 16 bytes per step where SSE2 is available.
+ ******************************************************************************/
+std::size_t
+ascii_prefix(std::string_view str) noexcept;
+
+/*******************************************************************************
+ * @brief Whether @p str contains only ASCII characters.
+ ******************************************************************************/
+bool
+is_ascii(std::string_view str) noexcept;
+
+/*******************************************************************************
+ * @brief Extended grapheme cluster starting at @p pos.
+ *
+ * @param str Input string, invalid sequences are allowed.
+ * @param pos Offset of the cluster, must be a valid index into @p str.
+ * @return The cluster, non-empty.
+ ******************************************************************************/
+Grapheme
+next_grapheme(std::string_view str, std::size_t pos) noexcept;
+
+/*******************************************************************************
+ * @brief Display width of @p str - sum of its graphemes' widths.
+ ******************************************************************************/
+std::size_t
+str_width(std::string_view str) noexcept;
+
+} // namespace eltau::utf8
@@ -0,0 +1,205 @@
+/*******************************************************************************
+ * @file virtual_list.hpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <eltau/element.hpp>
+#include <eltau/screen.hpp>
+
+namespace eltau {
+
+/*******************************************************************************
+ * @brief Prefix sums of a sequence with O(log n) updates and searches.
+ *
+ * Fenwick tree.
+ ******************************************************************************/
+class PrefixSums {
+public:
+    /*******************************************************************************
+     * @brief Replace the sequence, O(n).
+     *
+     * @param count Number of values.
+     * @param value Returns the value at the passed index.
+     ******************************************************************************/
+    void
+    assign(std::size_t count, const std::function<std::size_t(std::size_t)>& value);
+
+    /*******************************************************************************
+     * @brief Number of values.
+     ******************************************************************************/
+    std::size_t
+    size() const noexcept;
+
+    /*******************************************************************************
+     * @brief Change the value at @p idx.
+     ******************************************************************************/
+    void
+    set(std::size_t idx, std::size_t value) noexcept;
+
+    /*******************************************************************************
+     * @brief Value at @p idx.
+     ******************************************************************************/
+    std::size_t
+    at(std::size_t idx) const noexcept;
+
+    /*******************************************************************************
+     * @brief Sum of the values before @p idx.
+     ******************************************************************************/
+    std::size_t
+    prefix(std::size_t idx) const noexcept;
+
+    /*******************************************************************************
+     * @brief Sum of all the values.
+     ******************************************************************************/
+    std::size_t
+    total() const noexcept;
+
+    /*******************************************************************************
+     * @brief Index of the value covering @p offset.
+     *
+     * @return Largest index with prefix(index) <= @p offset, size() if @p offset
+     * is not below total().
+     ******************************************************************************/
+    std::size_t
+    find(std::size_t offset) const noexcept;
+
+private:
+    /*! 1-based tree, m_tree[i] holds the sum of (i - lowbit(i), i]. */
+    std::vector<std::size_t> m_tree{0};
+};
+
+/*******************************************************************************
+ * @brief Scrollable list of rows created on demand.
+ *
+ * Rows are pulled from a factory only when they become visible and are kept
+ * only while they stay visible, so the per-frame cost and the number of live
+ * elements depend on the viewport, not on the number of rows.
+ *
+ * Row heights come from an optional callback, their prefix sums are kept for
+ * O(log n) mapping between scroll offsets and rows. That is the only per-row
+ * memory and it is not needed at all if all rows are one line tall.
+ ******************************************************************************/
+class VirtualList : public Element {
+public:
+    /*! Creates the element of the row at the passed index. */
+    using RowFactory = std::function<std::unique_ptr<Element>(std::size_t)>;
+    /*! Height of the row at the passed index, in lines. */
+    using RowHeight = std::function<std::size_t(std::size_t)>;
+
+    /*******************************************************************************
+     * @brief New list scrolled to the top.
+     *
+     * @param count Number of rows.
+     * @param factory Row elements, must not return null.
+     * @param height Row heights, all rows are one line tall if empty.
+     ******************************************************************************/
+    VirtualList(std::size_t count, RowFactory factory, RowHeight height = {});
+
+    /*******************************************************************************
+     * @brief Change the number of rows, drops all row elements.
+     *
+     * Queries all heights again, O(count).
+     ******************************************************************************/
+    void
+    set_count(std::size_t count);
+
+    /*******************************************************************************
+     * @brief Number of rows.
+     ******************************************************************************/
+    std::size_t
+    count() const noexcept;
+
+    /*******************************************************************************
+     * @brief Re-query height of the row at @p row, O(log n).
+     ******************************************************************************/
+    void
+    update_height(std::size_t row);
+
+    /*******************************************************************************
+     * @brief Drop all row elements, they are re-created from the factory.
+     ******************************************************************************/
+    void
+    refresh() noexcept;
+
+    /*******************************************************************************
+     * @brief Total height of all rows.
+     ******************************************************************************/
+    std::size_t
+    content_height() const noexcept;
+
+    /*******************************************************************************
+     * @brief First line of the row at @p row.
+     ******************************************************************************/
+    std::size_t
+    row_offset(std::size_t row) const noexcept;
+
+    /*******************************************************************************
+     * @brief Row covering the line @p offset, count() if past the end.
+     ******************************************************************************/
+    std::size_t
+    row_at(std::size_t offset) const noexcept;
+
+    /*******************************************************************************
+     * @brief Scroll so that the line @p offset is at the top.
+     *
+     * Clamped when drawn so that the view is filled if possible.
+     ******************************************************************************/
+    void
+    scroll_to(std::size_t offset) noexcept;
+
+    /*******************************************************************************
+     * @brief Scroll so that the row @p row is at the top.
+     ******************************************************************************/
+    void
+    scroll_to_row(std::size_t row) noexcept;
+
+    /*******************************************************************************
+     * @brief Current scroll offset, in lines.
+     ******************************************************************************/
+    std::size_t
+    offset() const noexcept;
+
+    /*******************************************************************************
+     * @brief Number of live row elements.
+     ******************************************************************************/
+    std::size_t
+    live_rows() const noexcept;
+
+private:
+    friend class ElementAccess;
+
+    /*******************************************************************************
+     * @brief Content height, limited, and all the offered columns.
+     ******************************************************************************/
+    Vec2
+    do_calc_pref_size(Vec2 max_size) override;
+
+    /*******************************************************************************
+     * @brief Draw the visible rows, pad the rest with spaces.
+     *
+     * A row scrolled partially above the window is drawn with its top cut off.
+     ******************************************************************************/
+    void
+    do_draw(DrawingWindow& window) override;
+
+    std::size_t m_count;
+    RowFactory m_factory;
+    RowHeight m_height;
+    /*! Prefix sums of the row heights, empty if all are one. */
+    PrefixSums m_heights;
+    std::size_t m_offset = 0;
+    /*! Elements of the rows visible in the last draw, ordered by row. */
+    std::vector<std::pair<std::size_t, std::unique_ptr<Element>>> m_visible;
+    /*! Elements being collected by draw, kept to reuse its storage. */
+    std::vector<std::pair<std::size_t, std::unique_ptr<Element>>> m_next;
+};
+
+} // namespace eltau
@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+"""Generate src/unicode_data.hpp - code point ranges with width and grapheme properties.
+
+The ranges are turned into two-level lookup tables at compile time by src/utf8.cpp.
+Uses the Unicode database bundled with Python, Extended_Pictographic is listed
+below because `unicodedata` does not expose it.
+
+Usage: scripts/gen_unicode_data.py > src/unicode_data.hpp
+"""
+
+import sys
+import unicodedata
+
+# Grapheme classes, keep in sync with eltau::utf8::GraphemeClass.
+OTHER, CONTROL, EXTEND, ZWJ, REGIONAL_INDICATOR, EXT_PICT, SPACING_MARK = range(7)
+
+# Extended_Pictographic from emoji-data.txt.
+EXT_PICT_RANGES = [
+    (0x00A9, 0x00A9), (0x00AE, 0x00AE), (0x203C, 0x203C), (0x2049, 0x2049), (0x2122, 0x2122),
+    (0x2139, 0x2139), (0x2194, 0x2199), (0x21A9, 0x21AA), (0x231A, 0x231B), (0x2328, 0x2328),
+    (0x2388, 0x2388), (0x23CF, 0x23CF), (0x23E9, 0x23F3), (0x23F8, 0x23FA), (0x24C2, 0x24C2),
+    (0x25AA, 0x25AB), (0x25B6, 0x25B6), (0x25C0, 0x25C0), (0x25FB, 0x25FE), (0x2600, 0x2605),
+    (0x2607, 0x2612), (0x2614, 0x2685), (0x2690, 0x2705), (0x2708, 0x2712), (0x2714, 0x2714),
+    (0x2716, 0x2716), (0x271D, 0x271D), (0x2721, 0x2721), (0x2728, 0x2728), (0x2733, 0x2734),
+    (0x2744, 0x2744), (0x2747, 0x2747), (0x274C, 0x274C), (0x274E, 0x274E), (0x2753, 0x2755),
+    (0x2757, 0x2757), (0x2763, 0x2767), (0x2795, 0x2797), (0x27A1, 0x27A1), (0x27B0, 0x27B0),
+    (0x27BF, 0x27BF), (0x2934, 0x2935), (0x2B05, 0x2B07), (0x2B1B, 0x2B1C), (0x2B50, 0x2B50),
+    (0x2B55, 0x2B55), (0x3030, 0x3030), (0x303D, 0x303D), (0x3297, 0x3297), (0x3299, 0x3299),
+    (0x1F000, 0x1F0FF), (0x1F10D, 0x1F10F), (0x1F12F, 0x1F12F), (0x1F16C, 0x1F171), (0x1F17E, 0x1F17F),
+    (0x1F18E, 0x1F18E), (0x1F191, 0x1F19A), (0x1F1AD, 0x1F1E5), (0x1F201, 0x1F20F), (0x1F21A, 0x1F21A),
+    (0x1F22F, 0x1F22F), (0x1F232, 0x1F23A), (0x1F23C, 0x1F23F), (0x1F249, 0x1F3FA), (0x1F400, 0x1F53D),
+    (0x1F546, 0x1F64F), (0x1F680, 0x1F6FF), (0x1F774, 0x1F77F), (0x1F7D5, 0x1F7FF), (0x1F80C, 0x1F80F),
+    (0x1F848, 0x1F84F), (0x1F85A, 0x1F85F), (0x1F888, 0x1F88F), (0x1F8AE, 0x1F8FF), (0x1F90C, 0x1F93A),
+    (0x1F93C, 0x1F945), (0x1F947, 0x1FAFF), (0x1FC00, 0x1FFFD),
+]
+
+
+def grapheme_class(cp, cat):
+    if cp == 0x200D:
+        return ZWJ
+    if 0x1F1E6 <= cp <= 0x1F1FF:
+        return REGIONAL_INDICATOR
+    # Emoji modifiers, ZWNJ and the Hangul vowel/trailing jamo (approximation of the L/V/T rules).
+    if cat in ("Mn", "Me") or cp == 0x200C or 0x1F3FB <= cp <= 0x1F3FF or 0x1160 <= cp <= 0x11FF:
+        return EXTEND
+    if cat == "Mc":
+        return SPACING_MARK
+    if cat in ("Cc", "Zl", "Zp", "Cf"):
+        return CONTROL
+    return OTHER
+
+
+def width(cp, cat, gcb):
+    if gcb in (EXTEND, ZWJ) or (cat == "Cf" and cp != 0x00AD):
+        return 0
+    # Unassigned code points in the CJK planes are wide by default, others are
+    # narrow. `east_asian_width` reports all of them as "F".
+    if cat == "Cn":
+        return 2 if 0x20000 <= cp <= 0x3FFFD else 1
+    if unicodedata.east_asian_width(chr(cp)) in ("W", "F"):
+        return 2
+    return 1
+
+
+def main():
+    ext_pict = set()
+    for first, last in EXT_PICT_RANGES:
+        ext_pict.update(range(first, last + 1))
+
+    ranges = []
+    for cp in range(0x110000):
+        cat = unicodedata.category(chr(cp))
+        gcb = grapheme_class(cp, cat)
+        if cp in ext_pict and gcb == OTHER:
+            gcb = EXT_PICT
+        value = width(cp, cat, gcb) | gcb << 2
+        if ranges and ranges[-1][2] == value and ranges[-1][1] == cp - 1:
+            ranges[-1][1] = cp
+        else:
+            ranges.append([cp, cp, value])
+
+    default = 1 | OTHER << 2
+    ranges = [r for r in ranges if r[2] != default]
+
+    out = sys.stdout
+    out.write("/*******************************************************************************\n")
+    out.write(" * @file unicode_data.hpp\n")
+    out.write(" * @copyright Copyright 2022 Jan Waltl.\n")
+    out.write(" * @license	This file is released under ElTau project's license, see LICENSE.\n")
+    out.write(" *\n")
+    out.write(" * Generated by scripts/gen_unicode_data.py from Unicode %s, do not edit.\n" % unicodedata.unidata_version)
+    out.write(" ******************************************************************************/\n")
+    out.write("#pragma once\n\n#include <array>\n#include <cstdint>\n\n")
+    out.write("namespace eltau::utf8::detail {\n\n")
+    out.write("/*! Code point range sharing the same properties. */\n")
+    out.write("struct PropRange {\n    char32_t m_first;\n    char32_t m_last;\n")
+    out.write("    /*! Bits 0-1 width, bits 2-4 GraphemeClass. */\n    std::uint8_t m_props;\n};\n\n")
+    out.write("/*! Properties of code points not covered by c_prop_ranges - width 1, GraphemeClass::Other. */\n")
+    out.write("inline constexpr std::uint8_t c_default_props = %d;\n\n" % default)
+    out.write("/*! Sorted, non-overlapping ranges. */\n")
+    out.write("inline constexpr std::array<PropRange, %d> c_prop_ranges{{\n" % len(ranges))
+    line = "   "
+    for first, last, value in ranges:
+        item = " {0x%X, 0x%X, %d}," % (first, last, value)
+        if len(line) + len(item) > 120:
+            out.write(line + "\n")
+            line = "   "
+        line += item
+    out.write(line + "\n")
+    out.write("}};\n\n} // namespace eltau::utf8::detail\n")
+
+
+if __name__ == "__main__":
+    main()
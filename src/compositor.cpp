@@ -0,0 +1,243 @@
+/*******************************************************************************
+ * @file compositor.cpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+#include <algorithm>
+
+#include <fmt/format.h>
+
+#include <eltau/compositor.hpp>
+#include <eltau/exception.hpp>
+
+namespace eltau {
+
+Compositor::Compositor(Vec2 size) : m_screen{size} {
+    // Everything is blank at first.
+    m_pending.push_back({{0, 0}, size});
+}
+
+Compositor::LayerId
+Compositor::add_layer(std::unique_ptr<Element> root, Window area) {
+    if (!root)
+        throw EltauException{"Layer root must not be null."};
+
+    auto& layer = m_layers.emplace_back(Layer{.m_id = m_next_id, .m_root = std::move(root), .m_requested = area});
+    clip(layer);
+    layer.m_dirty = {{0, 0}, layer.m_area.size()};
+    add_pending(layer.m_area);
+    return m_next_id++;
+}
+
+std::unique_ptr<Element>
+Compositor::remove_layer(LayerId id) {
+    const auto idx = find(id);
+    auto root = std::move(m_layers[idx].m_root);
+    add_pending(m_layers[idx].m_area);
+    m_layers.erase(m_layers.begin() + static_cast<std::ptrdiff_t>(idx));
+    return root;
+}
+
+void
+Compositor::move_layer(LayerId id, Window area) {
+    auto& layer = m_layers[find(id)];
+    add_pending(layer.m_area);
+    layer.m_requested = area;
+    clip(layer);
+    add_pending(layer.m_area);
+}
+
+void
+Compositor::resize(Vec2 size) {
+    if (size == m_screen.size())
+        return;
+
+    m_screen.resize(size);
+    for (auto& layer : m_layers)
+        clip(layer);
+    // Everything is re-composed, the pending rectangles are covered by it.
+    m_pending.clear();
+    m_pending.push_back({{0, 0}, size});
+}
+
+void
+Compositor::raise_layer(LayerId id) {
+    const auto idx = find(id);
+    add_pending(m_layers[idx].m_area);
+    std::rotate(m_layers.begin() + static_cast<std::ptrdiff_t>(idx),
+                m_layers.begin() + static_cast<std::ptrdiff_t>(idx) + 1, m_layers.end());
+}
+
+void
+Compositor::invalidate(LayerId id) {
+    auto& layer = m_layers[find(id)];
+    layer.m_dirty = {{0, 0}, layer.m_area.size()};
+    add_pending(layer.m_area);
+}
+
+Window
+Compositor::area(LayerId id) const {
+    return m_layers[find(id)].m_area;
+}
+
+Element&
+Compositor::root(LayerId id) const {
+    return *m_layers[find(id)].m_root;
+}
+
+std::size_t
+Compositor::layer_count() const noexcept {
+    return m_layers.size();
+}
+
+const Screen&
+Compositor::compose() {
+    for (std::size_t i = 0; i < m_layers.size(); ++i) {
+        auto& layer = m_layers[i];
+        // Hidden layers stay dirty until exposed.
+        if (layer.m_dirty.empty() || covered(i, layer.m_area))
+            continue;
+
+        const auto size = layer.m_area.size();
+        blank(layer.m_screen);
+        layer.m_hits.mark({{0, 0}, size}, nullptr);
+        (void)layer.m_root->calc_pref_size(size);
+        DrawingWindow window{{{0, 0}, size}, layer.m_screen, m_arena.resource(), &layer.m_hits};
+        layer.m_root->draw(window);
+        layer.m_dirty = {{0, 0}, {}};
+        ++m_draw_count;
+    }
+    m_arena.reset();
+
+    m_damage.clear();
+    for (const auto& rect : m_pending) {
+        const auto clipped = rect.intersect({{0, 0}, m_screen.size()});
+        if (clipped.empty())
+            continue;
+        // E.g. a layer invalidated repeatedly, it is written out once.
+        if (std::any_of(m_damage.begin(), m_damage.end(),
+                        [&](const Window& done) { return done.intersect(clipped) == clipped; }))
+            continue;
+        blit(clipped);
+        m_damage.push_back(clipped);
+    }
+    m_pending.clear();
+    return m_screen;
+}
+
+Element*
+Compositor::hit_test(Vec2 pos) const noexcept {
+    // Layers are opaque, the top-most one under pos decides.
+    for (auto it = m_layers.rbegin(); it != m_layers.rend(); ++it) {
+        if (it->m_area.is_inside(pos))
+            return it->m_hits.at(pos - it->m_area.origin());
+    }
+    return nullptr;
+}
+
+std::span<const Window>
+Compositor::damage() const noexcept {
+    return m_damage;
+}
+
+const Screen&
+Compositor::screen() const noexcept {
+    return m_screen;
+}
+
+std::size_t
+Compositor::draw_count() const noexcept {
+    return m_draw_count;
+}
+
+const FrameArena&
+Compositor::arena() const noexcept {
+    return m_arena;
+}
+
+std::size_t
+Compositor::find(LayerId id) const {
+    const auto it = std::find_if(m_layers.begin(), m_layers.end(), [&](const Layer& l) { return l.m_id == id; });
+    if (it == m_layers.end())
+        throw EltauException{fmt::format("Unknown layer {}", id)};
+    return static_cast<std::size_t>(it - m_layers.begin());
+}
+
+void
+Compositor::clip(Layer& layer) {
+    const auto area = layer.m_requested.intersect({{0, 0}, m_screen.size()});
+    if (area.size() != layer.m_area.size()) {
+        layer.m_screen.resize(area.size());
+        layer.m_hits.resize(area.size());
+        layer.m_dirty = {{0, 0}, area.size()};
+    }
+    layer.m_area = area;
+}
+
+void
+Compositor::add_pending(const Window& rect) {
+    if (rect.empty() || std::any_of(m_pending.begin(), m_pending.end(),
+                                    [&](const Window& pending) { return pending.intersect(rect) == rect; }))
+        return;
+    if (m_pending.size() >= c_max_pending) {
+        m_pending.clear();
+        m_pending.push_back({{0, 0}, m_screen.size()});
+        return;
+    }
+    m_pending.push_back(rect);
+}
+
+bool
+Compositor::covered(std::size_t idx, const Window& rect) {
+    for (auto row = rect.origin().m_row; row < rect.end().m_row; ++row) {
+        m_uncovered.assign(1, {rect.origin().m_col, rect.end().m_col});
+        for (auto i = idx + 1; i < m_layers.size() && !m_uncovered.empty(); ++i)
+            cover(m_layers[i].m_area, row, nullptr);
+        if (!m_uncovered.empty())
+            return false;
+    }
+    return true;
+}
+
+void
+Compositor::blit(const Window& rect) {
+    for (auto row = rect.origin().m_row; row < rect.end().m_row; ++row) {
+        m_uncovered.assign(1, {rect.origin().m_col, rect.end().m_col});
+        // Top-down, each column is taken from the first layer covering it.
+        for (auto i = m_layers.size(); i-- > 0 && !m_uncovered.empty();)
+            cover(m_layers[i].m_area, row, &m_layers[i]);
+
+        const auto line = m_screen.line(row);
+        for (const auto& [begin, end] : m_uncovered)
+            blank(line.subspan(begin, end - begin));
+    }
+}
+
+void
+Compositor::cover(const Window& area, std::size_t row, const Layer* layer) {
+    if (area.empty() || row < area.origin().m_row || row >= area.end().m_row)
+        return;
+
+    const auto begin = area.origin().m_col;
+    const auto end = area.end().m_col;
+    m_next.clear();
+    for (const auto& [first, last] : m_uncovered) {
+        const auto from = std::max(first, begin);
+        const auto to = std::min(last, end);
+        if (from >= to) {
+            m_next.emplace_back(first, last);
+            continue;
+        }
+        if (layer != nullptr) {
+            const auto src = layer->m_screen.line(row - area.origin().m_row).subspan(from - begin, to - from);
+            std::copy(src.begin(), src.end(), m_screen.line(row).begin() + static_cast<std::ptrdiff_t>(from));
+        }
+        if (first < from)
+            m_next.emplace_back(first, from);
+        if (to < last)
+            m_next.emplace_back(to, last);
+    }
+    std::swap(m_uncovered, m_next);
+}
+
+} // namespace eltau
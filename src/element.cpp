@@ -4,27 +4,95 @@
  * @license	This file is released under ElTau project's license, see LICENSE.
  ******************************************************************************/
 #include <cassert>
+#include <cstddef>
 
 #include <eltau/element.hpp>
 
 namespace eltau {
+namespace {
+/*******************************************************************************
+ * @brief Origin of an allocated element, stored right before it.
+ ******************************************************************************/
+struct AllocHeader {
+    std::pmr::memory_resource* m_resource;
+    std::size_t m_bytes;
+};
+
+/*! Keeps the elements max-aligned. */
+constexpr std::size_t c_header_bytes = (sizeof(AllocHeader) + alignof(std::max_align_t) - 1) /
+                                       alignof(std::max_align_t) * alignof(std::max_align_t);
+
+/*******************************************************************************
+ * @brief Header of the element at @p ptr.
+ ******************************************************************************/
+AllocHeader*
+header(void* ptr) noexcept {
+    return reinterpret_cast<AllocHeader*>(static_cast<std::byte*>(ptr) - c_header_bytes);
+}
+} // namespace
 
 Vec2
 Element::calc_pref_size(Vec2 max_size) {
-    // Only calc size for feasible bounds.
-    if (max_size.m_col == 0 || max_size.m_row == 0)
-        return m_last_pref_size = {0, 0};
+    if (!begin_calc_pref_size(max_size))
+        return m_last_pref_size;
     return m_last_pref_size = this->do_calc_pref_size(max_size);
 }
 
 void
 Element::draw(DrawingWindow& window) {
+    if (begin_draw(window))
+        this->do_draw(window);
+}
+
+bool
+Element::begin_calc_pref_size(Vec2 max_size) noexcept {
+    // Only calc size for feasible bounds.
+    if (max_size.m_col > 0 && max_size.m_row > 0)
+        return true;
+    m_last_pref_size = {0, 0};
+    return false;
+}
 
-    return this->do_draw(window);
+bool
+Element::begin_draw(DrawingWindow& window) {
+    // Culled, nothing would be seen.
+    const auto visible = window.visible();
+    if (visible.empty())
+        return false;
+    // Children drawn afterwards overwrite their parts.
+    if (auto* hits = window.hit_map())
+        hits->mark(visible, this);
+    return true;
 }
 
 Vec2
 Element::get_last_pref_size() const noexcept {
     return m_last_pref_size;
 }
+
+void*
+Element::operator new(std::size_t size) {
+    return operator new(size, std::pmr::get_default_resource());
+}
+
+void*
+Element::operator new(std::size_t size, std::pmr::memory_resource* resource) {
+    const auto bytes = c_header_bytes + size;
+    auto* block = static_cast<std::byte*>(resource->allocate(bytes, alignof(std::max_align_t)));
+    ::new (block) AllocHeader{.m_resource = resource, .m_bytes = bytes};
+    return block + c_header_bytes;
+}
+
+void
+Element::operator delete(void* ptr) noexcept {
+    if (ptr == nullptr)
+        return;
+    auto* h = header(ptr);
+    h->m_resource->deallocate(h, h->m_bytes, alignof(std::max_align_t));
+}
+
+void
+Element::operator delete(void* ptr, std::pmr::memory_resource* /*resource*/) noexcept {
+    operator delete(ptr);
+}
 } // namespace eltau
@@ -0,0 +1,309 @@
+/*******************************************************************************
+ * @file event_loop.cpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+#include <array>
+#include <cerrno>
+#include <cstdint>
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include <eltau/event_loop.hpp>
+#include <eltau/exception.hpp>
+
+namespace eltau {
+namespace {
+/*! Maximum events dispatched in one batch. */
+constexpr std::size_t c_batch = 16;
+/*! Size of one read of the input. */
+constexpr std::size_t c_input_chunk = 4096;
+
+/*******************************************************************************
+ * @brief Convert to timerfd's time.
+ ******************************************************************************/
+timespec
+to_timespec(std::chrono::nanoseconds time) noexcept {
+    const auto secs = std::chrono::duration_cast<std::chrono::seconds>(time);
+    return {.tv_sec = static_cast<time_t>(secs.count()), .tv_nsec = static_cast<long>((time - secs).count())};
+}
+
+/*******************************************************************************
+ * @brief Signals handled by the loop.
+ ******************************************************************************/
+sigset_t
+handled_signals() noexcept {
+    sigset_t set;
+    (void)sigemptyset(&set);
+    (void)sigaddset(&set, SIGWINCH);
+    (void)sigaddset(&set, SIGTERM);
+    return set;
+}
+} // namespace
+
+EventLoop::EventLoop(int input_fd) {
+    try {
+        m_epoll = epoll_create1(EPOLL_CLOEXEC);
+        if (m_epoll == -1)
+            throw EltauException::from_errno("Cannot create epoll");
+
+        m_wakeup = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (m_wakeup == -1)
+            throw EltauException::from_errno("Cannot create eventfd");
+        watch(m_wakeup);
+
+        const auto signals = handled_signals();
+        if (const auto err = pthread_sigmask(SIG_BLOCK, &signals, &m_old_mask); err != 0) {
+            errno = err;
+            throw EltauException::from_errno("Cannot block signals");
+        }
+        m_signals = signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC);
+        if (m_signals == -1)
+            throw EltauException::from_errno("Cannot create signalfd");
+        watch(m_signals);
+
+        if (input_fd >= 0) {
+            m_input_flags = fcntl(input_fd, F_GETFL);
+            if (m_input_flags == -1 || fcntl(input_fd, F_SETFL, m_input_flags | O_NONBLOCK) == -1)
+                throw EltauException::from_errno("Cannot make the input non-blocking");
+            m_input = input_fd;
+            watch(m_input);
+        }
+    } catch (...) {
+        release();
+        throw;
+    }
+}
+
+EventLoop::~EventLoop() noexcept {
+    release();
+}
+
+void
+EventLoop::on_input(InputHandler handler) {
+    m_on_input = std::move(handler);
+}
+
+void
+EventLoop::on_resize(Callback handler) {
+    m_on_resize = std::move(handler);
+}
+
+void
+EventLoop::on_render(Callback handler) {
+    m_on_render = std::move(handler);
+}
+
+EventLoop::TimerId
+EventLoop::add_timer(std::chrono::nanoseconds delay, std::chrono::nanoseconds interval, Callback handler) {
+    const auto fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (fd == -1)
+        throw EltauException::from_errno("Cannot create timerfd");
+
+    // Zero would disarm the timer.
+    const itimerspec spec{.it_interval = to_timespec(interval),
+                          .it_value = to_timespec(std::max(delay, std::chrono::nanoseconds{1}))};
+    try {
+        if (timerfd_settime(fd, 0, &spec, nullptr) == -1)
+            throw EltauException::from_errno("Cannot arm timerfd");
+        watch(fd);
+        m_timers[fd] = {.m_handler = std::move(handler), .m_repeat = interval.count() > 0};
+    } catch (...) {
+        (void)close(fd);
+        throw;
+    }
+    return fd;
+}
+
+void
+EventLoop::cancel_timer(TimerId id) noexcept {
+    if (m_timers.erase(id) == 0)
+        return;
+    // Closing removes it from the epoll set as well.
+    (void)close(id);
+}
+
+void
+EventLoop::add_reader(int fd, Callback handler) {
+    watch(fd);
+    m_readers[fd] = std::move(handler);
+}
+
+void
+EventLoop::remove_reader(int fd) noexcept {
+    if (m_readers.erase(fd) == 0)
+        return;
+    m_writers.erase(fd);
+    (void)epoll_ctl(m_epoll, EPOLL_CTL_DEL, fd, nullptr);
+}
+
+void
+EventLoop::set_writer(int fd, Callback handler) {
+    if (!m_readers.contains(fd))
+        throw EltauException{"Only readers can be watched for writing."};
+
+    const auto writing = static_cast<bool>(handler);
+    if (writing == m_writers.contains(fd)) {
+        if (writing)
+            m_writers[fd] = std::move(handler);
+        return;
+    }
+    epoll_event event{.events = EPOLLIN | (writing ? EPOLLOUT : 0U), .data = {.fd = fd}};
+    if (epoll_ctl(m_epoll, EPOLL_CTL_MOD, fd, &event) == -1)
+        throw EltauException::from_errno("Cannot watch a descriptor");
+    if (writing) {
+        m_writers[fd] = std::move(handler);
+    } else {
+        m_writers.erase(fd);
+    }
+}
+
+void
+EventLoop::request_redraw() noexcept {
+    m_redraw.store(true, std::memory_order_relaxed);
+    const std::uint64_t one = 1;
+    (void)write(m_wakeup, &one, sizeof(one));
+}
+
+void
+EventLoop::stop() noexcept {
+    m_stopped.store(true, std::memory_order_relaxed);
+    const std::uint64_t one = 1;
+    (void)write(m_wakeup, &one, sizeof(one));
+}
+
+bool
+EventLoop::stopped() const noexcept {
+    return m_stopped.load(std::memory_order_relaxed);
+}
+
+void
+EventLoop::run() {
+    while (!stopped())
+        (void)poll(std::chrono::milliseconds{-1});
+}
+
+std::size_t
+EventLoop::poll(std::chrono::milliseconds timeout) {
+    std::array<epoll_event, c_batch> events{};
+    const auto count = epoll_wait(m_epoll, events.data(), static_cast<int>(events.size()), static_cast<int>(timeout.count()));
+    if (count == -1) {
+        if (errno == EINTR)
+            return 0;
+        throw EltauException::from_errno("Cannot wait for events");
+    }
+
+    for (std::size_t i = 0; i < static_cast<std::size_t>(count); ++i) {
+        const auto fd = events[i].data.fd;
+        if (fd == m_input) {
+            read_input();
+        } else if (fd == m_signals) {
+            read_signals();
+        } else if (fd == m_wakeup) {
+            std::uint64_t value = 0;
+            (void)read(m_wakeup, &value, sizeof(value));
+        } else if (m_readers.contains(fd)) {
+            // The handlers may remove themselves, or each other.
+            if (const auto it = m_writers.find(fd); it != m_writers.end() && (events[i].events & EPOLLOUT) != 0) {
+                const auto handler = it->second;
+                handler();
+            }
+            if (const auto it = m_readers.find(fd); it != m_readers.end() && (events[i].events & ~EPOLLOUT) != 0) {
+                const auto handler = it->second;
+                handler();
+            }
+        } else {
+            expire(fd);
+        }
+    }
+
+    // All the events of the batch are rendered at once.
+    if (m_redraw.exchange(false, std::memory_order_relaxed) && m_on_render)
+        m_on_render();
+    return static_cast<std::size_t>(count);
+}
+
+void
+EventLoop::release() noexcept {
+    for (const auto& [fd, timer] : m_timers)
+        (void)close(fd);
+    m_timers.clear();
+    m_readers.clear();
+    m_writers.clear();
+
+    if (m_input >= 0)
+        (void)fcntl(m_input, F_SETFL, m_input_flags);
+    if (m_signals >= 0) {
+        (void)close(m_signals);
+        (void)pthread_sigmask(SIG_SETMASK, &m_old_mask, nullptr);
+    }
+    if (m_wakeup >= 0)
+        (void)close(m_wakeup);
+    if (m_epoll >= 0)
+        (void)close(m_epoll);
+}
+
+void
+EventLoop::watch(int fd) const {
+    epoll_event event{.events = EPOLLIN, .data = {.fd = fd}};
+    if (epoll_ctl(m_epoll, EPOLL_CTL_ADD, fd, &event) == -1)
+        throw EltauException::from_errno("Cannot watch a descriptor");
+}
+
+void
+EventLoop::read_input() {
+    std::array<char, c_input_chunk> buffer{};
+    while (true) {
+        const auto len = read(m_input, buffer.data(), buffer.size());
+        if (len > 0) {
+            if (m_on_input)
+                m_on_input({buffer.data(), static_cast<std::size_t>(len)});
+            continue;
+        }
+        if (len == -1 && errno == EINTR)
+            continue;
+        if (len == 0 || errno != EAGAIN) {
+            // Closed or broken input, stop watching it.
+            (void)epoll_ctl(m_epoll, EPOLL_CTL_DEL, m_input, nullptr);
+        }
+        return;
+    }
+}
+
+void
+EventLoop::read_signals() {
+    signalfd_siginfo info{};
+    while (read(m_signals, &info, sizeof(info)) == static_cast<ssize_t>(sizeof(info))) {
+        if (info.ssi_signo == SIGTERM) {
+            stop();
+        } else if (info.ssi_signo == SIGWINCH) {
+            if (m_on_resize)
+                m_on_resize();
+            m_redraw.store(true, std::memory_order_relaxed);
+        }
+    }
+}
+
+void
+EventLoop::expire(int fd) {
+    const auto it = m_timers.find(fd);
+    std::uint64_t expirations = 0;
+    // Cancelled earlier in the batch or not expired yet.
+    if (it == m_timers.end() || read(fd, &expirations, sizeof(expirations)) != sizeof(expirations))
+        return;
+
+    // The handler may cancel the timer.
+    auto handler = it->second.m_repeat ? it->second.m_handler : std::move(it->second.m_handler);
+    if (!it->second.m_repeat)
+        cancel_timer(fd);
+    if (handler)
+        handler();
+}
+
+} // namespace eltau
@@ -0,0 +1,144 @@
+/*******************************************************************************
+ * @file flat_tree.cpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+#include <algorithm>
+
+#include <eltau/exception.hpp>
+#include <eltau/flat_tree.hpp>
+
+namespace eltau {
+
+FlatTree::FlatTree(std::allocator_arg_t, std::pmr::polymorphic_allocator<> alloc) :
+    m_nodes(alloc), m_open(alloc), m_elems(alloc) {}
+
+FlatTree::NodeId
+FlatTree::open(Kind kind) {
+    if (kind == Kind::Leaf)
+        throw EltauException{"Only stacks can be opened."};
+
+    const auto id = static_cast<NodeId>(m_nodes.size());
+    m_nodes.push_back({.m_kind = kind});
+    m_open.push_back(id);
+    return id;
+}
+
+void
+FlatTree::close() {
+    if (m_open.empty())
+        throw EltauException{"There is no open stack to close."};
+
+    m_nodes[m_open.back()].m_end = static_cast<NodeId>(m_nodes.size());
+    m_open.pop_back();
+}
+
+FlatTree::NodeId
+FlatTree::add(std::unique_ptr<Element> elem) {
+    if (!elem)
+        throw EltauException{"Leaf element must not be null."};
+
+    const auto id = static_cast<NodeId>(m_nodes.size());
+    m_nodes.push_back({.m_elem = elem.get(), .m_end = id + 1, .m_kind = Kind::Leaf});
+    m_elems.push_back(std::move(elem));
+    return id;
+}
+
+std::size_t
+FlatTree::size() const noexcept {
+    return m_nodes.size();
+}
+
+Element*
+FlatTree::element(NodeId id) const noexcept {
+    return id < m_nodes.size() ? m_nodes[id].m_elem : nullptr;
+}
+
+Window
+FlatTree::placement(NodeId id) const noexcept {
+    if (id >= m_nodes.size() || m_nodes[id].m_frame != m_frame)
+        return {{}, {}};
+    return {m_nodes[id].m_origin, m_nodes[id].m_size};
+}
+
+Vec2
+FlatTree::do_calc_pref_size(Vec2 max_size) {
+    if (!m_open.empty())
+        throw EltauException{"All stacks must be closed before the layout."};
+
+    // Children follow their parent, so they are measured first.
+    for (auto i = m_nodes.size(); i-- > 0;) {
+        auto& node = m_nodes[i];
+        if (node.m_kind == Kind::Leaf)
+            node.m_pref = node.m_elem->calc_pref_size(max_size);
+        else
+            node.m_pref = min(stack(static_cast<NodeId>(i + 1), node.m_end, node.m_kind), max_size);
+    }
+    return min(stack(0, static_cast<NodeId>(m_nodes.size()), Kind::VStack), max_size);
+}
+
+void
+FlatTree::do_draw(DrawingWindow& window) {
+    if (!m_open.empty())
+        throw EltauException{"All stacks must be closed before the layout."};
+
+    const auto origin{window.origin()};
+    const auto visible{window.visible()};
+    ++m_frame;
+    place(0, static_cast<NodeId>(m_nodes.size()), Kind::VStack, origin, window.size());
+    // Parents precede their children, so each node is placed before it is visited.
+    for (NodeId i = 0; i < m_nodes.size();) {
+        const auto& node = m_nodes[i];
+        if (Window{node.m_origin, node.m_size}.intersect(visible).empty()) {
+            // Culled, together with the subtree.
+            i = node.m_end;
+            continue;
+        }
+        if (node.m_kind != Kind::Leaf) {
+            place(i + 1, node.m_end, node.m_kind, node.m_origin, node.m_size);
+        } else {
+            auto sub = window.sub_win(node.m_origin - origin, node.m_size);
+            node.m_elem->draw(sub);
+        }
+        ++i;
+    }
+}
+
+Vec2
+FlatTree::stack(NodeId first, NodeId last, Kind kind) const noexcept {
+    Vec2 size{};
+    for (auto i = first; i < last; i = m_nodes[i].m_end) {
+        const auto& pref = m_nodes[i].m_pref;
+        if (kind == Kind::HStack) {
+            size.m_col += pref.m_col;
+            size.m_row = std::max(size.m_row, pref.m_row);
+        } else {
+            size.m_row += pref.m_row;
+            size.m_col = std::max(size.m_col, pref.m_col);
+        }
+    }
+    return size;
+}
+
+void
+FlatTree::place(NodeId first, NodeId last, Kind kind, Vec2 origin, Vec2 size) noexcept {
+    // Remaining area, children take what they prefer along the main axis and all
+    // of the cross axis.
+    for (auto i = first; i < last; i = m_nodes[i].m_end) {
+        auto& node = m_nodes[i];
+        node.m_origin = origin;
+        node.m_size = size;
+        node.m_frame = m_frame;
+        if (kind == Kind::HStack) {
+            node.m_size.m_col = std::min(node.m_pref.m_col, size.m_col);
+            origin.m_col += node.m_size.m_col;
+            size.m_col -= node.m_size.m_col;
+        } else {
+            node.m_size.m_row = std::min(node.m_pref.m_row, size.m_row);
+            origin.m_row += node.m_size.m_row;
+            size.m_row -= node.m_size.m_row;
+        }
+    }
+}
+
+} // namespace eltau
@@ -0,0 +1,208 @@
+/*******************************************************************************
+ * @file flex.cpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+
+#include <fmt/format.h>
+
+#include <eltau/exception.hpp>
+#include <eltau/flex.hpp>
+
+namespace eltau {
+
+FlexSolver::FlexSolver(std::pmr::polymorphic_allocator<> alloc) : m_prefs(alloc), m_sizes(alloc) {}
+
+std::span<const std::size_t>
+FlexSolver::solve(std::size_t available, std::span<const FlexItem> items, std::span<const std::size_t> prefs) {
+    assert(items.size() == prefs.size());
+
+    if (m_valid && available == m_available && std::equal(prefs.begin(), prefs.end(), m_prefs.begin(), m_prefs.end()))
+        return m_sizes;
+
+    ++m_solve_count;
+    m_available = available;
+    m_prefs.assign(prefs.begin(), prefs.end());
+    m_sizes.resize(items.size());
+
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < items.size(); ++i) {
+        m_sizes[i] = std::min(std::max(prefs[i], items[i].m_min), items[i].m_max);
+        total += m_sizes[i];
+    }
+    if (total < available)
+        distribute(items, available - total, true);
+    else if (total > available)
+        distribute(items, total - available, false);
+
+    m_valid = true;
+    return m_sizes;
+}
+
+void
+FlexSolver::invalidate() noexcept {
+    m_valid = false;
+}
+
+std::size_t
+FlexSolver::solve_count() const noexcept {
+    return m_solve_count;
+}
+
+void
+FlexSolver::distribute(std::span<const FlexItem> items, std::size_t amount, bool grow) noexcept {
+    // How much can the item still change.
+    const auto room = [&](std::size_t i) -> std::size_t {
+        if (items[i].m_weight == 0)
+            return 0;
+        if (grow)
+            return items[i].m_max - m_sizes[i];
+        return m_sizes[i] > items[i].m_min ? m_sizes[i] - items[i].m_min : 0;
+    };
+    const auto apply = [&](std::size_t i, std::size_t delta) {
+        if (grow)
+            m_sizes[i] += delta;
+        else
+            m_sizes[i] -= delta;
+    };
+
+    // Each pass either distributes everything or saturates an item.
+    while (amount > 0) {
+        std::size_t total_weight = 0;
+        for (std::size_t i = 0; i < items.size(); ++i)
+            if (room(i) > 0)
+                total_weight += items[i].m_weight;
+        if (total_weight == 0)
+            return;
+
+        std::size_t moved = 0;
+        for (std::size_t i = 0; i < items.size(); ++i) {
+            if (const auto r = room(i); r > 0) {
+                const auto delta = std::min(amount * items[i].m_weight / total_weight, r);
+                apply(i, delta);
+                moved += delta;
+            }
+        }
+        if (moved == 0) {
+            // All shares were rounded down, hand out the remainder in order.
+            for (std::size_t i = 0; i < items.size() && amount > 0; ++i) {
+                if (room(i) > 0) {
+                    apply(i, 1);
+                    --amount;
+                }
+            }
+        }
+        amount -= moved;
+    }
+}
+
+FlexContainer::FlexContainer(Direction direction, Align justify) noexcept :
+    m_direction(direction), m_justify(justify) {}
+
+FlexContainer::FlexContainer(std::allocator_arg_t, std::pmr::polymorphic_allocator<> alloc, Direction direction,
+                             Align justify) :
+    m_direction(direction), m_justify(justify), m_children(alloc), m_items(alloc), m_prefs(alloc), m_solver(alloc) {}
+
+std::size_t
+FlexContainer::add(std::unique_ptr<Element> elem, FlexItem item) {
+    if (!elem)
+        throw EltauException{"Flex child must not be null."};
+
+    m_children.push_back(std::move(elem));
+    m_items.push_back(item);
+    m_solver.invalidate();
+    return m_children.size() - 1;
+}
+
+void
+FlexContainer::set_item(std::size_t idx, FlexItem item) {
+    if (idx >= m_items.size())
+        throw EltauException{fmt::format("Flex child {} is out of range of {} children", idx, m_items.size())};
+
+    if (m_items[idx] != item) {
+        m_items[idx] = item;
+        m_solver.invalidate();
+    }
+}
+
+std::size_t
+FlexContainer::size() const noexcept {
+    return m_children.size();
+}
+
+Element*
+FlexContainer::child(std::size_t idx) const noexcept {
+    return idx < m_children.size() ? m_children[idx].get() : nullptr;
+}
+
+const FlexSolver&
+FlexContainer::solver() const noexcept {
+    return m_solver;
+}
+
+Vec2
+FlexContainer::do_calc_pref_size(Vec2 max_size) {
+    m_prefs.resize(m_children.size());
+
+    Vec2 size{};
+    for (std::size_t i = 0; i < m_children.size(); ++i) {
+        auto pref = m_children[i]->calc_pref_size(max_size);
+        m_prefs[i] = main(pref);
+        main(size) += std::min(std::max(m_prefs[i], m_items[i].m_min), m_items[i].m_max);
+        cross(size) = std::max(cross(size), cross(pref));
+    }
+    return min(size, max_size);
+}
+
+void
+FlexContainer::do_draw(DrawingWindow& window) {
+    // Not measured yet.
+    m_prefs.resize(m_children.size());
+
+    auto win_size{window.size()};
+    const auto available = main(win_size);
+    const auto sizes = m_solver.solve(available, m_items, m_prefs);
+
+    const auto total = std::accumulate(sizes.begin(), sizes.end(), std::size_t{0});
+    const auto free = available > total ? available - total : 0;
+    Vec2 offset{};
+    if (m_justify == Align::Center)
+        main(offset) = free / 2;
+    else if (m_justify == Align::End)
+        main(offset) = free;
+
+    for (std::size_t i = 0; i < m_children.size() && main(offset) < available; ++i) {
+        auto pref{m_children[i]->get_last_pref_size()};
+        Vec2 size{};
+        main(size) = std::min(sizes[i], available - main(offset));
+        cross(size) = m_items[i].m_align == Align::Stretch ? cross(win_size) : std::min(cross(pref), cross(win_size));
+
+        auto child_offset{offset};
+        const auto cross_free = cross(win_size) - cross(size);
+        if (m_items[i].m_align == Align::Center)
+            cross(child_offset) = cross_free / 2;
+        else if (m_items[i].m_align == Align::End)
+            cross(child_offset) = cross_free;
+
+        main(offset) += main(size);
+        if (size.m_row == 0 || size.m_col == 0)
+            continue;
+        auto sub = window.sub_win(child_offset, size);
+        m_children[i]->draw(sub);
+    }
+}
+
+std::size_t&
+FlexContainer::main(Vec2& v) const noexcept {
+    return m_direction == Direction::Horizontal ? v.m_col : v.m_row;
+}
+
+std::size_t&
+FlexContainer::cross(Vec2& v) const noexcept {
+    return m_direction == Direction::Horizontal ? v.m_row : v.m_col;
+}
+
+} // namespace eltau
@@ -0,0 +1,44 @@
+/*******************************************************************************
+ * @file hit_map.cpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+#include <algorithm>
+
+#include <eltau/hit_map.hpp>
+
+namespace eltau {
+
+HitMap::HitMap(Vec2 size, std::pmr::memory_resource* resource) :
+    m_size{size}, m_cells{size.m_row * size.m_col, nullptr, resource} {}
+
+Vec2
+HitMap::size() const noexcept {
+    return m_size;
+}
+
+void
+HitMap::resize(Vec2 size) {
+    m_cells.assign(size.m_row * size.m_col, nullptr);
+    m_size = size;
+}
+
+void
+HitMap::mark(const Window& rect, Element* elem) noexcept {
+    const auto clipped = rect.intersect({{0, 0}, m_size});
+    if (clipped.empty())
+        return;
+    for (auto row = clipped.origin().m_row; row < clipped.end().m_row; ++row) {
+        auto begin = m_cells.begin() + static_cast<std::ptrdiff_t>(row * m_size.m_col + clipped.origin().m_col);
+        std::fill_n(begin, clipped.size().m_col, elem);
+    }
+}
+
+Element*
+HitMap::at(Vec2 pos) const noexcept {
+    if (!Window{{0, 0}, m_size}.is_inside(pos))
+        return nullptr;
+    return m_cells[pos.m_row * m_size.m_col + pos.m_col];
+}
+
+} // namespace eltau
@@ -0,0 +1,371 @@
+/*******************************************************************************
+ * @file input.cpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+#include <algorithm>
+
+#include <eltau/input.hpp>
+#include <eltau/utf8.hpp>
+
+namespace eltau {
+namespace {
+constexpr char c_esc = '\033';
+/*! Terminator of a bracketed paste. */
+constexpr std::string_view c_paste_end = "\033[201~";
+/*! CSI parameters starting and ending a bracketed paste. */
+constexpr std::uint32_t c_paste_begin_param = 200;
+constexpr std::uint32_t c_paste_end_param = 201;
+/*! Parameters are clamped, only small ones are meaningful. */
+constexpr std::uint32_t c_max_param = 0xFFFF;
+constexpr std::size_t c_ascii = 0x80;
+
+using KeyTable = std::array<Key, c_ascii>;
+
+/*! Keys of CSI sequences by their final byte, e.g. ESC [ A. */
+constexpr KeyTable c_csi_keys = [] {
+    KeyTable keys{};
+    keys['A'] = Key::Up;
+    keys['B'] = Key::Down;
+    keys['C'] = Key::Right;
+    keys['D'] = Key::Left;
+    keys['H'] = Key::Home;
+    keys['F'] = Key::End;
+    keys['P'] = Key::F1;
+    keys['Q'] = Key::F2;
+    keys['R'] = Key::F3;
+    keys['S'] = Key::F4;
+    keys['Z'] = Key::Tab;
+    return keys;
+}();
+
+/*! Keys of SS3 sequences by their final byte, e.g. ESC O P. */
+constexpr KeyTable c_ss3_keys = [] {
+    KeyTable keys = c_csi_keys;
+    keys['Z'] = Key::None;
+    keys['M'] = Key::Enter;
+    return keys;
+}();
+
+/*! Keys of ESC [ n ~ sequences by n. */
+constexpr std::array<Key, 25> c_tilde_keys = [] {
+    std::array<Key, 25> keys{};
+    keys[1] = Key::Home;
+    keys[2] = Key::Insert;
+    keys[3] = Key::Delete;
+    keys[4] = Key::End;
+    keys[5] = Key::PageUp;
+    keys[6] = Key::PageDown;
+    keys[7] = Key::Home;
+    keys[8] = Key::End;
+    keys[11] = Key::F1;
+    keys[12] = Key::F2;
+    keys[13] = Key::F3;
+    keys[14] = Key::F4;
+    keys[15] = Key::F5;
+    keys[17] = Key::F6;
+    keys[18] = Key::F7;
+    keys[19] = Key::F8;
+    keys[20] = Key::F9;
+    keys[21] = Key::F10;
+    keys[23] = Key::F11;
+    keys[24] = Key::F12;
+    return keys;
+}();
+
+/*******************************************************************************
+ * @brief Modifiers encoded in a CSI parameter as 1 + flags.
+ ******************************************************************************/
+constexpr std::uint8_t
+param_mods(std::uint32_t param) noexcept {
+    return param < 2 ? 0 : static_cast<std::uint8_t>((param - 1) & (Shift | Alt | Ctrl));
+}
+
+/*******************************************************************************
+ * @brief Length of a UTF-8 sequence starting with @p lead, 0 if invalid.
+ ******************************************************************************/
+constexpr std::uint8_t
+utf8_length(unsigned char lead) noexcept {
+    if ((lead & 0xE0U) == 0xC0U)
+        return 2;
+    if ((lead & 0xF0U) == 0xE0U)
+        return 3;
+    if ((lead & 0xF8U) == 0xF0U)
+        return 4;
+    return 0;
+}
+} // namespace
+
+InputDecoder::InputDecoder(std::chrono::milliseconds escape_timeout) noexcept : m_escape_timeout(escape_timeout) {}
+
+std::size_t
+InputDecoder::feed(std::string_view bytes, Clock::time_point now) noexcept {
+    // An ESC left from a previous read that has timed out meanwhile.
+    (void)expire(now);
+
+    std::size_t pos = 0;
+    // Every step queues at most one event.
+    while (pos < bytes.size() && m_count < c_queue_size) {
+        if (m_state == State::Paste) {
+            paste(bytes, pos);
+            continue;
+        }
+
+        const char byte = bytes[pos];
+        const auto ubyte = static_cast<unsigned char>(byte);
+        switch (m_state) {
+        case State::Ground:
+            if (byte == c_esc) {
+                m_state = State::Escape;
+                m_escape_time = now;
+            } else {
+                ground(byte, 0);
+            }
+            break;
+        case State::Utf8:
+            if ((ubyte & 0xC0U) != 0x80U) {
+                // Truncated character, the byte is decoded again.
+                push_key(Key::Char, 0, utf8::c_replacement);
+                m_state = State::Ground;
+                continue;
+            }
+            m_utf8[m_utf8_len++] = byte;
+            if (m_utf8_len == m_utf8_need) {
+                std::size_t offset = 0;
+                push_key(Key::Char, 0, utf8::decode({m_utf8.data(), m_utf8_len}, offset));
+                m_state = State::Ground;
+            }
+            break;
+        case State::Escape:
+            if (byte == '[') {
+                m_state = State::Csi;
+                m_params.fill(0);
+                m_param_count = 1;
+                m_sub_param = false;
+                m_marker = 0;
+            } else if (byte == 'O') {
+                m_state = State::Ss3;
+            } else if (byte == c_esc) {
+                push_key(Key::Escape, 0);
+                m_escape_time = now;
+            } else if (ubyte >= c_ascii) {
+                // Alt is not combined with non-ASCII, the byte is decoded again.
+                push_key(Key::Escape, 0);
+                m_state = State::Ground;
+                continue;
+            } else {
+                m_state = State::Ground;
+                ground(byte, Alt);
+            }
+            break;
+        case State::Csi:
+            if (byte >= '0' && byte <= '9') {
+                if (m_param_count <= c_max_params && !m_sub_param) {
+                    auto& param = m_params[m_param_count - 1];
+                    param = std::min(param * 10 + static_cast<std::uint32_t>(byte - '0'), c_max_param);
+                }
+            } else if (byte == ';') {
+                m_param_count = static_cast<std::uint8_t>(std::min<std::size_t>(m_param_count + 1, c_max_params + 1));
+                m_sub_param = false;
+            } else if (byte == ':') {
+                // E.g. the event type of kitty's keyboard protocol.
+                m_sub_param = true;
+            } else if (byte >= '<' && byte <= '?') {
+                m_marker = byte;
+            } else if (byte >= '@' && byte <= '~') {
+                m_state = State::Ground;
+                csi(byte);
+            } else if (byte < ' ' || ubyte >= c_ascii) {
+                // Malformed sequence, dropped and the byte is decoded again.
+                m_state = State::Ground;
+                continue;
+            }
+            // Intermediate bytes are ignored.
+            break;
+        case State::Ss3:
+            m_state = State::Ground;
+            if (ubyte < c_ascii && c_ss3_keys[ubyte] != Key::None)
+                push_key(c_ss3_keys[ubyte], 0);
+            break;
+        case State::Paste:
+            break;
+        }
+        ++pos;
+    }
+    return pos;
+}
+
+bool
+InputDecoder::expire(Clock::time_point now) noexcept {
+    if (m_state != State::Escape || now - m_escape_time < m_escape_timeout || m_count == c_queue_size)
+        return false;
+    push_key(Key::Escape, 0);
+    m_state = State::Ground;
+    return true;
+}
+
+std::optional<InputDecoder::Clock::time_point>
+InputDecoder::deadline() const noexcept {
+    if (m_state != State::Escape)
+        return std::nullopt;
+    return m_escape_time + m_escape_timeout;
+}
+
+std::optional<InputEvent>
+InputDecoder::pop() noexcept {
+    if (m_count == 0)
+        return std::nullopt;
+    const auto event = m_queue[m_head];
+    m_head = (m_head + 1) % c_queue_size;
+    --m_count;
+    return event;
+}
+
+std::size_t
+InputDecoder::size() const noexcept {
+    return m_count;
+}
+
+void
+InputDecoder::ground(char byte, std::uint8_t mods) noexcept {
+    const auto ubyte = static_cast<unsigned char>(byte);
+    switch (byte) {
+    case '\r':
+    case '\n':
+        push_key(Key::Enter, mods);
+        return;
+    case '\t':
+        push_key(Key::Tab, mods);
+        return;
+    case '\b':
+    case '\x7f':
+        push_key(Key::Backspace, mods);
+        return;
+    default:
+        break;
+    }
+
+    if (ubyte < ' ') {
+        // Ctrl+@ to Ctrl+_, letters are reported lower-case.
+        const auto chr = ubyte >= 1 && ubyte <= 26 ? 'a' + ubyte - 1 : ubyte + '@';
+        push_key(Key::Char, mods | Ctrl, static_cast<char32_t>(chr));
+    } else if (ubyte < c_ascii) {
+        push_key(Key::Char, mods, static_cast<char32_t>(ubyte));
+    } else if (const auto length = utf8_length(ubyte); length != 0) {
+        m_utf8[0] = byte;
+        m_utf8_len = 1;
+        m_utf8_need = length;
+        m_state = State::Utf8;
+    } else {
+        push_key(Key::Char, mods, utf8::c_replacement);
+    }
+}
+
+void
+InputDecoder::csi(char final) noexcept {
+    const auto param = [this](std::size_t idx) { return idx < m_param_count ? m_params[idx] : 0; };
+
+    if (m_marker == '<' && (final == 'M' || final == 'm')) {
+        mouse(final == 'm');
+        return;
+    }
+    // Other private sequences are replies to queries nobody sent.
+    if (m_marker != 0)
+        return;
+
+    if (final == '~') {
+        const auto num = param(0);
+        if (num == c_paste_begin_param) {
+            m_state = State::Paste;
+            m_paste_match = 0;
+        } else if (num != c_paste_end_param && num < c_tilde_keys.size() && c_tilde_keys[num] != Key::None) {
+            push_key(c_tilde_keys[num], param_mods(param(1)));
+        }
+        return;
+    }
+
+    const auto key = c_csi_keys[static_cast<unsigned char>(final)];
+    if (key == Key::None)
+        return;
+    // Back-tab.
+    const std::uint8_t mods = final == 'Z' ? Shift : 0;
+    push_key(key, mods | param_mods(param(1)));
+}
+
+void
+InputDecoder::mouse(bool release) noexcept {
+    constexpr std::uint32_t c_button_mask = 0x3;
+    constexpr std::uint32_t c_shift = 0x4;
+    constexpr std::uint32_t c_alt = 0x8;
+    constexpr std::uint32_t c_ctrl = 0x10;
+    constexpr std::uint32_t c_motion = 0x20;
+    constexpr std::uint32_t c_wheel = 0x40;
+
+    if (m_param_count < 3)
+        return;
+    const auto code = m_params[0];
+
+    InputEvent event{.m_type = InputEvent::Type::MousePress};
+    event.m_mods = static_cast<std::uint8_t>(((code & c_shift) != 0 ? Shift : 0) | ((code & c_alt) != 0 ? Alt : 0) |
+                                             ((code & c_ctrl) != 0 ? Ctrl : 0));
+    // Reports are one-based.
+    event.m_pos = {.m_row = std::max(m_params[2], 1U) - 1, .m_col = std::max(m_params[1], 1U) - 1};
+
+    if ((code & c_wheel) != 0) {
+        event.m_button = (code & 1U) == 0 ? MouseButton::WheelUp : MouseButton::WheelDown;
+    } else {
+        constexpr std::array<MouseButton, 4> c_buttons{MouseButton::Left, MouseButton::Middle, MouseButton::Right,
+                                                       MouseButton::None};
+        event.m_button = c_buttons[code & c_button_mask];
+        if (release)
+            event.m_type = InputEvent::Type::MouseRelease;
+        else if ((code & c_motion) != 0)
+            event.m_type = InputEvent::Type::MouseMove;
+    }
+    push(event);
+}
+
+void
+InputDecoder::paste(std::string_view bytes, std::size_t& pos) noexcept {
+    if (m_paste_match == 0) {
+        // The whole run up to the next ESC is one event.
+        const auto esc = bytes.find(c_esc, pos);
+        const auto end = esc == std::string_view::npos ? bytes.size() : esc;
+        if (end > pos)
+            push({.m_type = InputEvent::Type::Paste, .m_text = bytes.substr(pos, end - pos)});
+        pos = end;
+        if (esc != std::string_view::npos) {
+            m_paste_match = 1;
+            ++pos;
+        }
+        return;
+    }
+
+    while (pos < bytes.size() && m_paste_match < c_paste_end.size() && bytes[pos] == c_paste_end[m_paste_match]) {
+        ++m_paste_match;
+        ++pos;
+    }
+    if (m_paste_match == c_paste_end.size()) {
+        push({.m_type = InputEvent::Type::PasteEnd});
+        m_paste_match = 0;
+        m_state = State::Ground;
+    } else if (pos < bytes.size()) {
+        // Not the terminator, the matched part was pasted. It may have come
+        // from an earlier read, the terminator holds the same bytes.
+        push({.m_type = InputEvent::Type::Paste, .m_text = c_paste_end.substr(0, m_paste_match)});
+        m_paste_match = 0;
+    }
+}
+
+void
+InputDecoder::push_key(Key key, std::uint8_t mods, char32_t chr) noexcept {
+    push({.m_type = InputEvent::Type::Key, .m_key = key, .m_mods = mods, .m_char = chr});
+}
+
+void
+InputDecoder::push(const InputEvent& event) noexcept {
+    m_queue[(m_head + m_count) % c_queue_size] = event;
+    ++m_count;
+}
+
+} // namespace eltau
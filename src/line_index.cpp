@@ -0,0 +1,277 @@
+/*******************************************************************************
+ * @file line_index.cpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+#include <algorithm>
+
+#include <eltau/line_index.hpp>
+#include <eltau/utf8.hpp>
+
+namespace eltau::ascii {
+
+LineIndex::LineIndex(std::pmr::polymorphic_allocator<> alloc) noexcept : m_paragraphs(alloc), m_lines(alloc) {}
+
+LineIndex::LineIndex(std::string_view text) { rebuild(text); }
+
+void
+LineIndex::rebuild(std::string_view text) {
+    m_paragraphs.clear();
+    m_lines.clear();
+    m_max_length = 0;
+    m_limit = 0;
+    m_size = {};
+
+    if (text.empty())
+        return;
+
+    split(text, 0, m_paragraphs);
+    for (const auto& p : m_paragraphs)
+        m_max_length = std::max(m_max_length, p.m_length);
+}
+
+void
+LineIndex::update(std::string_view text, std::size_t pos, std::size_t removed, std::size_t inserted) {
+    if (m_paragraphs.empty() || text.empty()) {
+        const auto limit = m_limit;
+        rebuild(text);
+        if (limit != 0)
+            layout(limit);
+        return;
+    }
+
+    const auto by_begin = [](std::size_t offset, const Segment& s) { return offset < s.m_begin; };
+    // Paragraphs touching the edited range [pos, pos + removed] of the original text.
+    const auto first = static_cast<std::size_t>(
+        std::upper_bound(m_paragraphs.begin(), m_paragraphs.end(), pos, by_begin) - m_paragraphs.begin() - 1);
+    const auto last = static_cast<std::size_t>(
+        std::upper_bound(m_paragraphs.begin(), m_paragraphs.end(), pos + removed, by_begin) - m_paragraphs.begin() - 1);
+    const auto begin = m_paragraphs[first].m_begin;
+    const auto old_end = m_paragraphs[last].m_begin + m_paragraphs[last].m_length;
+    const auto new_end = old_end + inserted - removed;
+
+    std::pmr::vector<Segment> fresh{m_paragraphs.get_allocator()};
+    split(text.substr(begin, new_end - begin), begin, fresh);
+
+    std::size_t old_max = 0;
+    for (auto i = first; i <= last; ++i)
+        old_max = std::max(old_max, m_paragraphs[i].m_length);
+    std::size_t fresh_max = 0;
+    for (const auto& p : fresh)
+        fresh_max = std::max(fresh_max, p.m_length);
+
+    for (auto i = last + 1; i < m_paragraphs.size(); ++i)
+        m_paragraphs[i].m_begin = m_paragraphs[i].m_begin + inserted - removed;
+    const auto it = m_paragraphs.erase(m_paragraphs.begin() + static_cast<std::ptrdiff_t>(first),
+                                       m_paragraphs.begin() + static_cast<std::ptrdiff_t>(last + 1));
+    m_paragraphs.insert(it, fresh.begin(), fresh.end());
+
+    const auto prev_max_length = m_max_length;
+    if (old_max == m_max_length && fresh_max < m_max_length) {
+        // The longest paragraph might have been shortened.
+        m_max_length = 0;
+        for (const auto& p : m_paragraphs)
+            m_max_length = std::max(m_max_length, p.m_length);
+    } else {
+        m_max_length = std::max(m_max_length, fresh_max);
+    }
+
+    if (m_limit == 0)
+        return;
+    m_size = {.m_row = m_paragraphs.size(), .m_col = std::min(m_max_length, m_limit)};
+    if (m_limit >= m_max_length) {
+        m_lines.clear();
+        return;
+    }
+    if (m_limit >= prev_max_length) {
+        // Nothing was wrapped before.
+        m_lines.clear();
+        wrap(0, m_paragraphs.size(), m_lines);
+        m_size.m_row = m_lines.size();
+        return;
+    }
+
+    // Replace lines of the touched paragraphs, shift the rest.
+    const auto by_offset = [](const Segment& s, std::size_t offset) { return s.m_begin < offset; };
+    const auto line_first = std::lower_bound(m_lines.begin(), m_lines.end(), begin, by_offset) - m_lines.begin();
+    const auto line_last = std::lower_bound(m_lines.begin(), m_lines.end(), old_end + 1, by_offset) - m_lines.begin();
+
+    std::pmr::vector<Segment> lines{m_lines.get_allocator()};
+    wrap(first, first + fresh.size(), lines);
+    for (auto i = static_cast<std::size_t>(line_last); i < m_lines.size(); ++i)
+        m_lines[i].m_begin = m_lines[i].m_begin + inserted - removed;
+    const auto line_it = m_lines.erase(m_lines.begin() + line_first, m_lines.begin() + line_last);
+    m_lines.insert(line_it, lines.begin(), lines.end());
+    m_size.m_row = m_lines.size();
+}
+
+std::size_t
+LineIndex::paragraph_count() const noexcept {
+    return m_paragraphs.size();
+}
+
+LineIndex::Segment
+LineIndex::paragraph(std::size_t idx) const noexcept {
+    return idx < m_paragraphs.size() ? m_paragraphs[idx] : Segment{};
+}
+
+Vec2
+LineIndex::size(std::size_t wrap_limit) {
+    layout(wrap_limit);
+    return m_size;
+}
+
+LineIndex::Segment
+LineIndex::line(std::size_t row, std::size_t wrap_limit) {
+    layout(wrap_limit);
+    const auto& lines = m_limit >= m_max_length ? m_paragraphs : m_lines;
+    return row < lines.size() ? lines[row] : Segment{};
+}
+
+void
+LineIndex::split(std::string_view text, std::size_t offset, std::pmr::vector<Segment>& out) {
+    std::size_t begin = 0;
+    for (;;) {
+        const auto end = std::min(text.find('\n', begin), text.size());
+        out.push_back({.m_begin = offset + begin, .m_length = end - begin});
+        if (end == text.size())
+            break;
+        begin = end + 1;
+    }
+}
+
+void
+LineIndex::wrap(std::size_t first, std::size_t last, std::pmr::vector<Segment>& out) const {
+    for (auto i = first; i < last; ++i) {
+        const auto& p = m_paragraphs[i];
+        // Empty paragraph still occupies one line.
+        std::size_t offset = 0;
+        do {
+            out.push_back({.m_begin = p.m_begin + offset, .m_length = std::min(m_limit, p.m_length - offset)});
+            offset += m_limit;
+        } while (offset < p.m_length);
+    }
+}
+
+void
+LineIndex::layout(std::size_t wrap_limit) {
+    // Limits above the longest paragraph all produce the same unwrapped layout.
+    const auto limit = std::max<std::size_t>(wrap_limit, 1);
+    if (limit == m_limit || (limit >= m_max_length && m_limit >= m_max_length))
+        return;
+
+    m_limit = limit;
+    m_lines.clear();
+    m_size = {.m_row = m_paragraphs.size(), .m_col = std::min(m_max_length, limit)};
+    if (limit >= m_max_length)
+        return;
+
+    wrap(0, m_paragraphs.size(), m_lines);
+    m_size.m_row = m_lines.size();
+}
+
+} // namespace eltau::ascii
+
+namespace eltau::utf8 {
+
+LineIndex::LineIndex(std::string_view text) { rebuild(text); }
+
+void
+LineIndex::rebuild(std::string_view text) {
+    m_text = text;
+    m_paragraphs.clear();
+    m_lines.clear();
+    m_max_width = 0;
+    m_limit = 0;
+    m_size = {};
+
+    if (text.empty())
+        return;
+
+    std::size_t begin = 0;
+    for (;;) {
+        const auto end = std::min(text.find('\n', begin), text.size());
+        const auto width = str_width(text.substr(begin, end - begin));
+        m_paragraphs.push_back({.m_begin = begin, .m_length = end - begin, .m_width = width});
+        m_max_width = std::max(m_max_width, width);
+        if (end == text.size())
+            break;
+        begin = end + 1;
+    }
+}
+
+std::size_t
+LineIndex::paragraph_count() const noexcept {
+    return m_paragraphs.size();
+}
+
+LineIndex::Segment
+LineIndex::paragraph(std::size_t idx) const noexcept {
+    return idx < m_paragraphs.size() ? m_paragraphs[idx] : Segment{};
+}
+
+Vec2
+LineIndex::size(std::size_t wrap_limit) {
+    layout(wrap_limit);
+    return m_size;
+}
+
+LineIndex::Segment
+LineIndex::line(std::size_t row, std::size_t wrap_limit) {
+    layout(wrap_limit);
+    const auto& lines = m_lines.empty() ? m_paragraphs : m_lines;
+    return row < lines.size() ? lines[row] : Segment{};
+}
+
+void
+LineIndex::wrap(const Segment& paragraph, std::size_t limit) {
+    if (paragraph.m_width <= limit) {
+        m_lines.push_back(paragraph);
+        return;
+    }
+
+    const auto text = m_text.substr(paragraph.m_begin, paragraph.m_length);
+    if (paragraph.m_width == paragraph.m_length && is_ascii(text)) {
+        for (std::size_t offset = 0; offset < text.size(); offset += limit) {
+            const auto len = std::min(limit, text.size() - offset);
+            m_lines.push_back({.m_begin = paragraph.m_begin + offset, .m_length = len, .m_width = len});
+        }
+        return;
+    }
+
+    Segment line{.m_begin = paragraph.m_begin};
+    for (std::size_t pos = 0; pos < text.size();) {
+        const auto g = next_grapheme(text, pos);
+        if (line.m_width > 0 && line.m_width + g.m_width > limit) {
+            m_lines.push_back(line);
+            line = {.m_begin = paragraph.m_begin + pos};
+        }
+        line.m_length += g.m_length;
+        line.m_width += g.m_width;
+        pos += g.m_length;
+    }
+    m_lines.push_back(line);
+}
+
+void
+LineIndex::layout(std::size_t wrap_limit) {
+    const auto limit = std::clamp<std::size_t>(wrap_limit, 1, std::max<std::size_t>(m_max_width, 1));
+    if (limit == m_limit)
+        return;
+
+    m_limit = limit;
+    m_lines.clear();
+    m_size = {.m_row = m_paragraphs.size(), .m_col = m_max_width};
+    if (limit >= m_max_width)
+        return;
+
+    for (const auto& p : m_paragraphs)
+        wrap(p, limit);
+
+    m_size.m_row = m_lines.size();
+    m_size.m_col = 0;
+    for (const auto& l : m_lines)
+        m_size.m_col = std::max(m_size.m_col, l.m_width);
+}
+
+} // namespace eltau::utf8
@@ -0,0 +1,233 @@
+/*******************************************************************************
+ * @file log_view.cpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+#include <algorithm>
+#include <cstring>
+#include <memory_resource>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <eltau/exception.hpp>
+#include <eltau/log_view.hpp>
+#include <eltau/text.hpp>
+
+namespace eltau {
+namespace {
+/*! Bytes indexed at once, the index is published after each chunk. */
+constexpr std::size_t c_index_chunk = std::size_t{1} << 20U;
+
+/*******************************************************************************
+ * @throw EltauException on failure.
+ ******************************************************************************/
+std::size_t
+file_size(int fd) {
+    struct stat st {};
+    if (fstat(fd, &st) == -1)
+        throw EltauException::from_errno("Cannot query the file size");
+    return static_cast<std::size_t>(st.st_size);
+}
+} // namespace
+
+class LogView::Mapping {
+public:
+    /*******************************************************************************
+     * @brief Map first @p size bytes of the file.
+     *
+     * @throw EltauException if the mapping fails.
+     ******************************************************************************/
+    Mapping(int fd, std::size_t size) : m_size(size) {
+        if (size == 0)
+            return;
+        void* data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        if (data == MAP_FAILED)
+            throw EltauException::from_errno("Cannot map the file");
+        m_data = static_cast<const char*>(data);
+    }
+
+    Mapping(const Mapping& other) = delete;
+    Mapping(Mapping&& other) noexcept = delete;
+    Mapping&
+    operator=(const Mapping& other) = delete;
+    Mapping&
+    operator=(Mapping&& other) noexcept = delete;
+
+    ~Mapping() noexcept {
+        if (m_data != nullptr)
+            (void)munmap(const_cast<char*>(m_data), m_size);
+    }
+
+    /*******************************************************************************
+     * @brief Mapped bytes in [@p begin, @p end).
+     ******************************************************************************/
+    std::string_view
+    view(std::size_t begin, std::size_t end) const noexcept {
+        return {m_data + begin, end - begin};
+    }
+
+    std::size_t
+    size() const noexcept {
+        return m_size;
+    }
+
+private:
+    const char* m_data = nullptr;
+    std::size_t m_size;
+};
+
+LogView::LogView(const std::string& path, std::chrono::milliseconds poll) :
+    m_fd(open(path.c_str(), O_RDONLY | O_CLOEXEC)), m_poll(poll) {
+    if (m_fd == -1)
+        throw EltauException::from_errno("Cannot open " + path);
+    try {
+        m_map = std::make_shared<const Mapping>(m_fd, file_size(m_fd));
+    } catch (...) {
+        (void)close(m_fd);
+        throw;
+    }
+    m_indexer = std::jthread{[this](const std::stop_token& stop) { index(stop); }};
+}
+
+LogView::~LogView() noexcept {
+    m_indexer.request_stop();
+    m_indexer.join();
+    m_map.reset();
+    (void)close(m_fd);
+}
+
+std::size_t
+LogView::line_count() const {
+    std::lock_guard lock{m_mutex};
+    return locked_line_count();
+}
+
+std::size_t
+LogView::indexed_bytes() const {
+    std::lock_guard lock{m_mutex};
+    return m_indexed;
+}
+
+std::string
+LogView::line(std::size_t idx) const {
+    std::lock_guard lock{m_mutex};
+    if (idx >= locked_line_count())
+        return {};
+    const auto end = idx + 1 < m_starts.size() ? m_starts[idx + 1] - 1 : m_indexed;
+    return std::string{m_map->view(m_starts[idx], end)};
+}
+
+void
+LogView::scroll_to(std::size_t idx) noexcept {
+    m_offset = idx;
+}
+
+std::size_t
+LogView::offset() const noexcept {
+    return m_offset;
+}
+
+void
+LogView::set_follow(bool follow) noexcept {
+    m_follow = follow;
+}
+
+Vec2
+LogView::do_calc_pref_size(Vec2 max_size) {
+    return {.m_row = std::min(line_count(), max_size.m_row), .m_col = max_size.m_col};
+}
+
+void
+LogView::do_draw(DrawingWindow& window) {
+    const auto rows = window.size().m_row;
+    const auto origin{window.origin()};
+    // Lines below the screen are not copied.
+    const auto shown_rows = window.visible().size().m_row;
+
+    // Copy just the visible part of the index, the lines are read without the lock.
+    std::pmr::vector<std::pair<std::size_t, std::size_t>> lines{window.scratch()};
+    lines.reserve(shown_rows);
+    std::shared_ptr<const Mapping> map;
+    {
+        std::lock_guard lock{m_mutex};
+        const auto count = locked_line_count();
+        const auto last_page = count > rows ? count - rows : 0;
+        const auto first = m_follow ? last_page : std::min(m_offset, last_page);
+        for (auto i = first; i < count && lines.size() < shown_rows; ++i)
+            lines.emplace_back(m_starts[i], i + 1 < m_starts.size() ? m_starts[i + 1] - 1 : m_indexed);
+        map = m_map;
+    }
+
+    for (std::size_t r = 0; r < shown_rows; ++r) {
+        const auto text = r < lines.size() ? map->view(lines[r].first, lines[r].second) : std::string_view{};
+        ascii::draw_line(window.line(origin.m_row + r), text);
+    }
+}
+
+void
+LogView::index(const std::stop_token& stop) {
+    auto map = [&] {
+        std::lock_guard lock{m_mutex};
+        return m_map;
+    }();
+    std::size_t pos = 0;
+    std::vector<std::size_t> starts;
+
+    while (!stop.stop_requested()) {
+        if (pos < map->size()) {
+            const auto end = std::min(pos + c_index_chunk, map->size());
+            const auto chunk = map->view(pos, end);
+            const auto* it = chunk.data();
+            const auto* const last = it + chunk.size();
+            while (const auto* nl = static_cast<const char*>(std::memchr(it, '\n', static_cast<std::size_t>(last - it)))) {
+                starts.push_back(pos + static_cast<std::size_t>(nl - chunk.data()) + 1);
+                it = nl + 1;
+            }
+
+            std::lock_guard lock{m_mutex};
+            m_starts.insert(m_starts.end(), starts.begin(), starts.end());
+            m_indexed = end;
+            starts.clear();
+            pos = end;
+            continue;
+        }
+
+        // Caught up, wait for the file to grow.
+        {
+            std::unique_lock lock{m_mutex};
+            if (m_cv.wait_for(lock, stop, m_poll, [] { return false; }) || stop.stop_requested())
+                break;
+        }
+        if (auto bigger = remap(map->size())) {
+            map = bigger;
+            std::lock_guard lock{m_mutex};
+            m_map = std::move(bigger);
+        }
+    }
+}
+
+std::shared_ptr<const LogView::Mapping>
+LogView::remap(std::size_t mapped) const {
+    try {
+        const auto size = file_size(m_fd);
+        if (size <= mapped)
+            return nullptr;
+        return std::make_shared<const Mapping>(m_fd, size);
+    } catch (const EltauException&) {
+        // Try again later.
+        return nullptr;
+    }
+}
+
+std::size_t
+LogView::locked_line_count() const noexcept {
+    if (m_indexed == 0)
+        return 0;
+    // Drop the empty line after the trailing newline.
+    return m_starts.back() == m_indexed ? m_starts.size() - 1 : m_starts.size();
+}
+
+} // namespace eltau
@@ -0,0 +1,80 @@
+/*******************************************************************************
+ * @file memory.cpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+#include <algorithm>
+
+#include <eltau/memory.hpp>
+
+namespace eltau {
+
+CountingResource::CountingResource(std::pmr::memory_resource* upstream) noexcept : m_upstream(upstream) {}
+
+std::size_t
+CountingResource::allocations() const noexcept {
+    return m_allocations;
+}
+
+std::size_t
+CountingResource::bytes() const noexcept {
+    return m_bytes;
+}
+
+void*
+CountingResource::do_allocate(std::size_t bytes, std::size_t alignment) {
+    auto* ptr = m_upstream->allocate(bytes, alignment);
+    ++m_allocations;
+    m_bytes += bytes;
+    return ptr;
+}
+
+void
+CountingResource::do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) {
+    m_upstream->deallocate(ptr, bytes, alignment);
+    m_bytes -= bytes;
+}
+
+bool
+CountingResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+FrameArena::FrameArena(std::size_t initial_bytes, std::pmr::memory_resource* upstream) :
+    m_upstream(upstream), m_capacity(std::max(initial_bytes, std::size_t{1})),
+    m_buffer(m_upstream->allocate(m_capacity)), m_overflow(upstream) {
+    m_arena.emplace(m_buffer, m_capacity, &m_overflow);
+}
+
+FrameArena::~FrameArena() noexcept {
+    m_arena.reset();
+    m_upstream->deallocate(m_buffer, m_capacity);
+}
+
+std::pmr::memory_resource*
+FrameArena::resource() noexcept {
+    return &*m_arena;
+}
+
+void
+FrameArena::reset() {
+    const auto overflow = m_overflow.bytes();
+    m_arena->release();
+    if (overflow == 0)
+        return;
+
+    // The frame did not fit, make room for all of it.
+    auto* buffer = m_upstream->allocate(m_capacity + overflow);
+    m_arena.reset();
+    m_upstream->deallocate(m_buffer, m_capacity);
+    m_buffer = buffer;
+    m_capacity += overflow;
+    m_arena.emplace(m_buffer, m_capacity, &m_overflow);
+}
+
+std::size_t
+FrameArena::capacity() const noexcept {
+    return m_capacity;
+}
+
+} // namespace eltau
@@ -0,0 +1,185 @@
+/*******************************************************************************
+ * @file metrics.cpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+#include <fmt/format.h>
+
+#include <eltau/exception.hpp>
+#include <eltau/metrics.hpp>
+#include <eltau/text.hpp>
+
+namespace eltau {
+namespace {
+/*! Width of the percentage of a ProgressBar, e.g. " 50%". */
+constexpr std::size_t c_percent_width = 4;
+/*! Width of the brackets and the space of a ProgressBar. */
+constexpr std::size_t c_bar_decoration = 3;
+
+/*******************************************************************************
+ * @brief Draw @p text to the first row of @p window, blank the others.
+ ******************************************************************************/
+void
+draw_first_row(DrawingWindow& window, std::string_view text) noexcept {
+    const auto origin{window.origin()};
+    for (std::size_t r = 0; r < window.size().m_row; ++r)
+        ascii::draw_line(window.line(origin.m_row + r), r == 0 ? text : std::string_view{});
+}
+
+/*******************************************************************************
+ * @brief One row as wide as @p text, within @p max_size.
+ ******************************************************************************/
+Vec2
+text_size(std::string_view text, Vec2 max_size) noexcept {
+    return {.m_row = std::min<std::size_t>(1, max_size.m_row), .m_col = std::min(text.size(), max_size.m_col)};
+}
+
+/*******************************************************************************
+ * @throw EltauException if @p counter is null.
+ ******************************************************************************/
+std::shared_ptr<const Counter>
+check_counter(std::shared_ptr<const Counter> counter) {
+    if (!counter)
+        throw EltauException{"Counter must not be null."};
+    return counter;
+}
+} // namespace
+
+namespace detail {
+std::size_t
+shard_index() noexcept {
+    static std::atomic<std::size_t> next{0};
+    thread_local const std::size_t index = next.fetch_add(1, std::memory_order_relaxed) % Counter::c_shards;
+    return index;
+}
+} // namespace detail
+
+std::uint64_t
+Counter::load() const noexcept {
+    std::uint64_t sum = 0;
+    for (const auto& shard : m_shards)
+        sum += shard.m_value.load(std::memory_order_relaxed);
+    return sum;
+}
+
+RateMeter::RateMeter(std::chrono::nanoseconds window) noexcept :
+    m_window(std::max(window, std::chrono::nanoseconds{1})) {}
+
+double
+RateMeter::sample(std::uint64_t value, Clock::time_point now) noexcept {
+    if (!m_last_time) {
+        m_last_time = now;
+        m_last_value = value;
+        return m_rate;
+    }
+    // Samples taken at the same time are merged.
+    if (now <= *m_last_time)
+        return m_rate;
+
+    const std::chrono::duration<double> elapsed = now - *m_last_time;
+    const auto current = static_cast<double>(value - m_last_value) / elapsed.count();
+    const auto weight = 1.0 - std::exp(-(elapsed / m_window));
+    m_rate += weight * (current - m_rate);
+    m_last_time = now;
+    m_last_value = value;
+    return m_rate;
+}
+
+double
+RateMeter::rate() const noexcept {
+    return m_rate;
+}
+
+ProgressBar::ProgressBar(std::shared_ptr<const Counter> done, std::uint64_t total) :
+    m_done(check_counter(std::move(done))), m_total(total) {}
+
+void
+ProgressBar::set_total(std::uint64_t total) noexcept {
+    m_total = total;
+}
+
+Vec2
+ProgressBar::do_calc_pref_size(Vec2 max_size) {
+    return {.m_row = 1, .m_col = max_size.m_col};
+}
+
+void
+ProgressBar::do_draw(DrawingWindow& window) {
+    const auto done = std::min(m_done->load(), m_total);
+    const auto fraction = m_total == 0 ? 0.0 : static_cast<double>(done) / static_cast<double>(m_total);
+    const auto percent = static_cast<unsigned>(fraction * 100);
+
+    m_text.clear();
+    auto out = std::back_inserter(m_text);
+    const auto width = window.size().m_col;
+    if (width > c_percent_width + c_bar_decoration) {
+        const auto bar = width - c_percent_width - c_bar_decoration;
+        const auto filled = static_cast<std::size_t>(fraction * static_cast<double>(bar));
+        m_text += '[';
+        m_text.append(filled, '#');
+        m_text.append(bar - filled, ' ');
+        m_text += "] ";
+    }
+    fmt::format_to(out, "{:>3}%", percent);
+    draw_first_row(window, m_text);
+}
+
+CounterLabel::CounterLabel(std::shared_ptr<const Counter> counter, std::string label) :
+    m_counter(check_counter(std::move(counter))), m_label(std::move(label)) {
+    sample();
+}
+
+Vec2
+CounterLabel::do_calc_pref_size(Vec2 max_size) {
+    return text_size(m_text, max_size);
+}
+
+void
+CounterLabel::do_draw(DrawingWindow& window) {
+    sample();
+    draw_first_row(window, m_text);
+}
+
+void
+CounterLabel::sample() {
+    const auto value = m_counter->load();
+    m_text.clear();
+    if (m_label.empty())
+        fmt::format_to(std::back_inserter(m_text), "{}", value);
+    else
+        fmt::format_to(std::back_inserter(m_text), "{}: {}", m_label, value);
+}
+
+RateLabel::RateLabel(std::shared_ptr<const Counter> counter, std::string unit, std::chrono::nanoseconds window) :
+    m_counter(check_counter(std::move(counter))), m_unit(std::move(unit)), m_meter(window) {
+    sample();
+}
+
+double
+RateLabel::rate() const noexcept {
+    return m_meter.rate();
+}
+
+Vec2
+RateLabel::do_calc_pref_size(Vec2 max_size) {
+    return text_size(m_text, max_size);
+}
+
+void
+RateLabel::do_draw(DrawingWindow& window) {
+    sample();
+    draw_first_row(window, m_text);
+}
+
+void
+RateLabel::sample() {
+    const auto rate = m_meter.sample(m_counter->load(), RateMeter::Clock::now());
+    m_text.clear();
+    fmt::format_to(std::back_inserter(m_text), "{:.1f}{}", rate, m_unit);
+}
+
+} // namespace eltau
@@ -3,22 +3,72 @@
  * @copyright Copyright 2022 Jan Waltl.
  * @license	This file is released under ElTau project's license, see LICENSE.
  ******************************************************************************/
+#include <algorithm>
+#include <utility>
+
 #include <eltau/screen.hpp>
 
 namespace eltau {
-Screen::Screen(Vec2 size) : m_size{size}, m_buffer{m_size.m_col * m_size.m_row, Cell{}} {
-
-    for (auto& c : m_buffer) {
-        c.m_char[0] = '+';
-        c.m_char[1] = 0;
-    }
+namespace {
+/*******************************************************************************
+ * @brief Cell of a new screen.
+ ******************************************************************************/
+Cell
+fresh_cell() noexcept {
+    Cell cell{};
+    cell.m_char[0] = '+';
+    cell.m_char[1] = 0;
+    return cell;
 }
+} // namespace
+
+Screen::Screen(Vec2 size, std::pmr::memory_resource* resource) :
+    m_size{size}, m_buffer{m_size.m_col * m_size.m_row, fresh_cell(), resource} {}
 
 Vec2
 Screen::size() const noexcept {
     return m_size;
 }
 
+void
+Screen::resize(Vec2 size) {
+    if (size == m_size)
+        return;
+
+    const auto rows = std::min(m_size.m_row, size.m_row);
+    const auto cols = std::min(m_size.m_col, size.m_col);
+    const auto old_cols = m_size.m_col;
+    const auto new_cols = size.m_col;
+    const auto cell = fresh_cell();
+
+    if (const auto total = size.m_row * new_cols; total > m_buffer.size())
+        m_buffer.resize(total, cell);
+    const auto row_begin = [this](std::size_t row, std::size_t width) {
+        return m_buffer.begin() + static_cast<std::ptrdiff_t>(row * width);
+    };
+
+    // Narrower rows move towards the front, wider towards the back. Either way,
+    // no row is overwritten before it has been moved.
+    if (new_cols < old_cols) {
+        for (std::size_t r = 1; r < rows; ++r)
+            std::copy_n(row_begin(r, old_cols), cols, row_begin(r, new_cols));
+    } else if (new_cols > old_cols) {
+        for (std::size_t r = rows; r-- > 1;) {
+            const auto src = row_begin(r, old_cols);
+            std::copy_backward(src, src + static_cast<std::ptrdiff_t>(cols),
+                               row_begin(r, new_cols) + static_cast<std::ptrdiff_t>(cols));
+        }
+    }
+
+    for (std::size_t r = 0; r < rows; ++r)
+        std::fill(row_begin(r, new_cols) + static_cast<std::ptrdiff_t>(cols), row_begin(r + 1, new_cols), cell);
+    std::fill(row_begin(rows, new_cols), row_begin(size.m_row, new_cols), cell);
+
+    // Shrinking keeps the capacity.
+    m_buffer.resize(size.m_row * new_cols);
+    m_size = size;
+}
+
 Screen::Line
 Screen::line(std::size_t idx) noexcept {
     auto range = std::as_const(*this).line(idx);
@@ -43,7 +93,7 @@ Screen::operator[](Vec2 coords) const noexcept {
     if (!Window{{0, 0}, m_size}.is_inside(coords))
         return nullptr;
 
-    auto idx = (coords.m_row + 1) * coords.m_col;
+    auto idx = coords.m_row * m_size.m_col + coords.m_col;
     return &m_buffer[idx];
 }
 
@@ -52,6 +102,20 @@ Screen::operator[](Vec2 coords) noexcept {
     return const_cast<Cell*>(std::as_const(*this)[coords]);
 }
 
+void
+blank(std::span<Cell> cells) noexcept {
+    for (auto& cell : cells) {
+        cell = Cell{};
+        cell.m_char[0] = ' ';
+    }
+}
+
+void
+blank(Screen& screen) noexcept {
+    for (std::size_t r = 0; r < screen.size().m_row; ++r)
+        blank(screen.line(r));
+}
+
 Vec2
 operator+(const Vec2& l, const Vec2& r) {
     return {.m_row = l.m_row + r.m_row, .m_col = l.m_col + r.m_col};
@@ -83,6 +147,18 @@ Window::is_inside(Vec2 pos) const noexcept {
     return pos.m_row >= m_origin.m_row && pos.m_row < end.m_row && pos.m_col >= m_origin.m_col && pos.m_col < end.m_col;
 }
 
+bool
+Window::empty() const noexcept {
+    return m_size.m_row == 0 || m_size.m_col == 0;
+}
+
+Window
+Window::intersect(const Window& other) const noexcept {
+    const auto begin = max(m_origin, other.m_origin);
+    // Saturates to zero if disjoint.
+    return {begin, min(end(), other.end()) - begin};
+}
+
 Vec2
 Window::size() const noexcept {
     return m_size;
@@ -105,11 +181,40 @@ Window::sub_win(Vec2 offset, Vec2 size) {
     return {origin, min(max_size, size)};
 }
 
-DrawingWindow::DrawingWindow(const Window& win, Screen& screen) noexcept : Window{win}, m_screen{&screen} {}
+DrawingWindow::DrawingWindow(const Window& win, Screen& screen, std::pmr::memory_resource* scratch,
+                             HitMap* hits) noexcept :
+    Window{win}, m_screen{&screen}, m_scratch{scratch}, m_hits{hits} {}
 
 DrawingWindow
 DrawingWindow::sub_win(Vec2 offset, Vec2 size) {
-    return DrawingWindow{Window::sub_win(offset, size), *m_screen};
+    return DrawingWindow{Window::sub_win(offset, size), *m_screen, m_scratch, m_hits};
+}
+
+Window
+DrawingWindow::visible() const noexcept {
+    return intersect({{0, 0}, m_screen->size()});
+}
+
+std::pmr::memory_resource*
+DrawingWindow::scratch() const noexcept {
+    return m_scratch;
+}
+
+HitMap*
+DrawingWindow::hit_map() const noexcept {
+    return m_hits;
+}
+
+Screen::Line
+DrawingWindow::line(std::size_t row) noexcept {
+    if (row < origin().m_row || row >= end().m_row)
+        return {};
+
+    auto line = m_screen->line(row);
+    const auto col = origin().m_col;
+    if (col >= line.size())
+        return {};
+    return line.subspan(col, std::min(size().m_col, line.size() - col));
 }
 
 Cell*
@@ -0,0 +1,202 @@
+/*******************************************************************************
+ * @file server.cpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+#include <array>
+#include <cerrno>
+#include <string_view>
+#include <utility>
+
+#include <fcntl.h>
+#include <fmt/format.h>
+#include <unistd.h>
+
+#include <eltau/exception.hpp>
+#include <eltau/server.hpp>
+
+namespace eltau {
+namespace {
+/*! Size of one read of a session's input. */
+constexpr std::size_t c_input_chunk = 4096;
+} // namespace
+
+Server::Session::Session(int fd, int flags, std::unique_ptr<Element> root, std::optional<Vec2> size) :
+    m_fd(fd), m_flags(flags), m_terminal(std::move(root), fd, fd, size) {}
+
+Server::Server(EventLoop& loop) : m_loop(&loop) {
+    m_loop->on_render([this] { render(); });
+}
+
+Server::~Server() noexcept {
+    while (!m_sessions.empty())
+        remove_session(m_sessions.begin()->first);
+    m_loop->on_render({});
+}
+
+Server::SessionId
+Server::add_session(int fd, std::unique_ptr<Element> root, std::optional<Vec2> size) {
+    const auto flags = fcntl(fd, F_GETFL);
+    if (flags == -1 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) == -1)
+        throw EltauException::from_errno("Cannot make the session non-blocking");
+
+    try {
+        auto session = std::make_unique<Session>(fd, flags, std::move(root), size);
+        m_loop->add_reader(fd, [this, fd] { read_input(fd); });
+        m_sessions[fd] = std::move(session);
+    } catch (...) {
+        (void)fcntl(fd, F_SETFL, flags);
+        throw;
+    }
+    request_redraw(fd);
+    return fd;
+}
+
+void
+Server::remove_session(SessionId id) noexcept {
+    const auto it = m_sessions.find(id);
+    if (it == m_sessions.end())
+        return;
+    auto& session = *it->second;
+    m_loop->remove_reader(session.m_fd);
+    if (session.m_escape_timer)
+        m_loop->cancel_timer(*session.m_escape_timer);
+    const auto fd = session.m_fd;
+    const auto flags = session.m_flags;
+    // Restores the terminal while the descriptor is still non-blocking.
+    m_sessions.erase(it);
+    (void)fcntl(fd, F_SETFL, flags);
+}
+
+std::size_t
+Server::session_count() const noexcept {
+    return m_sessions.size();
+}
+
+EagerTerminal&
+Server::terminal(SessionId id) {
+    return session(id).m_terminal;
+}
+
+void
+Server::request_redraw(SessionId id) noexcept {
+    const auto it = m_sessions.find(id);
+    if (it == m_sessions.end())
+        return;
+    if (!std::exchange(it->second->m_dirty, true))
+        m_dirty.push_back(id);
+    m_loop->request_redraw();
+}
+
+void
+Server::resize(SessionId id, Vec2 size) {
+    session(id).m_terminal.resize(size);
+    request_redraw(id);
+}
+
+void
+Server::on_input(InputHandler handler) {
+    m_on_input = std::move(handler);
+}
+
+void
+Server::on_close(CloseHandler handler) {
+    m_on_close = std::move(handler);
+}
+
+void
+Server::read_input(SessionId id) {
+    std::array<char, c_input_chunk> buffer{};
+    while (true) {
+        auto& decoder = session(id).m_decoder;
+        const auto len = read(id, buffer.data(), buffer.size());
+        if (len > 0) {
+            std::string_view input{buffer.data(), static_cast<std::size_t>(len)};
+            while (!input.empty()) {
+                input.remove_prefix(decoder.feed(input));
+                if (!dispatch(id))
+                    return;
+            }
+            continue;
+        }
+        if (len == -1 && errno == EINTR)
+            continue;
+        if (len == -1 && errno == EAGAIN)
+            break;
+        // Closed by the client, EIO for a pty.
+        if (m_on_close)
+            m_on_close(id);
+        remove_session(id);
+        return;
+    }
+
+    arm_escape_timer(id);
+}
+
+void
+Server::arm_escape_timer(SessionId id) {
+    auto& session = this->session(id);
+    const auto deadline = session.m_decoder.deadline();
+    if (!deadline || session.m_escape_timer)
+        return;
+    session.m_escape_timer = m_loop->add_timer(*deadline - InputDecoder::Clock::now(), {}, [this, id] {
+        auto& expired = this->session(id);
+        expired.m_escape_timer.reset();
+        if (expired.m_decoder.expire() && !dispatch(id))
+            return;
+        // A newer ESC arrived after the timer was set, its deadline is later.
+        arm_escape_timer(id);
+    });
+}
+
+bool
+Server::dispatch(SessionId id) {
+    auto* session = &this->session(id);
+    while (const auto event = session->m_decoder.pop()) {
+        if (!m_on_input)
+            continue;
+        m_on_input(id, *event);
+        const auto it = m_sessions.find(id);
+        if (it == m_sessions.end())
+            return false;
+        session = it->second.get();
+    }
+    return true;
+}
+
+void
+Server::render() {
+    // Sessions with pending output stay dirty until written.
+    auto dirty = std::move(m_dirty);
+    m_dirty.clear();
+    for (const auto id : dirty) {
+        const auto it = m_sessions.find(id);
+        if (it == m_sessions.end())
+            continue;
+        auto& session = *it->second;
+        session.m_terminal.draw();
+        if (!session.m_terminal.output_pending()) {
+            session.m_dirty = false;
+            continue;
+        }
+        m_dirty.push_back(id);
+        // Drawn again once the client accepts more.
+        if (!std::exchange(session.m_writing, true)) {
+            m_loop->set_writer(id, [this, id] {
+                m_loop->set_writer(id, {});
+                this->session(id).m_writing = false;
+                m_loop->request_redraw();
+            });
+        }
+    }
+}
+
+Server::Session&
+Server::session(SessionId id) {
+    const auto it = m_sessions.find(id);
+    if (it == m_sessions.end())
+        throw EltauException{fmt::format("Unknown session {}", id)};
+    return *it->second;
+}
+
+} // namespace eltau
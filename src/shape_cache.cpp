@@ -0,0 +1,97 @@
+/*******************************************************************************
+ * @file shape_cache.cpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+#include <algorithm>
+#include <functional>
+#include <limits>
+
+#include <eltau/shape_cache.hpp>
+#include <eltau/text.hpp>
+
+namespace eltau {
+
+double
+ShapeCache::Stats::hit_rate() const noexcept {
+    const auto total = m_hits + m_misses;
+    return total == 0 ? 0.0 : static_cast<double>(m_hits) / static_cast<double>(total);
+}
+
+ShapeCache::ShapeCache(std::size_t max_bytes, std::size_t max_text) : m_max_bytes(max_bytes), m_max_text(max_text) {}
+
+bool
+ShapeCache::cacheable(std::string_view text) const noexcept {
+    return text.size() <= m_max_text;
+}
+
+const Screen&
+ShapeCache::shape(std::string_view text, Style style, std::size_t wrap_limit) {
+    // All limits above the text length yield the same shape.
+    wrap_limit = std::min(wrap_limit, text.size());
+
+    auto h = std::hash<std::string_view>{}(text);
+    h ^= (static_cast<std::size_t>(style) + 0x9e3779b9U + (h << 6U) + (h >> 2U));
+    h ^= (wrap_limit + 0x9e3779b9U + (h << 6U) + (h >> 2U));
+    const Key key{.m_text = text, .m_style = style, .m_wrap_limit = wrap_limit, .m_hash = h};
+
+    if (auto it = m_map.find(key); it != m_map.end()) {
+        ++m_stats.m_hits;
+        m_lru.splice(m_lru.begin(), m_lru, it->second);
+        return it->second->m_cells;
+    }
+    ++m_stats.m_misses;
+
+    ascii::Text shaper{c_borrow, text, wrap_limit};
+    shaper.set_style(style);
+    const auto size = shaper.calc_pref_size(
+        {.m_row = std::numeric_limits<std::size_t>::max(), .m_col = std::numeric_limits<std::size_t>::max()});
+    Screen cells{size};
+    DrawingWindow window{Window{{0, 0}, size}, cells};
+    shaper.draw(window);
+
+    const auto bytes = sizeof(Entry) + text.size() + size.m_row * size.m_col * sizeof(Cell);
+    auto& entry = m_lru.emplace_front(
+        Entry{.m_text = std::string{text}, .m_key = key, .m_cells = std::move(cells), .m_bytes = bytes});
+    // Re-point the key to the owned copy.
+    entry.m_key.m_text = entry.m_text;
+    m_map.emplace(entry.m_key, m_lru.begin());
+    m_stats.m_bytes += entry.m_bytes;
+    ++m_stats.m_entries;
+
+    while (m_stats.m_bytes > m_max_bytes && m_lru.size() > 1) {
+        const auto& last = m_lru.back();
+        m_map.erase(last.m_key);
+        m_stats.m_bytes -= last.m_bytes;
+        --m_stats.m_entries;
+        ++m_stats.m_evictions;
+        m_lru.pop_back();
+    }
+    return entry.m_cells;
+}
+
+void
+ShapeCache::clear() noexcept {
+    m_map.clear();
+    m_lru.clear();
+    m_stats.m_entries = 0;
+    m_stats.m_bytes = 0;
+}
+
+ShapeCache::Stats
+ShapeCache::stats() const noexcept {
+    return m_stats;
+}
+
+bool
+ShapeCache::Key::operator==(const Key& other) const noexcept {
+    return m_hash == other.m_hash && m_style == other.m_style && m_wrap_limit == other.m_wrap_limit &&
+           m_text == other.m_text;
+}
+
+std::size_t
+ShapeCache::KeyHash::operator()(const Key& key) const noexcept {
+    return key.m_hash;
+}
+
+} // namespace eltau
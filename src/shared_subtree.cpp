@@ -0,0 +1,126 @@
+/*******************************************************************************
+ * @file shared_subtree.cpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+#include <algorithm>
+
+#include <eltau/exception.hpp>
+#include <eltau/shared_subtree.hpp>
+
+namespace eltau {
+
+SharedSubtree::SharedSubtree(std::unique_ptr<Element> root, std::size_t max_sizes) :
+    m_root(std::move(root)), m_max_sizes(std::max(max_sizes, std::size_t{1})) {
+    if (!m_root)
+        throw EltauException{"Shared subtree root must not be null."};
+}
+
+std::uint64_t
+SharedSubtree::version() const noexcept {
+    return m_version;
+}
+
+void
+SharedSubtree::replace(std::unique_ptr<Element> root) {
+    if (!root)
+        throw EltauException{"Shared subtree root must not be null."};
+    m_root = std::move(root);
+    bump();
+}
+
+Vec2
+SharedSubtree::pref_size(Vec2 max_size) {
+    const auto it = std::find_if(m_layouts.begin(), m_layouts.end(),
+                                 [&](const Layout& layout) { return layout.m_max_size == max_size; });
+    if (it != m_layouts.end() && it->m_version == m_version)
+        return it->m_pref_size;
+
+    const Layout layout{.m_version = m_version, .m_max_size = max_size, .m_pref_size = m_root->calc_pref_size(max_size)};
+    if (it != m_layouts.end()) {
+        *it = layout;
+    } else if (m_layouts.size() < m_max_sizes) {
+        m_layouts.push_back(layout);
+    } else {
+        m_layouts[m_next_layout] = layout;
+        m_next_layout = (m_next_layout + 1) % m_max_sizes;
+    }
+    return layout.m_pref_size;
+}
+
+const Screen&
+SharedSubtree::render(Vec2 size, std::pmr::memory_resource* scratch) {
+    auto it = std::find_if(m_blocks.begin(), m_blocks.end(),
+                           [&](const Block& block) { return block.m_cells.size() == size; });
+    if (it != m_blocks.end() && it->m_version == m_version)
+        return it->m_cells;
+
+    Block* block = nullptr;
+    if (it != m_blocks.end()) {
+        block = &*it;
+    } else if (m_blocks.size() < m_max_sizes) {
+        block = &m_blocks.emplace_back(Block{.m_version = m_version, .m_cells = Screen{size}});
+    } else {
+        // Storage of the evicted size is reused.
+        block = &m_blocks[m_next_block];
+        block->m_cells.resize(size);
+        m_next_block = (m_next_block + 1) % m_max_sizes;
+    }
+
+    // Same as the compositor, the layout is done for the whole window over
+    // blank cells, nothing of the previous content is left.
+    (void)m_root->calc_pref_size(size);
+    blank(block->m_cells);
+    DrawingWindow window{{{0, 0}, size}, block->m_cells, scratch};
+    m_root->draw(window);
+    block->m_version = m_version;
+    ++m_draw_count;
+    return block->m_cells;
+}
+
+std::size_t
+SharedSubtree::draw_count() const noexcept {
+    return m_draw_count;
+}
+
+void
+SharedSubtree::bump() noexcept {
+    // Entries of old versions are recomputed on their next lookup.
+    ++m_version;
+}
+
+SharedElement::SharedElement(std::shared_ptr<SharedSubtree> subtree) : m_subtree(std::move(subtree)) {
+    if (!m_subtree)
+        throw EltauException{"Shared subtree must not be null."};
+}
+
+SharedSubtree&
+SharedElement::subtree() const noexcept {
+    return *m_subtree;
+}
+
+bool
+SharedElement::stale() const noexcept {
+    return m_drawn_version != m_subtree->version();
+}
+
+Vec2
+SharedElement::do_calc_pref_size(Vec2 max_size) {
+    return m_subtree->pref_size(max_size);
+}
+
+void
+SharedElement::do_draw(DrawingWindow& window) {
+    const auto& cells = m_subtree->render(window.size(), window.scratch());
+    m_drawn_version = m_subtree->version();
+
+    const auto origin = window.origin();
+    const auto visible = window.visible();
+    for (auto row = visible.origin().m_row; row < visible.end().m_row; ++row) {
+        auto dst = window.line(row);
+        const auto src = cells.line(row - origin.m_row);
+        std::copy_n(src.begin(), std::min(dst.size(), src.size()), dst.begin());
+    }
+}
+
+} // namespace eltau
@@ -0,0 +1,209 @@
+/*******************************************************************************
+ * @file table.cpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+#include <algorithm>
+
+#include <fmt/format.h>
+
+#include <eltau/exception.hpp>
+#include <eltau/table.hpp>
+#include <eltau/text.hpp>
+
+namespace eltau {
+namespace {
+/*! Columns are separated by one space. */
+constexpr std::size_t c_separator = 1;
+
+/*******************************************************************************
+ * @brief Width taken by separators between @p columns columns.
+ ******************************************************************************/
+constexpr std::size_t
+separators(std::size_t columns) noexcept {
+    return columns > 0 ? (columns - 1) * c_separator : 0;
+}
+} // namespace
+
+Table::Table(std::vector<TableColumn> columns) : m_columns(std::move(columns)), m_widths(m_columns.size()) {
+    for (std::size_t c = 0; c < m_columns.size(); ++c)
+        measure(c, m_columns[c].m_title, true);
+}
+
+std::size_t
+Table::column_count() const noexcept {
+    return m_columns.size();
+}
+
+std::size_t
+Table::row_count() const noexcept {
+    return m_rows.size();
+}
+
+std::size_t
+Table::add_row(Row row) {
+    normalize(row);
+    for (std::size_t c = 0; c < row.size(); ++c)
+        measure(c, row[c], true);
+
+    m_order.push_back(m_rows.size());
+    m_rows.push_back(std::move(row));
+    return m_rows.size() - 1;
+}
+
+void
+Table::set_row(std::size_t idx, Row row) {
+    if (idx >= m_rows.size())
+        throw EltauException{fmt::format("Row {} is out of range of {} rows", idx, m_rows.size())};
+    normalize(row);
+
+    for (std::size_t c = 0; c < row.size(); ++c) {
+        measure(c, m_rows[idx][c], false);
+        measure(c, row[c], true);
+    }
+    m_rows[idx] = std::move(row);
+}
+
+void
+Table::set_cell(std::size_t row, std::size_t column, std::string text) {
+    (void)cell(row, column);
+
+    measure(column, m_rows[row][column], false);
+    measure(column, text, true);
+    m_rows[row][column] = std::move(text);
+}
+
+const std::string&
+Table::cell(std::size_t row, std::size_t column) const {
+    if (row >= m_rows.size() || column >= m_columns.size())
+        throw EltauException{fmt::format("Cell [{}, {}] is out of range of {} rows and {} columns", row, column,
+                                         m_rows.size(), m_columns.size())};
+    return m_rows[row][column];
+}
+
+std::size_t
+Table::displayed(std::size_t pos) const noexcept {
+    return pos < m_order.size() ? m_order[pos] : m_rows.size();
+}
+
+void
+Table::sort(std::size_t column, bool descending) {
+    if (column >= m_columns.size())
+        throw EltauException{fmt::format("Column {} is out of range of {} columns", column, m_columns.size())};
+
+    std::stable_sort(m_order.begin(), m_order.end(), [&](std::size_t l, std::size_t r) {
+        return descending ? m_rows[r][column] < m_rows[l][column] : m_rows[l][column] < m_rows[r][column];
+    });
+}
+
+std::size_t
+Table::natural_width(std::size_t column) const noexcept {
+    if (column >= m_widths.size() || m_widths[column].empty())
+        return 0;
+    return m_widths[column].rbegin()->first;
+}
+
+void
+Table::scroll_to(std::size_t pos) noexcept {
+    m_first_row = pos;
+}
+
+void
+Table::scroll_to_column(std::size_t column) noexcept {
+    m_first_column = column;
+}
+
+const FlexSolver&
+Table::solver() const noexcept {
+    return m_solver;
+}
+
+Vec2
+Table::do_calc_pref_size(Vec2 max_size) {
+    const auto first = std::min(m_first_column, m_columns.size());
+    std::size_t width = separators(m_columns.size() - first);
+    for (auto c = first; c < m_columns.size(); ++c) {
+        const auto& flex = m_columns[c].m_flex;
+        width += std::min(std::max(natural_width(c), flex.m_min), flex.m_max);
+    }
+    return min({.m_row = m_rows.size() + 1, .m_col = width}, max_size);
+}
+
+void
+Table::do_draw(DrawingWindow& window) {
+    const auto origin{window.origin()};
+    // Clipped parts are not composed.
+    const auto [rows, cols] = window.visible().size();
+    if (rows == 0)
+        return;
+
+    const auto widths = layout(window.size().m_col);
+    compose(widths, nullptr, cols);
+    ascii::draw_line(window.line(origin.m_row), m_line, Style::Bold);
+
+    const auto body = window.size().m_row - 1;
+    const auto first = std::min(m_first_row, m_order.size() > body ? m_order.size() - body : 0);
+    for (std::size_t r = 0; r + 1 < rows; ++r) {
+        const auto pos = first + r;
+        if (pos < m_order.size())
+            compose(widths, &m_rows[m_order[pos]], cols);
+        else
+            m_line.assign(cols, ' ');
+        ascii::draw_line(window.line(origin.m_row + 1 + r), m_line);
+    }
+}
+
+void
+Table::measure(std::size_t column, std::string_view text, bool add) {
+    auto& widths = m_widths[column];
+    if (add) {
+        ++widths[text.size()];
+    } else if (auto it = widths.find(text.size()); it != widths.end() && --it->second == 0) {
+        widths.erase(it);
+    }
+}
+
+void
+Table::normalize(Row& row) const {
+    if (row.size() > m_columns.size())
+        throw EltauException{fmt::format("Row has {} cells, table has {} columns", row.size(), m_columns.size())};
+    row.resize(m_columns.size());
+}
+
+std::span<const std::size_t>
+Table::layout(std::size_t width) {
+    const auto first = std::min(m_first_column, m_columns.size());
+    const auto count = m_columns.size() - first;
+
+    // Items change only when scrolled horizontally.
+    const auto same = m_items.size() == count && std::equal(m_items.begin(), m_items.end(), m_columns.begin() + static_cast<std::ptrdiff_t>(first),
+                                                            [](const auto& item, const auto& col) { return item == col.m_flex; });
+    if (!same) {
+        m_items.clear();
+        for (auto c = first; c < m_columns.size(); ++c)
+            m_items.push_back(m_columns[c].m_flex);
+        m_solver.invalidate();
+    }
+    m_prefs.resize(count);
+    for (std::size_t i = 0; i < count; ++i)
+        m_prefs[i] = natural_width(first + i);
+
+    const auto seps = separators(count);
+    return m_solver.solve(width > seps ? width - seps : 0, m_items, m_prefs);
+}
+
+void
+Table::compose(std::span<const std::size_t> widths, const Row* row, std::size_t width) {
+    const auto first = std::min(m_first_column, m_columns.size());
+    m_line.assign(width, ' ');
+
+    std::size_t x = 0;
+    for (std::size_t i = 0; i < widths.size() && x < width; ++i) {
+        const std::string_view text = row != nullptr ? (*row)[first + i] : m_columns[first + i].m_title;
+        const auto len = std::min({text.size(), widths[i], width - x});
+        std::copy_n(text.begin(), len, m_line.begin() + static_cast<std::ptrdiff_t>(x));
+        x += widths[i] + c_separator;
+    }
+}
+
+} // namespace eltau
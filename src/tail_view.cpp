@@ -0,0 +1,108 @@
+/*******************************************************************************
+ * @file tail_view.cpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+#include <algorithm>
+
+#include <eltau/tail_view.hpp>
+#include <eltau/text.hpp>
+
+namespace eltau {
+
+// The producer and the drawing thread access the arena and the records
+// concurrently through atomic_ref and the claimed counters act as a seqlock. The
+// producer claims before its release stores, the reader checks the claims after
+// its acquire loads - if it has seen any overwritten byte, it sees the claim too
+// and discards the line. Plain moves on x86, no fences.
+
+TailView::TailView(std::size_t max_lines, std::size_t arena_bytes) :
+    m_max_lines(std::max<std::size_t>(max_lines, 1)), m_arena_bytes(std::max<std::size_t>(arena_bytes, 1)),
+    m_records(std::make_unique<Record[]>(m_max_lines)), m_arena(std::make_unique<char[]>(m_arena_bytes)) {}
+
+void
+TailView::append(std::string_view line) noexcept {
+    line = line.substr(0, m_arena_bytes);
+    const auto begin = m_bytes;
+    const auto idx = m_appended.load(std::memory_order_relaxed);
+    m_bytes += line.size();
+
+    m_claimed_bytes.store(m_bytes, std::memory_order_relaxed);
+    m_claimed_lines.store(idx + 1, std::memory_order_relaxed);
+
+    // At most two contiguous runs.
+    const auto offset = begin % m_arena_bytes;
+    const auto first = std::min(line.size(), m_arena_bytes - offset);
+    for (std::size_t i = 0; i < first; ++i)
+        std::atomic_ref{m_arena[offset + i]}.store(line[i], std::memory_order_release);
+    for (std::size_t i = first; i < line.size(); ++i)
+        std::atomic_ref{m_arena[i - first]}.store(line[i], std::memory_order_release);
+
+    auto& record = m_records[idx % m_max_lines];
+    std::atomic_ref{record.m_begin}.store(begin, std::memory_order_release);
+    std::atomic_ref{record.m_length}.store(line.size(), std::memory_order_release);
+
+    m_appended.store(idx + 1, std::memory_order_release);
+}
+
+std::size_t
+TailView::appended() const noexcept {
+    return m_appended.load(std::memory_order_acquire);
+}
+
+Vec2
+TailView::do_calc_pref_size(Vec2 max_size) {
+    return {.m_row = std::min(kept(appended()), max_size.m_row), .m_col = max_size.m_col};
+}
+
+void
+TailView::do_draw(DrawingWindow& window) {
+    const auto rows = window.size().m_row;
+    const auto origin{window.origin()};
+    // Only the part on the screen is copied.
+    const auto [shown_rows, cols] = window.visible().size();
+
+    const auto appended = this->appended();
+    const auto kept_rows = std::min(kept(appended), rows);
+    const auto first = appended - kept_rows;
+    const auto shown = std::min(kept_rows, shown_rows);
+
+    m_scratch.resize(shown * cols);
+    m_visible.resize(shown);
+    for (std::size_t k = 0; k < shown; ++k) {
+        auto& record = m_records[(first + k) % m_max_lines];
+        m_visible[k].m_begin = std::atomic_ref{record.m_begin}.load(std::memory_order_acquire);
+        // Only the visible part.
+        m_visible[k].m_length =
+            std::min({std::atomic_ref{record.m_length}.load(std::memory_order_acquire), cols, m_arena_bytes});
+        copy_out(m_visible[k].m_begin, m_visible[k].m_length, m_scratch.data() + k * cols);
+    }
+
+    const auto claimed_lines = m_claimed_lines.load(std::memory_order_relaxed);
+    const auto claimed_bytes = m_claimed_bytes.load(std::memory_order_relaxed);
+
+    for (std::size_t r = 0; r < shown_rows; ++r) {
+        std::string_view text;
+        if (r < shown) {
+            // Neither the record nor the text has been overwritten while copied.
+            const auto valid = claimed_lines <= first + r + m_max_lines &&
+                               claimed_bytes <= m_visible[r].m_begin + m_arena_bytes;
+            if (valid)
+                text = {m_scratch.data() + r * cols, m_visible[r].m_length};
+        }
+        ascii::draw_line(window.line(origin.m_row + r), text);
+    }
+}
+
+std::size_t
+TailView::kept(std::size_t appended) const noexcept {
+    return std::min(appended, m_max_lines);
+}
+
+void
+TailView::copy_out(std::size_t pos, std::size_t length, char* out) const noexcept {
+    for (std::size_t i = 0; i < length; ++i)
+        out[i] = std::atomic_ref{m_arena[(pos + i) % m_arena_bytes]}.load(std::memory_order_acquire);
+}
+
+} // namespace eltau
@@ -0,0 +1,337 @@
+/*******************************************************************************
+ * @file task.cpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include <eltau/exception.hpp>
+#include <eltau/shared_state.hpp>
+#include <eltau/task.hpp>
+
+namespace eltau {
+namespace detail {
+
+WaitNode::~WaitNode() noexcept {
+    unlink();
+}
+
+void
+WaitNode::unlink() noexcept {
+    if (m_list == nullptr)
+        return;
+    (m_prev != nullptr ? m_prev->m_next : m_list->m_head) = m_next;
+    (m_next != nullptr ? m_next->m_prev : m_list->m_tail) = m_prev;
+    m_list = nullptr;
+    m_prev = nullptr;
+    m_next = nullptr;
+}
+
+WaitNode*
+WaitNode::next() const noexcept {
+    return m_next;
+}
+
+WaitList::~WaitList() noexcept {
+    while (pop_front() != nullptr) {
+    }
+}
+
+void
+WaitList::push_back(WaitNode& node) noexcept {
+    node.m_list = this;
+    node.m_prev = m_tail;
+    node.m_next = nullptr;
+    (m_tail != nullptr ? m_tail->m_next : m_head) = &node;
+    m_tail = &node;
+}
+
+WaitNode*
+WaitList::pop_front() noexcept {
+    auto* node = m_head;
+    if (node != nullptr)
+        node->unlink();
+    return node;
+}
+
+WaitNode*
+WaitList::front() const noexcept {
+    return m_head;
+}
+
+bool
+WaitList::empty() const noexcept {
+    return m_head == nullptr;
+}
+
+void
+WaitList::splice(WaitList& other) noexcept {
+    while (auto* node = other.pop_front())
+        push_back(*node);
+}
+
+std::uint64_t
+StateBase::version() const noexcept {
+    return m_version;
+}
+
+void
+StateBase::notify() noexcept {
+    ++m_version;
+    while (auto* node = m_waiters.pop_front()) {
+        auto& awaiter = static_cast<Scheduler::StateAwaiter&>(*node);
+        awaiter.m_scheduler->post(awaiter);
+    }
+}
+} // namespace detail
+
+Task
+Task::promise_type::get_return_object() noexcept {
+    return Task{Handle::from_promise(*this)};
+}
+
+void
+Task::promise_type::unhandled_exception() noexcept {
+    m_exception = std::current_exception();
+}
+
+Task::Task(Handle handle) noexcept : m_handle(handle) {}
+
+Task::Task(Task&& other) noexcept : m_handle(std::exchange(other.m_handle, nullptr)) {}
+
+Task&
+Task::operator=(Task&& other) noexcept {
+    if (this != &other) {
+        if (m_handle)
+            m_handle.destroy();
+        m_handle = std::exchange(other.m_handle, nullptr);
+    }
+    return *this;
+}
+
+Task::~Task() noexcept {
+    if (m_handle)
+        m_handle.destroy();
+}
+
+Scheduler::FrameAwaiter::FrameAwaiter(Scheduler& scheduler) noexcept : m_scheduler(&scheduler) {}
+
+bool
+Scheduler::FrameAwaiter::await_ready() const noexcept {
+    return false;
+}
+
+void
+Scheduler::FrameAwaiter::await_suspend(std::coroutine_handle<Task::promise_type> handle) noexcept {
+    m_handle = handle;
+    m_scheduler->m_frame.push_back(*this);
+    m_scheduler->arm(std::max(Clock::now(), m_scheduler->m_last_frame + m_scheduler->m_frame_interval));
+}
+
+Scheduler::TimerAwaiter::TimerAwaiter(Scheduler& scheduler, Clock::time_point deadline) noexcept :
+    m_scheduler(&scheduler), m_deadline(deadline) {}
+
+bool
+Scheduler::TimerAwaiter::await_ready() const noexcept {
+    return m_deadline <= Clock::now();
+}
+
+void
+Scheduler::TimerAwaiter::await_suspend(std::coroutine_handle<Task::promise_type> handle) noexcept {
+    m_handle = handle;
+    m_scheduler->m_wheel.schedule(*this, m_deadline);
+    m_scheduler->arm(*m_scheduler->m_wheel.next_deadline());
+}
+
+Scheduler::InputAwaiter::InputAwaiter(Scheduler& scheduler) noexcept : m_scheduler(&scheduler) {}
+
+bool
+Scheduler::InputAwaiter::await_ready() const noexcept {
+    return false;
+}
+
+void
+Scheduler::InputAwaiter::await_suspend(std::coroutine_handle<Task::promise_type> handle) noexcept {
+    m_handle = handle;
+    m_scheduler->m_input.push_back(*this);
+}
+
+InputEvent
+Scheduler::InputAwaiter::await_resume() const noexcept {
+    return m_event;
+}
+
+Scheduler::StateAwaiter::StateAwaiter(Scheduler& scheduler, detail::StateBase& state) noexcept :
+    m_scheduler(&scheduler), m_state(&state) {}
+
+bool
+Scheduler::StateAwaiter::await_ready() const noexcept {
+    return false;
+}
+
+void
+Scheduler::StateAwaiter::await_suspend(std::coroutine_handle<Task::promise_type> handle) noexcept {
+    m_handle = handle;
+    m_state->m_waiters.push_back(*this);
+}
+
+Scheduler::Scheduler(EventLoop& loop, std::chrono::nanoseconds frame_interval) :
+    m_loop(&loop), m_frame_interval(frame_interval), m_wheel(frame_interval, Clock::now()) {
+    m_timer = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (m_timer == -1)
+        throw EltauException::from_errno("Cannot create timerfd");
+    try {
+        m_loop->add_reader(m_timer, [this] { expire(); });
+    } catch (...) {
+        (void)close(m_timer);
+        throw;
+    }
+}
+
+Scheduler::~Scheduler() noexcept {
+    // Destroying a frame unlinks its awaiter and its m_task node.
+    while (auto* node = m_tasks.front())
+        node->m_handle.destroy();
+    m_loop->remove_reader(m_timer);
+    (void)close(m_timer);
+}
+
+void
+Scheduler::spawn(Task task) {
+    auto handle = std::exchange(task.m_handle, nullptr);
+    auto& node = handle.promise().m_task;
+    node.m_handle = handle;
+    m_tasks.push_back(node);
+    resume(handle);
+}
+
+std::size_t
+Scheduler::task_count() const noexcept {
+    std::size_t count = 0;
+    for (auto* node = m_tasks.front(); node != nullptr; node = node->next())
+        ++count;
+    return count;
+}
+
+Scheduler::FrameAwaiter
+Scheduler::next_frame() noexcept {
+    return FrameAwaiter{*this};
+}
+
+Scheduler::TimerAwaiter
+Scheduler::sleep_for(std::chrono::nanoseconds delay) noexcept {
+    return sleep_until(Clock::now() + delay);
+}
+
+Scheduler::TimerAwaiter
+Scheduler::sleep_until(Clock::time_point deadline) noexcept {
+    return TimerAwaiter{*this, deadline};
+}
+
+Scheduler::InputAwaiter
+Scheduler::next_input() noexcept {
+    return InputAwaiter{*this};
+}
+
+Scheduler::StateAwaiter
+Scheduler::changed(detail::StateBase& state) noexcept {
+    return StateAwaiter{*this, state};
+}
+
+void
+Scheduler::dispatch(const InputEvent& event) {
+    // Tasks awaiting again wait for the next event.
+    detail::WaitList waiting;
+    waiting.splice(m_input);
+    for (auto* node = waiting.front(); node != nullptr; node = node->next())
+        static_cast<InputAwaiter&>(*node).m_event = event;
+    resume_all(waiting);
+}
+
+void
+Scheduler::post(detail::WaitNode& node) noexcept {
+    m_ready.push_back(node);
+    arm(Clock::now());
+}
+
+void
+Scheduler::arm(Clock::time_point deadline) noexcept {
+    if (deadline >= m_armed)
+        return;
+    m_armed = deadline;
+
+    // Zero would disarm the timer.
+    const auto since_epoch = std::max(deadline.time_since_epoch(), Clock::duration{1});
+    const auto secs = std::chrono::duration_cast<std::chrono::seconds>(since_epoch);
+    const auto nsecs = std::chrono::duration_cast<std::chrono::nanoseconds>(since_epoch - secs);
+    const itimerspec spec{.it_interval = {},
+                          .it_value = {.tv_sec = static_cast<time_t>(secs.count()),
+                                       .tv_nsec = static_cast<long>(nsecs.count())}};
+    // steady_clock is CLOCK_MONOTONIC.
+    (void)timerfd_settime(m_timer, TFD_TIMER_ABSTIME, &spec, nullptr);
+}
+
+void
+Scheduler::expire() {
+    std::uint64_t expirations = 0;
+    (void)read(m_timer, &expirations, sizeof(expirations));
+    m_armed = Clock::time_point::max();
+    const auto now = Clock::now();
+
+    detail::WaitList due;
+    due.splice(m_ready);
+    m_wheel.advance(now, [&due](TimerWheel::Entry& entry) {
+        auto& awaiter = static_cast<TimerAwaiter&>(entry);
+        due.push_back(awaiter);
+    });
+    auto next = m_wheel.next_deadline().value_or(Clock::time_point::max());
+    if (!m_frame.empty()) {
+        const auto frame = m_last_frame + m_frame_interval;
+        if (frame <= now) {
+            due.splice(m_frame);
+            m_last_frame = now;
+            m_loop->request_redraw();
+        } else {
+            next = std::min(next, frame);
+        }
+    }
+
+    // Resumed tasks arm the timer for their new waits themselves.
+    arm(next);
+    resume_all(due);
+}
+
+void
+Scheduler::resume_all(detail::WaitList& list) {
+    while (auto* node = list.pop_front()) {
+        try {
+            resume(node->m_handle);
+        } catch (...) {
+            m_ready.splice(list);
+            if (!m_ready.empty())
+                arm(Clock::now());
+            throw;
+        }
+    }
+}
+
+void
+Scheduler::resume(std::coroutine_handle<> handle) {
+    // Only Tasks can await the scheduler's awaiters.
+    const auto task = std::coroutine_handle<Task::promise_type>::from_address(handle.address());
+    task.resume();
+    if (!task.done())
+        return;
+
+    const auto exception = std::move(task.promise().m_exception);
+    task.destroy();
+    if (exception)
+        std::rethrow_exception(exception);
+}
+
+} // namespace eltau
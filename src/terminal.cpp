@@ -4,12 +4,17 @@
  * @license	This file is released under ElTau project's license, see LICENSE.
  ******************************************************************************/
 
+#include <cerrno>
+#include <iterator>
+#include <string>
+
 #include <fmt/core.h>
 #include <sys/ioctl.h>
 #include <termios.h>
 #include <unistd.h>
 
 #include <eltau/terminal.hpp>
+#include <eltau/utf8.hpp>
 
 #include "eltau/exception.hpp"
 #include "fmt/format.h"
@@ -21,75 +26,276 @@ namespace {
  * @throw EltauException if the size is unknown
  ******************************************************************************/
 Vec2
-get_screen_size() {
+get_screen_size(int fd) {
     struct winsize w;
-    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &w) == -1) {
+    if (ioctl(fd, TIOCGWINSZ, &w) == -1) {
         throw EltauException::from_errno("Cannot query the terminal size");
     }
     return {.m_row = w.ws_row, .m_col = w.ws_col};
 }
 
-struct termios orig_term {}; // NOLINT
+/*******************************************************************************
+ * @brief Write as much of @p out to @p fd as possible, drop the written part.
+ *
+ * @return Whether everything has been written.
+ ******************************************************************************/
+bool
+write_out(int fd, std::string& out) {
+    std::size_t written = 0;
+    while (written < out.size()) {
+        const auto len = write(fd, out.data() + written, out.size() - written);
+        if (len > 0) {
+            written += static_cast<std::size_t>(len);
+        } else if (len == -1 && errno == EAGAIN) {
+            break;
+        } else if (len != -1 || errno != EINTR) {
+            // Broken output, nothing more can be written.
+            written = out.size();
+        }
+    }
+    out.erase(0, written);
+    return out.empty();
+}
 
+/*******************************************************************************
+ * @brief Append the cells of the composed @p rect on @p row to @p out.
+ ******************************************************************************/
 void
-restore_terminal() {
+append_cells(std::string& out, const Screen& screen, const Window& rect, std::size_t row) {
+    const auto line = screen.line(row).subspan(rect.origin().m_col, rect.size().m_col);
+    for (const auto& cell : line) {
+        // Continuation of a wide character.
+        if (cell.m_char[0] != 0)
+            out += cell.m_char.data();
+    }
+}
+
+} // namespace
+EagerTerminal::EagerTerminal(std::unique_ptr<Element> root) :
+    EagerTerminal(std::move(root), STDIN_FILENO, STDOUT_FILENO) {}
+
+EagerTerminal::EagerTerminal(std::unique_ptr<Element> root, int input_fd, int output_fd, std::optional<Vec2> size) :
+    m_input(input_fd),
+    m_output(output_fd),
+    m_compositor{size ? *size : get_screen_size(output_fd)},
+    m_root_layer{m_compositor.add_layer(std::move(root), {{0, 0}, m_compositor.screen().size()})} {
+
+    struct termios term {};
+    // Not a tty, e.g. a socket.
+    if (tcgetattr(m_input, &term) == 0) {
+        m_orig_term = term;
+        cfmakeraw(&term);
+        (void)tcsetattr(m_input, TCSAFLUSH, &term);
+    }
+    // Switch to an alternative screen -> preserves the history better.
+    m_out = "\033[?1049h";
+    (void)flush();
+}
+
+EagerTerminal::~EagerTerminal() noexcept {
     // Switch to the original screen.
-    fmt::print("\033[?1049l");
-    // Restore the terminal.
-    tcsetattr(STDIN_FILENO, TCSAFLUSH, &orig_term);
+    m_out += "\033[?1049l";
+    (void)flush();
+    if (m_orig_term)
+        (void)tcsetattr(m_input, TCSAFLUSH, &*m_orig_term);
 }
 
 void
-setup_terminal() {
-    (void)tcgetattr(STDIN_FILENO, &orig_term);
-    struct termios raw {
-        orig_term
-    };
-    cfmakeraw(&raw);
+EagerTerminal::draw() {
+    // The changes are kept by the compositor until the client catches up.
+    if (!m_out.empty() && !flush())
+        return;
+
+    const auto& screen = m_compositor.compose();
 
-    (void)std::atexit(restore_terminal);
+    // Only the re-composed rectangles are written out.
+    auto out = std::back_inserter(m_out);
+    for (const auto& rect : m_compositor.damage()) {
+        for (auto row = rect.origin().m_row; row < rect.end().m_row; ++row) {
+            fmt::format_to(out, "\033[{};{}H", row + 1, rect.origin().m_col + 1);
+            append_cells(m_out, screen, rect, row);
+        }
+    }
+    (void)flush();
+}
 
-    (void)tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw);
-    // Disable output line buffering, required because we do not draw on line basis.
-    (void)setvbuf(stdout, nullptr, _IONBF, 0);
+bool
+EagerTerminal::flush() {
+    return write_out(m_output, m_out);
+}
 
-    // Switch to an alternative screen -> preserves the history better.
-    fmt::print("\033[?1049h");
+bool
+EagerTerminal::output_pending() const noexcept {
+    return !m_out.empty();
 }
 
-} // namespace
-EagerTerminal::EagerTerminal(std::unique_ptr<Element> root) : m_root{std::move(root)}, m_screen{get_screen_size()} {
+Compositor&
+EagerTerminal::compositor() noexcept {
+    return m_compositor;
+}
 
-    setup_terminal();
+Compositor::LayerId
+EagerTerminal::root_layer() const noexcept {
+    return m_root_layer;
 }
+
 void
+EagerTerminal::resize(Vec2 size) {
+    m_compositor.resize(size);
+    m_compositor.move_layer(m_root_layer, {{0, 0}, size});
+}
 
-EagerTerminal::draw() {
-    if (!m_root)
+void
+EagerTerminal::attach(EventLoop& loop) {
+    loop.on_render([this] { draw(); });
+    loop.on_resize([this, &loop] {
+        if (m_resize_pending)
+            return;
+        m_resize_pending = true;
+        (void)loop.add_timer(c_resize_debounce, {}, [this, &loop] {
+            m_resize_pending = false;
+            try {
+                resize(get_screen_size(m_output));
+            } catch (const EltauException&) {
+                // E.g. the tty is gone, the current size is kept.
+                return;
+            }
+            loop.request_redraw();
+        });
+    });
+    loop.request_redraw();
+}
+
+InlineTerminal::InlineTerminal(std::unique_ptr<Element> root, std::size_t height) :
+    InlineTerminal(std::move(root), height, STDOUT_FILENO) {}
+
+InlineTerminal::InlineTerminal(std::unique_ptr<Element> root, std::size_t height, int output_fd,
+                               std::optional<std::size_t> width) :
+    m_output(output_fd),
+    m_compositor{{.m_row = height, .m_col = width ? *width : get_screen_size(output_fd).m_col}},
+    m_root_layer{m_compositor.add_layer(std::move(root), {{0, 0}, m_compositor.screen().size()})} {
+    if (height == 0)
+        throw EltauException{"Inline region must have at least one row."};
+
+    // Scrolls the terminal if the cursor is too close to the bottom.
+    m_out = "\r";
+    m_out.append(height - 1, '\n');
+    move_rows(height - 1, 0);
+    (void)flush();
+}
+
+InlineTerminal::~InlineTerminal() noexcept {
+    // Later output continues below the last frame.
+    move_rows(0, m_compositor.screen().size().m_row - 1);
+    m_out += "\r\n";
+    (void)flush();
+}
+
+void
+InlineTerminal::draw() {
+    // The changes are kept by the compositor until the output catches up.
+    if (!m_out.empty() && !flush())
         return;
 
-    const auto dims = m_screen.size();
-    // Process elements
+    const auto& screen = m_compositor.compose();
+    if (m_compositor.damage().empty())
+        return;
 
-    // Draw to the screen buffer
-    // m_root->calc_pref_size(dims);
-    // m_root->draw(DrawingWindow{{{0, 0}, dims}, m_screen});
+    // The cursor is at the top-left corner, only rows are tracked.
+    std::size_t cursor = 0;
+    auto out = std::back_inserter(m_out);
+    for (const auto& rect : m_compositor.damage()) {
+        for (auto row = rect.origin().m_row; row < rect.end().m_row; ++row) {
+            move_rows(cursor, row);
+            cursor = row;
+            m_out += '\r';
+            if (rect.origin().m_col > 0)
+                fmt::format_to(out, "\033[{}C", rect.origin().m_col);
+            append_cells(m_out, screen, rect, row);
+        }
+    }
+    move_rows(cursor, 0);
+    m_out += '\r';
+    (void)flush();
+}
 
-    // Draw the screen buffer to the screen.
-    fmt::print("\033[H");
-    for (std::size_t i = 0; i < dims.m_row; ++i) {
-        auto line = m_screen.line(i);
-        if (i > 0)
-            fmt::print("\r\n");
+void
+InlineTerminal::log(std::string_view text) {
+    const auto width = m_compositor.screen().size().m_col;
+    const auto height = m_compositor.screen().size().m_row;
+    if (!text.empty() && text.back() == '\n')
+        text.remove_suffix(1);
 
-        std::string x(line.size(), 'x');
-        fmt::print("{}\r", x);
-        for (const auto& cell : line) {
-            break;
-            if (cell.m_char[0] != 0)
-                fmt::print("{}", cell.m_char.data());
+    // Wrapped rows, each followed by a newline.
+    std::string rows;
+    std::size_t count = 0;
+    std::size_t col = 0;
+    for (std::size_t pos = 0; pos < text.size();) {
+        if (text[pos] == '\n') {
+            rows += "\r\n";
+            ++count;
+            col = 0;
+            ++pos;
+            continue;
         }
+        const auto g = utf8::next_grapheme(text, pos);
+        pos += g.m_length;
+        if (g.m_control)
+            continue;
+        if (col > 0 && col + g.m_width > width) {
+            rows += "\r\n";
+            ++count;
+            col = 0;
+        }
+        rows += g.m_replaced ? std::string_view{"\xEF\xBF\xBD"} : text.substr(g.m_begin, g.m_length);
+        col += g.m_width;
     }
+    rows += "\r\n";
+    ++count;
+
+    // Make room below the region, scrolling the terminal if needed, then insert
+    // the rows above it. The terminal moves the region down, it keeps its content.
+    move_rows(0, height - 1);
+    m_out.append(count, '\n');
+    fmt::format_to(std::back_inserter(m_out), "\033[{}A\033[{}L", height - 1 + count, count);
+    m_out += rows;
+    // The last newline ends at the top-left corner of the region.
+    (void)flush();
+}
+
+bool
+InlineTerminal::flush() {
+    return write_out(m_output, m_out);
+}
+
+bool
+InlineTerminal::output_pending() const noexcept {
+    return !m_out.empty();
+}
+
+Compositor&
+InlineTerminal::compositor() noexcept {
+    return m_compositor;
+}
+
+Compositor::LayerId
+InlineTerminal::root_layer() const noexcept {
+    return m_root_layer;
+}
+
+void
+InlineTerminal::attach(EventLoop& loop) {
+    loop.on_render([this] { draw(); });
+    loop.request_redraw();
+}
+
+void
+InlineTerminal::move_rows(std::size_t from, std::size_t to) {
+    // Zero would move by one.
+    if (to < from)
+        fmt::format_to(std::back_inserter(m_out), "\033[{}A", from - to);
+    else if (to > from)
+        fmt::format_to(std::back_inserter(m_out), "\033[{}B", to - from);
 }
 
 } // namespace eltau
@@ -6,59 +6,158 @@
 
 #include <algorithm>
 #include <cassert>
+#include <span>
+#include <utility>
 
+#include <fmt/format.h>
+
+#include <eltau/exception.hpp>
+#include <eltau/shape_cache.hpp>
 #include <eltau/text.hpp>
+#include <eltau/utf8.hpp>
 
-namespace eltau::ascii {
+namespace eltau {
 namespace {
 /*! Escape non-printable ASCII with a space. */
 constexpr char c_escape_char = ' ';
+/*! U+FFFD REPLACEMENT CHARACTER, shown instead of invalid UTF-8. */
+constexpr std::string_view c_replacement_utf8{"\xEF\xBF\xBD"};
+
+/*******************************************************************************
+ * @brief Replace a non-printable ASCII character.
+ ******************************************************************************/
+constexpr char
+escape_ascii(char c) noexcept {
+    const auto u = static_cast<unsigned char>(c);
+    return u < 32 || u >= 127 ? c_escape_char : c;
+}
+
+/*******************************************************************************
+ * @brief Place a single-byte character into the cell.
+ ******************************************************************************/
+void
+set_char(Cell& cell, char c) noexcept {
+    cell.m_char[0] = c;
+    cell.m_char[1] = 0;
+}
 
 /*******************************************************************************
- * @brief Replace non-printable ASCII characters, leaves newlines intact.
+ * @brief Copy pre-shaped line to the cells, pad the rest with spaces.
  *
- * @param str String to replace, ASCII-only.
- * @return Escaped copy of a string.
+ * @param cells Target cells, @p line is cut off if it does not fit.
  ******************************************************************************/
-std::string
-escape_ascii(std::string str) noexcept {
-    std::string res{std::move(str)};
+void
+blit_line(std::span<Cell> cells, std::span<const Cell> line, Style style) noexcept {
+    const auto len = std::min(cells.size(), line.size());
+    std::copy_n(line.begin(), len, cells.begin());
+    ascii::draw_line(cells.subspan(len), {}, style);
+}
 
-    std::replace_if(
-        res.begin(), res.end(), [](char c) { return c < 32 && c != '\n'; }, c_escape_char);
+/*******************************************************************************
+ * @brief Place an UTF-8 grapheme into the cell.
+ *
+ * @param grapheme Valid UTF-8 sequence, replaced by U+FFFD if it does not fit.
+ ******************************************************************************/
+void
+set_grapheme(Cell& cell, std::string_view grapheme) noexcept {
+    if (grapheme.size() >= cell.m_char.size())
+        grapheme = c_replacement_utf8;
 
-    return res;
+    std::copy(grapheme.begin(), grapheme.end(), cell.m_char.begin());
+    cell.m_char[grapheme.size()] = 0;
 }
 
 /*******************************************************************************
- * @brief Replace non-printable ASCII characters, leaves newlines intact.
+ * @brief Write one line of UTF-8 text to the cells, pad the rest with spaces.
  *
- * @param str String to replace, ASCII-only.
- * @param wrap_limit Limit line length.
- * @return Escaped copy of a string.
+ * @param cells Target cells, @p line is cut off if it does not fit.
+ * @param line Text without newlines, escaped on the fly.
  ******************************************************************************/
-Vec2
-calc_rows_cols(std::string_view str, std::size_t wrap_limit) {
-    std::size_t max_cols = 0;
-    std::size_t cur_cols = 0;
-    std::size_t rows = str.empty() ? 0 : 1;
-    for (auto c : str) {
-        // Also "consumes" newline as wrap_limit if both conds are true.
-        if (c == '\n' || cur_cols >= wrap_limit) {
-            ++rows;
-            max_cols = std::max(std::exchange(cur_cols, 0), max_cols);
+void
+draw_utf8_line(std::span<Cell> cells, std::string_view line) noexcept {
+    std::size_t col = 0;
+    std::size_t pos = 0;
+    while (col < cells.size() && pos < line.size()) {
+        // All but the last ASCII character are whole graphemes, the last can be extended.
+        const auto rest = line.size() - pos;
+        if (auto ascii = utf8::ascii_prefix(line.substr(pos)); ascii > 1 || ascii == rest) {
+            ascii = std::min(ascii == rest ? ascii : ascii - 1, cells.size() - col);
+            for (std::size_t i = 0; i < ascii; ++i)
+                set_char(cells[col + i], escape_ascii(line[pos + i]));
+            col += ascii;
+            pos += ascii;
+            continue;
         }
-        if (c != '\n') // Place the character
-            ++cur_cols;
+
+        const auto g = utf8::next_grapheme(line, pos);
+        pos += g.m_length;
+        if (g.m_width > cells.size() - col)
+            break;
+
+        if (g.m_control)
+            set_char(cells[col], c_escape_char);
+        else if (g.m_replaced)
+            set_grapheme(cells[col], c_replacement_utf8);
+        else
+            set_grapheme(cells[col], line.substr(g.m_begin, g.m_length));
+        // Continuation of a wide grapheme.
+        for (std::size_t i = 1; i < g.m_width; ++i)
+            cells[col + i].m_char[0] = 0;
+        col += g.m_width;
     }
-    max_cols = std::max(cur_cols, max_cols);
-    return Vec2{.m_row = rows, .m_col = max_cols};
+    for (; col < cells.size(); ++col)
+        set_char(cells[col], ' ');
 }
 
 } // namespace
+} // namespace eltau
 
-Text::Text(std::string_view text, std::size_t wrap_limit) :
-    m_text(escape_ascii(std::string(text))), m_wrap_limit(wrap_limit) {}
+namespace eltau::ascii {
+
+void
+draw_line(std::span<Cell> cells, std::string_view line, Style style) noexcept {
+    const auto len = std::min(cells.size(), line.size());
+    for (std::size_t i = 0; i < cells.size(); ++i) {
+        cells[i].m_style = style;
+        set_char(cells[i], i < len ? escape_ascii(line[i]) : ' ');
+    }
+}
+
+Text::Text(std::string_view text, std::size_t wrap_limit) : Text(std::allocator_arg, {}, text, wrap_limit) {}
+
+Text::Text(std::allocator_arg_t, std::pmr::polymorphic_allocator<> alloc, std::string_view text,
+           std::size_t wrap_limit) :
+    m_alloc(alloc), m_wrap_limit(wrap_limit), m_index(alloc) {
+    auto storage = std::allocate_shared<std::pmr::string>(m_alloc, text);
+    m_editable = storage.get();
+    m_text = *storage;
+    m_storage = std::move(storage);
+}
+
+Text::Text(std::shared_ptr<const std::string> text, std::size_t wrap_limit) :
+    Text(std::allocator_arg, {}, std::move(text), wrap_limit) {}
+
+Text::Text(std::allocator_arg_t, std::pmr::polymorphic_allocator<> alloc, std::shared_ptr<const std::string> text,
+           std::size_t wrap_limit) :
+    m_alloc(alloc), m_text(text ? std::string_view{*text} : std::string_view{}), m_wrap_limit(wrap_limit),
+    m_index(alloc) {
+    m_storage = std::move(text);
+}
+
+Text::Text(BorrowTag, std::string_view text, std::size_t wrap_limit) :
+    Text(std::allocator_arg, {}, c_borrow, text, wrap_limit) {}
+
+Text::Text(std::allocator_arg_t, std::pmr::polymorphic_allocator<> alloc, BorrowTag, std::string_view text,
+           std::size_t wrap_limit) :
+    m_alloc(alloc), m_text(text), m_wrap_limit(wrap_limit), m_index(alloc) {}
+
+Text::Text(const Text& other) : Text(std::allocator_arg, other.m_alloc, other) {}
+
+Text::Text(std::allocator_arg_t, std::pmr::polymorphic_allocator<> alloc, const Text& other) :
+    Element(other), m_storage(other.m_storage),
+    // Storage from another allocator is copied on the first edit.
+    m_editable(alloc == other.m_alloc ? other.m_editable : nullptr), m_alloc(alloc), m_text(other.m_text),
+    m_wrap_limit(other.m_wrap_limit), m_index(alloc), m_style(other.m_style), m_cache(other.m_cache) {}
 
 Vec2
 Text::do_calc_pref_size(Vec2 max_size) {
@@ -66,12 +165,116 @@ Text::do_calc_pref_size(Vec2 max_size) {
 
     auto limit{std::min(max_size.m_col, m_wrap_limit)};
 
-    return min(calc_rows_cols(m_text, limit), max_size);
+    if (m_cache && m_cache->cacheable(m_text))
+        return min(m_cache->shape(m_text, m_style, limit).size(), max_size);
+    return min(index().size(limit), max_size);
 }
 
 void
 Text::do_draw(DrawingWindow& window) {
-    (void)window;
-    // TODO (jw) Implement me after terminal rework.
+    const auto limit{std::min(window.size().m_col, m_wrap_limit)};
+    const auto origin{window.origin()};
+
+    if (m_cache && m_cache->cacheable(m_text)) {
+        const auto& shaped = m_cache->shape(m_text, m_style, limit);
+        for (std::size_t r = 0; r < window.size().m_row; ++r)
+            blit_line(window.line(origin.m_row + r), shaped.line(r), m_style);
+        return;
+    }
+
+    for (std::size_t r = 0; r < window.size().m_row; ++r) {
+        const auto seg = index().line(r, limit);
+        draw_line(window.line(origin.m_row + r), m_text.substr(seg.m_begin, seg.m_length), m_style);
+    }
+}
+
+void
+Text::set_style(Style style) noexcept {
+    m_style = style;
+}
+
+void
+Text::set_shape_cache(std::shared_ptr<ShapeCache> cache) noexcept {
+    m_cache = std::move(cache);
 }
+
+void
+Text::append(std::string_view text) {
+    replace(m_text.size(), 0, text);
+}
+
+void
+Text::replace(std::size_t pos, std::size_t count, std::string_view text) {
+    if (pos > m_text.size())
+        throw EltauException{fmt::format("Replaced position {} is out of range of {} characters", pos, m_text.size())};
+
+    count = std::min(count, m_text.size() - pos);
+    auto& str = editable();
+    str.replace(pos, count, text);
+    m_text = str;
+    if (m_indexed)
+        m_index.update(m_text, pos, count, text.size());
+}
+
+LineIndex&
+Text::index() {
+    if (!m_indexed) {
+        m_index.rebuild(m_text);
+        m_indexed = true;
+    }
+    return m_index;
+}
+
+std::pmr::string&
+Text::editable() {
+    if (m_editable == nullptr || m_storage.use_count() != 1) {
+        auto storage = std::allocate_shared<std::pmr::string>(m_alloc, m_text);
+        m_editable = storage.get();
+        m_storage = std::move(storage);
+    }
+    return *m_editable;
+}
+
 } // namespace eltau::ascii
+
+namespace eltau::utf8 {
+
+Text::Text(std::string_view text, std::size_t wrap_limit) :
+    Text(std::make_shared<const std::string>(text), wrap_limit) {}
+
+Text::Text(std::shared_ptr<const std::string> text, std::size_t wrap_limit) :
+    m_storage(std::move(text)), m_text(m_storage ? std::string_view{*m_storage} : std::string_view{}),
+    m_wrap_limit(wrap_limit) {}
+
+Text::Text(BorrowTag, std::string_view text, std::size_t wrap_limit) : m_text(text), m_wrap_limit(wrap_limit) {}
+
+Vec2
+Text::do_calc_pref_size(Vec2 max_size) {
+    assert(max_size.m_row > 0 && max_size.m_col > 0);
+
+    auto limit{std::min(max_size.m_col, m_wrap_limit)};
+
+    return min(index().size(limit), max_size);
+}
+
+void
+Text::do_draw(DrawingWindow& window) {
+    const auto limit{std::min(window.size().m_col, m_wrap_limit)};
+    const auto origin{window.origin()};
+
+    for (std::size_t r = 0; r < window.size().m_row; ++r) {
+        const auto seg = index().line(r, limit);
+        draw_utf8_line(window.line(origin.m_row + r), m_text.substr(seg.m_begin, seg.m_length));
+    }
+}
+
+LineIndex&
+Text::index() {
+    if (!m_indexed) {
+        m_index.rebuild(m_text);
+        m_indexed = true;
+    }
+    return m_index;
+}
+
+} // namespace eltau::utf8
@@ -0,0 +1,178 @@
+/*******************************************************************************
+ * @file timer_wheel.cpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+#include <algorithm>
+#include <bit>
+
+#include <eltau/timer_wheel.hpp>
+
+namespace eltau {
+namespace {
+/*! Level of the entries expired but not reported yet. */
+constexpr std::uint8_t c_expired_level = TimerWheel::c_levels;
+constexpr std::uint64_t c_slot_mask = TimerWheel::c_slots - 1;
+/*! Ticks covered by all the levels. */
+constexpr std::uint64_t c_span = std::uint64_t{1} << (TimerWheel::c_slot_bits * TimerWheel::c_levels);
+} // namespace
+
+TimerWheel::Entry::~Entry() noexcept {
+    cancel();
+}
+
+bool
+TimerWheel::Entry::pending() const noexcept {
+    return m_wheel != nullptr;
+}
+
+void
+TimerWheel::Entry::cancel() noexcept {
+    if (m_wheel != nullptr)
+        m_wheel->remove(*this);
+}
+
+TimerWheel::TimerWheel(std::chrono::nanoseconds tick, Clock::time_point start) noexcept :
+    m_tick(std::max(tick, std::chrono::nanoseconds{1})), m_start(start) {
+    // Empty circular lists.
+    for (auto& level : m_levels)
+        for (auto& slot : level.m_slots)
+            slot.m_prev = slot.m_next = &slot;
+    m_expired.m_prev = m_expired.m_next = &m_expired;
+}
+
+TimerWheel::~TimerWheel() noexcept {
+    for (auto& level : m_levels)
+        for (auto& slot : level.m_slots)
+            while (slot.m_next != &slot)
+                remove(*slot.m_next);
+    while (m_expired.m_next != &m_expired)
+        remove(*m_expired.m_next);
+}
+
+void
+TimerWheel::schedule(Entry& entry, Clock::time_point deadline) noexcept {
+    entry.cancel();
+    // Rounded up, timers never expire early.
+    const auto ticks = deadline <= m_start ? 0 : (deadline - m_start + m_tick - std::chrono::nanoseconds{1}) / m_tick;
+    entry.m_tick = std::max(static_cast<std::uint64_t>(ticks), m_next);
+    entry.m_wheel = this;
+    insert(entry);
+    ++m_size;
+}
+
+std::optional<TimerWheel::Clock::time_point>
+TimerWheel::next_deadline() const noexcept {
+    if (m_size == 0 && m_expired.m_next == &m_expired)
+        return std::nullopt;
+    if (m_expired.m_next != &m_expired)
+        return m_start + static_cast<std::int64_t>(m_next) * m_tick;
+
+    // Occupied level-0 slots of the current lap, the lap ends with a cascade.
+    const auto idx = m_next & c_slot_mask;
+    const auto ahead = m_levels[0].m_occupied >> idx;
+    const auto tick = ahead != 0 ? m_next + static_cast<std::uint64_t>(std::countr_zero(ahead))
+                                 : (m_next | c_slot_mask) + 1;
+    return m_start + static_cast<std::int64_t>(tick) * m_tick;
+}
+
+std::size_t
+TimerWheel::size() const noexcept {
+    return m_size;
+}
+
+std::chrono::nanoseconds
+TimerWheel::tick() const noexcept {
+    return m_tick;
+}
+
+void
+TimerWheel::insert(Entry& entry) noexcept {
+    // Beyond the last level, cascaded again until close enough.
+    const auto delta = std::min(entry.m_tick - m_next, c_span - 1);
+    std::size_t level = 0;
+    while (level + 1 < c_levels && delta >= (std::uint64_t{1} << (c_slot_bits * (level + 1))))
+        ++level;
+    const auto tick = m_next + delta;
+    const auto slot = (tick >> (c_slot_bits * level)) & c_slot_mask;
+
+    auto& head = m_levels[level].m_slots[slot];
+    entry.m_level = static_cast<std::uint8_t>(level);
+    entry.m_slot = static_cast<std::uint8_t>(slot);
+    entry.m_prev = head.m_prev;
+    entry.m_next = &head;
+    head.m_prev->m_next = &entry;
+    head.m_prev = &entry;
+    m_levels[level].m_occupied |= std::uint64_t{1} << slot;
+}
+
+void
+TimerWheel::remove(Entry& entry) noexcept {
+    entry.m_prev->m_next = entry.m_next;
+    entry.m_next->m_prev = entry.m_prev;
+    if (entry.m_level != c_expired_level) {
+        auto& level = m_levels[entry.m_level];
+        auto& head = level.m_slots[entry.m_slot];
+        if (head.m_next == &head)
+            level.m_occupied &= ~(std::uint64_t{1} << entry.m_slot);
+        --m_size;
+    }
+    entry.m_wheel = nullptr;
+    entry.m_prev = entry.m_next = nullptr;
+}
+
+void
+TimerWheel::cascade(std::size_t level) noexcept {
+    const auto slot = (m_next >> (c_slot_bits * level)) & c_slot_mask;
+    auto& head = m_levels[level].m_slots[slot];
+    if (head.m_next == &head)
+        return;
+    m_levels[level].m_occupied &= ~(std::uint64_t{1} << slot);
+
+    // Detach the list first, entries may land in the same slot again.
+    auto* entry = head.m_next;
+    head.m_prev->m_next = nullptr;
+    head.m_prev = head.m_next = &head;
+    while (entry != nullptr) {
+        auto* next = entry->m_next;
+        insert(*entry);
+        entry = next;
+    }
+}
+
+void
+TimerWheel::step() noexcept {
+    // Higher levels are cascaded whenever the lower ones wrap around.
+    for (std::size_t level = 1; level < c_levels; ++level) {
+        if ((m_next & ((std::uint64_t{1} << (c_slot_bits * level)) - 1)) != 0)
+            break;
+        cascade(level);
+    }
+
+    const auto slot = m_next & c_slot_mask;
+    auto& head = m_levels[0].m_slots[slot];
+    for (auto* entry = head.m_next; entry != &head;) {
+        auto* next = entry->m_next;
+        // Later laps share the slot.
+        if (entry->m_tick <= m_next) {
+            remove(*entry);
+            entry->m_wheel = this;
+            entry->m_level = c_expired_level;
+            entry->m_prev = m_expired.m_prev;
+            entry->m_next = &m_expired;
+            m_expired.m_prev->m_next = entry;
+            m_expired.m_prev = entry;
+        }
+        entry = next;
+    }
+    ++m_next;
+}
+
+std::uint64_t
+TimerWheel::to_tick(Clock::time_point time) const noexcept {
+    if (time <= m_start)
+        return 0;
+    return static_cast<std::uint64_t>((time - m_start) / m_tick);
+}
+
+} // namespace eltau
@@ -0,0 +1,190 @@
+/*******************************************************************************
+ * @file unicode_data.hpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ *
+ * Generated by scripts/gen_unicode_data.py from Unicode 14.0.0, do not edit.
+ ******************************************************************************/
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace eltau::utf8::detail {
+
+/*! Code point range sharing the same properties. */
+struct PropRange {
+    char32_t m_first;
+    char32_t m_last;
+    /*! Bits 0-1 width, bits 2-4 GraphemeClass. */
+    std::uint8_t m_props;
+};
+
+/*! Properties of code points not covered by c_prop_ranges - width 1, GraphemeClass::Other. */
+inline constexpr std::uint8_t c_default_props = 1;
+
+/*! Sorted, non-overlapping ranges. */
+inline constexpr std::array<PropRange, 783> c_prop_ranges{{
+    {0x0, 0x1F, 5}, {0x7F, 0x9F, 5}, {0xA9, 0xA9, 21}, {0xAD, 0xAD, 5}, {0xAE, 0xAE, 21}, {0x300, 0x36F, 8},
+    {0x483, 0x489, 8}, {0x591, 0x5BD, 8}, {0x5BF, 0x5BF, 8}, {0x5C1, 0x5C2, 8}, {0x5C4, 0x5C5, 8}, {0x5C7, 0x5C7, 8},
+    {0x600, 0x605, 4}, {0x610, 0x61A, 8}, {0x61C, 0x61C, 4}, {0x64B, 0x65F, 8}, {0x670, 0x670, 8}, {0x6D6, 0x6DC, 8},
+    {0x6DD, 0x6DD, 4}, {0x6DF, 0x6E4, 8}, {0x6E7, 0x6E8, 8}, {0x6EA, 0x6ED, 8}, {0x70F, 0x70F, 4}, {0x711, 0x711, 8},
+    {0x730, 0x74A, 8}, {0x7A6, 0x7B0, 8}, {0x7EB, 0x7F3, 8}, {0x7FD, 0x7FD, 8}, {0x816, 0x819, 8}, {0x81B, 0x823, 8},
+    {0x825, 0x827, 8}, {0x829, 0x82D, 8}, {0x859, 0x85B, 8}, {0x890, 0x891, 4}, {0x898, 0x89F, 8}, {0x8CA, 0x8E1, 8},
+    {0x8E2, 0x8E2, 4}, {0x8E3, 0x902, 8}, {0x903, 0x903, 25}, {0x93A, 0x93A, 8}, {0x93B, 0x93B, 25}, {0x93C, 0x93C, 8},
+    {0x93E, 0x940, 25}, {0x941, 0x948, 8}, {0x949, 0x94C, 25}, {0x94D, 0x94D, 8}, {0x94E, 0x94F, 25}, {0x951, 0x957, 8},
+    {0x962, 0x963, 8}, {0x981, 0x981, 8}, {0x982, 0x983, 25}, {0x9BC, 0x9BC, 8}, {0x9BE, 0x9C0, 25}, {0x9C1, 0x9C4, 8},
+    {0x9C7, 0x9C8, 25}, {0x9CB, 0x9CC, 25}, {0x9CD, 0x9CD, 8}, {0x9D7, 0x9D7, 25}, {0x9E2, 0x9E3, 8}, {0x9FE, 0x9FE, 8},
+    {0xA01, 0xA02, 8}, {0xA03, 0xA03, 25}, {0xA3C, 0xA3C, 8}, {0xA3E, 0xA40, 25}, {0xA41, 0xA42, 8}, {0xA47, 0xA48, 8},
+    {0xA4B, 0xA4D, 8}, {0xA51, 0xA51, 8}, {0xA70, 0xA71, 8}, {0xA75, 0xA75, 8}, {0xA81, 0xA82, 8}, {0xA83, 0xA83, 25},
+    {0xABC, 0xABC, 8}, {0xABE, 0xAC0, 25}, {0xAC1, 0xAC5, 8}, {0xAC7, 0xAC8, 8}, {0xAC9, 0xAC9, 25}, {0xACB, 0xACC, 25},
+    {0xACD, 0xACD, 8}, {0xAE2, 0xAE3, 8}, {0xAFA, 0xAFF, 8}, {0xB01, 0xB01, 8}, {0xB02, 0xB03, 25}, {0xB3C, 0xB3C, 8},
+    {0xB3E, 0xB3E, 25}, {0xB3F, 0xB3F, 8}, {0xB40, 0xB40, 25}, {0xB41, 0xB44, 8}, {0xB47, 0xB48, 25},
+    {0xB4B, 0xB4C, 25}, {0xB4D, 0xB4D, 8}, {0xB55, 0xB56, 8}, {0xB57, 0xB57, 25}, {0xB62, 0xB63, 8}, {0xB82, 0xB82, 8},
+    {0xBBE, 0xBBF, 25}, {0xBC0, 0xBC0, 8}, {0xBC1, 0xBC2, 25}, {0xBC6, 0xBC8, 25}, {0xBCA, 0xBCC, 25},
+    {0xBCD, 0xBCD, 8}, {0xBD7, 0xBD7, 25}, {0xC00, 0xC00, 8}, {0xC01, 0xC03, 25}, {0xC04, 0xC04, 8}, {0xC3C, 0xC3C, 8},
+    {0xC3E, 0xC40, 8}, {0xC41, 0xC44, 25}, {0xC46, 0xC48, 8}, {0xC4A, 0xC4D, 8}, {0xC55, 0xC56, 8}, {0xC62, 0xC63, 8},
+    {0xC81, 0xC81, 8}, {0xC82, 0xC83, 25}, {0xCBC, 0xCBC, 8}, {0xCBE, 0xCBE, 25}, {0xCBF, 0xCBF, 8}, {0xCC0, 0xCC4, 25},
+    {0xCC6, 0xCC6, 8}, {0xCC7, 0xCC8, 25}, {0xCCA, 0xCCB, 25}, {0xCCC, 0xCCD, 8}, {0xCD5, 0xCD6, 25}, {0xCE2, 0xCE3, 8},
+    {0xD00, 0xD01, 8}, {0xD02, 0xD03, 25}, {0xD3B, 0xD3C, 8}, {0xD3E, 0xD40, 25}, {0xD41, 0xD44, 8}, {0xD46, 0xD48, 25},
+    {0xD4A, 0xD4C, 25}, {0xD4D, 0xD4D, 8}, {0xD57, 0xD57, 25}, {0xD62, 0xD63, 8}, {0xD81, 0xD81, 8}, {0xD82, 0xD83, 25},
+    {0xDCA, 0xDCA, 8}, {0xDCF, 0xDD1, 25}, {0xDD2, 0xDD4, 8}, {0xDD6, 0xDD6, 8}, {0xDD8, 0xDDF, 25}, {0xDF2, 0xDF3, 25},
+    {0xE31, 0xE31, 8}, {0xE34, 0xE3A, 8}, {0xE47, 0xE4E, 8}, {0xEB1, 0xEB1, 8}, {0xEB4, 0xEBC, 8}, {0xEC8, 0xECD, 8},
+    {0xF18, 0xF19, 8}, {0xF35, 0xF35, 8}, {0xF37, 0xF37, 8}, {0xF39, 0xF39, 8}, {0xF3E, 0xF3F, 25}, {0xF71, 0xF7E, 8},
+    {0xF7F, 0xF7F, 25}, {0xF80, 0xF84, 8}, {0xF86, 0xF87, 8}, {0xF8D, 0xF97, 8}, {0xF99, 0xFBC, 8}, {0xFC6, 0xFC6, 8},
+    {0x102B, 0x102C, 25}, {0x102D, 0x1030, 8}, {0x1031, 0x1031, 25}, {0x1032, 0x1037, 8}, {0x1038, 0x1038, 25},
+    {0x1039, 0x103A, 8}, {0x103B, 0x103C, 25}, {0x103D, 0x103E, 8}, {0x1056, 0x1057, 25}, {0x1058, 0x1059, 8},
+    {0x105E, 0x1060, 8}, {0x1062, 0x1064, 25}, {0x1067, 0x106D, 25}, {0x1071, 0x1074, 8}, {0x1082, 0x1082, 8},
+    {0x1083, 0x1084, 25}, {0x1085, 0x1086, 8}, {0x1087, 0x108C, 25}, {0x108D, 0x108D, 8}, {0x108F, 0x108F, 25},
+    {0x109A, 0x109C, 25}, {0x109D, 0x109D, 8}, {0x1100, 0x115F, 2}, {0x1160, 0x11FF, 8}, {0x135D, 0x135F, 8},
+    {0x1712, 0x1714, 8}, {0x1715, 0x1715, 25}, {0x1732, 0x1733, 8}, {0x1734, 0x1734, 25}, {0x1752, 0x1753, 8},
+    {0x1772, 0x1773, 8}, {0x17B4, 0x17B5, 8}, {0x17B6, 0x17B6, 25}, {0x17B7, 0x17BD, 8}, {0x17BE, 0x17C5, 25},
+    {0x17C6, 0x17C6, 8}, {0x17C7, 0x17C8, 25}, {0x17C9, 0x17D3, 8}, {0x17DD, 0x17DD, 8}, {0x180B, 0x180D, 8},
+    {0x180E, 0x180E, 4}, {0x180F, 0x180F, 8}, {0x1885, 0x1886, 8}, {0x18A9, 0x18A9, 8}, {0x1920, 0x1922, 8},
+    {0x1923, 0x1926, 25}, {0x1927, 0x1928, 8}, {0x1929, 0x192B, 25}, {0x1930, 0x1931, 25}, {0x1932, 0x1932, 8},
+    {0x1933, 0x1938, 25}, {0x1939, 0x193B, 8}, {0x1A17, 0x1A18, 8}, {0x1A19, 0x1A1A, 25}, {0x1A1B, 0x1A1B, 8},
+    {0x1A55, 0x1A55, 25}, {0x1A56, 0x1A56, 8}, {0x1A57, 0x1A57, 25}, {0x1A58, 0x1A5E, 8}, {0x1A60, 0x1A60, 8},
+    {0x1A61, 0x1A61, 25}, {0x1A62, 0x1A62, 8}, {0x1A63, 0x1A64, 25}, {0x1A65, 0x1A6C, 8}, {0x1A6D, 0x1A72, 25},
+    {0x1A73, 0x1A7C, 8}, {0x1A7F, 0x1A7F, 8}, {0x1AB0, 0x1ACE, 8}, {0x1B00, 0x1B03, 8}, {0x1B04, 0x1B04, 25},
+    {0x1B34, 0x1B34, 8}, {0x1B35, 0x1B35, 25}, {0x1B36, 0x1B3A, 8}, {0x1B3B, 0x1B3B, 25}, {0x1B3C, 0x1B3C, 8},
+    {0x1B3D, 0x1B41, 25}, {0x1B42, 0x1B42, 8}, {0x1B43, 0x1B44, 25}, {0x1B6B, 0x1B73, 8}, {0x1B80, 0x1B81, 8},
+    {0x1B82, 0x1B82, 25}, {0x1BA1, 0x1BA1, 25}, {0x1BA2, 0x1BA5, 8}, {0x1BA6, 0x1BA7, 25}, {0x1BA8, 0x1BA9, 8},
+    {0x1BAA, 0x1BAA, 25}, {0x1BAB, 0x1BAD, 8}, {0x1BE6, 0x1BE6, 8}, {0x1BE7, 0x1BE7, 25}, {0x1BE8, 0x1BE9, 8},
+    {0x1BEA, 0x1BEC, 25}, {0x1BED, 0x1BED, 8}, {0x1BEE, 0x1BEE, 25}, {0x1BEF, 0x1BF1, 8}, {0x1BF2, 0x1BF3, 25},
+    {0x1C24, 0x1C2B, 25}, {0x1C2C, 0x1C33, 8}, {0x1C34, 0x1C35, 25}, {0x1C36, 0x1C37, 8}, {0x1CD0, 0x1CD2, 8},
+    {0x1CD4, 0x1CE0, 8}, {0x1CE1, 0x1CE1, 25}, {0x1CE2, 0x1CE8, 8}, {0x1CED, 0x1CED, 8}, {0x1CF4, 0x1CF4, 8},
+    {0x1CF7, 0x1CF7, 25}, {0x1CF8, 0x1CF9, 8}, {0x1DC0, 0x1DFF, 8}, {0x200B, 0x200B, 4}, {0x200C, 0x200C, 8},
+    {0x200D, 0x200D, 12}, {0x200E, 0x200F, 4}, {0x2028, 0x2029, 5}, {0x202A, 0x202E, 4}, {0x203C, 0x203C, 21},
+    {0x2049, 0x2049, 21}, {0x2060, 0x2064, 4}, {0x2066, 0x206F, 4}, {0x20D0, 0x20F0, 8}, {0x2122, 0x2122, 21},
+    {0x2139, 0x2139, 21}, {0x2194, 0x2199, 21}, {0x21A9, 0x21AA, 21}, {0x231A, 0x231B, 22}, {0x2328, 0x2328, 21},
+    {0x2329, 0x232A, 2}, {0x2388, 0x2388, 21}, {0x23CF, 0x23CF, 21}, {0x23E9, 0x23EC, 22}, {0x23ED, 0x23EF, 21},
+    {0x23F0, 0x23F0, 22}, {0x23F1, 0x23F2, 21}, {0x23F3, 0x23F3, 22}, {0x23F8, 0x23FA, 21}, {0x24C2, 0x24C2, 21},
+    {0x25AA, 0x25AB, 21}, {0x25B6, 0x25B6, 21}, {0x25C0, 0x25C0, 21}, {0x25FB, 0x25FC, 21}, {0x25FD, 0x25FE, 22},
+    {0x2600, 0x2605, 21}, {0x2607, 0x2612, 21}, {0x2614, 0x2615, 22}, {0x2616, 0x2647, 21}, {0x2648, 0x2653, 22},
+    {0x2654, 0x267E, 21}, {0x267F, 0x267F, 22}, {0x2680, 0x2685, 21}, {0x2690, 0x2692, 21}, {0x2693, 0x2693, 22},
+    {0x2694, 0x26A0, 21}, {0x26A1, 0x26A1, 22}, {0x26A2, 0x26A9, 21}, {0x26AA, 0x26AB, 22}, {0x26AC, 0x26BC, 21},
+    {0x26BD, 0x26BE, 22}, {0x26BF, 0x26C3, 21}, {0x26C4, 0x26C5, 22}, {0x26C6, 0x26CD, 21}, {0x26CE, 0x26CE, 22},
+    {0x26CF, 0x26D3, 21}, {0x26D4, 0x26D4, 22}, {0x26D5, 0x26E9, 21}, {0x26EA, 0x26EA, 22}, {0x26EB, 0x26F1, 21},
+    {0x26F2, 0x26F3, 22}, {0x26F4, 0x26F4, 21}, {0x26F5, 0x26F5, 22}, {0x26F6, 0x26F9, 21}, {0x26FA, 0x26FA, 22},
+    {0x26FB, 0x26FC, 21}, {0x26FD, 0x26FD, 22}, {0x26FE, 0x2704, 21}, {0x2705, 0x2705, 22}, {0x2708, 0x2709, 21},
+    {0x270A, 0x270B, 22}, {0x270C, 0x2712, 21}, {0x2714, 0x2714, 21}, {0x2716, 0x2716, 21}, {0x271D, 0x271D, 21},
+    {0x2721, 0x2721, 21}, {0x2728, 0x2728, 22}, {0x2733, 0x2734, 21}, {0x2744, 0x2744, 21}, {0x2747, 0x2747, 21},
+    {0x274C, 0x274C, 22}, {0x274E, 0x274E, 22}, {0x2753, 0x2755, 22}, {0x2757, 0x2757, 22}, {0x2763, 0x2767, 21},
+    {0x2795, 0x2797, 22}, {0x27A1, 0x27A1, 21}, {0x27B0, 0x27B0, 22}, {0x27BF, 0x27BF, 22}, {0x2934, 0x2935, 21},
+    {0x2B05, 0x2B07, 21}, {0x2B1B, 0x2B1C, 22}, {0x2B50, 0x2B50, 22}, {0x2B55, 0x2B55, 22}, {0x2CEF, 0x2CF1, 8},
+    {0x2D7F, 0x2D7F, 8}, {0x2DE0, 0x2DFF, 8}, {0x2E80, 0x2E99, 2}, {0x2E9B, 0x2EF3, 2}, {0x2F00, 0x2FD5, 2},
+    {0x2FF0, 0x2FFB, 2}, {0x3000, 0x3029, 2}, {0x302A, 0x302D, 8}, {0x302E, 0x302F, 26}, {0x3030, 0x3030, 22},
+    {0x3031, 0x303C, 2}, {0x303D, 0x303D, 22}, {0x303E, 0x303E, 2}, {0x3041, 0x3096, 2}, {0x3099, 0x309A, 8},
+    {0x309B, 0x30FF, 2}, {0x3105, 0x312F, 2}, {0x3131, 0x318E, 2}, {0x3190, 0x31E3, 2}, {0x31F0, 0x321E, 2},
+    {0x3220, 0x3247, 2}, {0x3250, 0x3296, 2}, {0x3297, 0x3297, 22}, {0x3298, 0x3298, 2}, {0x3299, 0x3299, 22},
+    {0x329A, 0x4DBF, 2}, {0x4E00, 0xA48C, 2}, {0xA490, 0xA4C6, 2}, {0xA66F, 0xA672, 8}, {0xA674, 0xA67D, 8},
+    {0xA69E, 0xA69F, 8}, {0xA6F0, 0xA6F1, 8}, {0xA802, 0xA802, 8}, {0xA806, 0xA806, 8}, {0xA80B, 0xA80B, 8},
+    {0xA823, 0xA824, 25}, {0xA825, 0xA826, 8}, {0xA827, 0xA827, 25}, {0xA82C, 0xA82C, 8}, {0xA880, 0xA881, 25},
+    {0xA8B4, 0xA8C3, 25}, {0xA8C4, 0xA8C5, 8}, {0xA8E0, 0xA8F1, 8}, {0xA8FF, 0xA8FF, 8}, {0xA926, 0xA92D, 8},
+    {0xA947, 0xA951, 8}, {0xA952, 0xA953, 25}, {0xA960, 0xA97C, 2}, {0xA980, 0xA982, 8}, {0xA983, 0xA983, 25},
+    {0xA9B3, 0xA9B3, 8}, {0xA9B4, 0xA9B5, 25}, {0xA9B6, 0xA9B9, 8}, {0xA9BA, 0xA9BB, 25}, {0xA9BC, 0xA9BD, 8},
+    {0xA9BE, 0xA9C0, 25}, {0xA9E5, 0xA9E5, 8}, {0xAA29, 0xAA2E, 8}, {0xAA2F, 0xAA30, 25}, {0xAA31, 0xAA32, 8},
+    {0xAA33, 0xAA34, 25}, {0xAA35, 0xAA36, 8}, {0xAA43, 0xAA43, 8}, {0xAA4C, 0xAA4C, 8}, {0xAA4D, 0xAA4D, 25},
+    {0xAA7B, 0xAA7B, 25}, {0xAA7C, 0xAA7C, 8}, {0xAA7D, 0xAA7D, 25}, {0xAAB0, 0xAAB0, 8}, {0xAAB2, 0xAAB4, 8},
+    {0xAAB7, 0xAAB8, 8}, {0xAABE, 0xAABF, 8}, {0xAAC1, 0xAAC1, 8}, {0xAAEB, 0xAAEB, 25}, {0xAAEC, 0xAAED, 8},
+    {0xAAEE, 0xAAEF, 25}, {0xAAF5, 0xAAF5, 25}, {0xAAF6, 0xAAF6, 8}, {0xABE3, 0xABE4, 25}, {0xABE5, 0xABE5, 8},
+    {0xABE6, 0xABE7, 25}, {0xABE8, 0xABE8, 8}, {0xABE9, 0xABEA, 25}, {0xABEC, 0xABEC, 25}, {0xABED, 0xABED, 8},
+    {0xAC00, 0xD7A3, 2}, {0xF900, 0xFA6D, 2}, {0xFA70, 0xFAD9, 2}, {0xFB1E, 0xFB1E, 8}, {0xFE00, 0xFE0F, 8},
+    {0xFE10, 0xFE19, 2}, {0xFE20, 0xFE2F, 8}, {0xFE30, 0xFE52, 2}, {0xFE54, 0xFE66, 2}, {0xFE68, 0xFE6B, 2},
+    {0xFEFF, 0xFEFF, 4}, {0xFF01, 0xFF60, 2}, {0xFFE0, 0xFFE6, 2}, {0xFFF9, 0xFFFB, 4}, {0x101FD, 0x101FD, 8},
+    {0x102E0, 0x102E0, 8}, {0x10376, 0x1037A, 8}, {0x10A01, 0x10A03, 8}, {0x10A05, 0x10A06, 8}, {0x10A0C, 0x10A0F, 8},
+    {0x10A38, 0x10A3A, 8}, {0x10A3F, 0x10A3F, 8}, {0x10AE5, 0x10AE6, 8}, {0x10D24, 0x10D27, 8}, {0x10EAB, 0x10EAC, 8},
+    {0x10F46, 0x10F50, 8}, {0x10F82, 0x10F85, 8}, {0x11000, 0x11000, 25}, {0x11001, 0x11001, 8}, {0x11002, 0x11002, 25},
+    {0x11038, 0x11046, 8}, {0x11070, 0x11070, 8}, {0x11073, 0x11074, 8}, {0x1107F, 0x11081, 8}, {0x11082, 0x11082, 25},
+    {0x110B0, 0x110B2, 25}, {0x110B3, 0x110B6, 8}, {0x110B7, 0x110B8, 25}, {0x110B9, 0x110BA, 8}, {0x110BD, 0x110BD, 4},
+    {0x110C2, 0x110C2, 8}, {0x110CD, 0x110CD, 4}, {0x11100, 0x11102, 8}, {0x11127, 0x1112B, 8}, {0x1112C, 0x1112C, 25},
+    {0x1112D, 0x11134, 8}, {0x11145, 0x11146, 25}, {0x11173, 0x11173, 8}, {0x11180, 0x11181, 8}, {0x11182, 0x11182, 25},
+    {0x111B3, 0x111B5, 25}, {0x111B6, 0x111BE, 8}, {0x111BF, 0x111C0, 25}, {0x111C9, 0x111CC, 8},
+    {0x111CE, 0x111CE, 25}, {0x111CF, 0x111CF, 8}, {0x1122C, 0x1122E, 25}, {0x1122F, 0x11231, 8},
+    {0x11232, 0x11233, 25}, {0x11234, 0x11234, 8}, {0x11235, 0x11235, 25}, {0x11236, 0x11237, 8}, {0x1123E, 0x1123E, 8},
+    {0x112DF, 0x112DF, 8}, {0x112E0, 0x112E2, 25}, {0x112E3, 0x112EA, 8}, {0x11300, 0x11301, 8}, {0x11302, 0x11303, 25},
+    {0x1133B, 0x1133C, 8}, {0x1133E, 0x1133F, 25}, {0x11340, 0x11340, 8}, {0x11341, 0x11344, 25},
+    {0x11347, 0x11348, 25}, {0x1134B, 0x1134D, 25}, {0x11357, 0x11357, 25}, {0x11362, 0x11363, 25},
+    {0x11366, 0x1136C, 8}, {0x11370, 0x11374, 8}, {0x11435, 0x11437, 25}, {0x11438, 0x1143F, 8}, {0x11440, 0x11441, 25},
+    {0x11442, 0x11444, 8}, {0x11445, 0x11445, 25}, {0x11446, 0x11446, 8}, {0x1145E, 0x1145E, 8}, {0x114B0, 0x114B2, 25},
+    {0x114B3, 0x114B8, 8}, {0x114B9, 0x114B9, 25}, {0x114BA, 0x114BA, 8}, {0x114BB, 0x114BE, 25}, {0x114BF, 0x114C0, 8},
+    {0x114C1, 0x114C1, 25}, {0x114C2, 0x114C3, 8}, {0x115AF, 0x115B1, 25}, {0x115B2, 0x115B5, 8},
+    {0x115B8, 0x115BB, 25}, {0x115BC, 0x115BD, 8}, {0x115BE, 0x115BE, 25}, {0x115BF, 0x115C0, 8}, {0x115DC, 0x115DD, 8},
+    {0x11630, 0x11632, 25}, {0x11633, 0x1163A, 8}, {0x1163B, 0x1163C, 25}, {0x1163D, 0x1163D, 8},
+    {0x1163E, 0x1163E, 25}, {0x1163F, 0x11640, 8}, {0x116AB, 0x116AB, 8}, {0x116AC, 0x116AC, 25}, {0x116AD, 0x116AD, 8},
+    {0x116AE, 0x116AF, 25}, {0x116B0, 0x116B5, 8}, {0x116B6, 0x116B6, 25}, {0x116B7, 0x116B7, 8}, {0x1171D, 0x1171F, 8},
+    {0x11720, 0x11721, 25}, {0x11722, 0x11725, 8}, {0x11726, 0x11726, 25}, {0x11727, 0x1172B, 8},
+    {0x1182C, 0x1182E, 25}, {0x1182F, 0x11837, 8}, {0x11838, 0x11838, 25}, {0x11839, 0x1183A, 8},
+    {0x11930, 0x11935, 25}, {0x11937, 0x11938, 25}, {0x1193B, 0x1193C, 8}, {0x1193D, 0x1193D, 25},
+    {0x1193E, 0x1193E, 8}, {0x11940, 0x11940, 25}, {0x11942, 0x11942, 25}, {0x11943, 0x11943, 8},
+    {0x119D1, 0x119D3, 25}, {0x119D4, 0x119D7, 8}, {0x119DA, 0x119DB, 8}, {0x119DC, 0x119DF, 25}, {0x119E0, 0x119E0, 8},
+    {0x119E4, 0x119E4, 25}, {0x11A01, 0x11A0A, 8}, {0x11A33, 0x11A38, 8}, {0x11A39, 0x11A39, 25}, {0x11A3B, 0x11A3E, 8},
+    {0x11A47, 0x11A47, 8}, {0x11A51, 0x11A56, 8}, {0x11A57, 0x11A58, 25}, {0x11A59, 0x11A5B, 8}, {0x11A8A, 0x11A96, 8},
+    {0x11A97, 0x11A97, 25}, {0x11A98, 0x11A99, 8}, {0x11C2F, 0x11C2F, 25}, {0x11C30, 0x11C36, 8}, {0x11C38, 0x11C3D, 8},
+    {0x11C3E, 0x11C3E, 25}, {0x11C3F, 0x11C3F, 8}, {0x11C92, 0x11CA7, 8}, {0x11CA9, 0x11CA9, 25}, {0x11CAA, 0x11CB0, 8},
+    {0x11CB1, 0x11CB1, 25}, {0x11CB2, 0x11CB3, 8}, {0x11CB4, 0x11CB4, 25}, {0x11CB5, 0x11CB6, 8}, {0x11D31, 0x11D36, 8},
+    {0x11D3A, 0x11D3A, 8}, {0x11D3C, 0x11D3D, 8}, {0x11D3F, 0x11D45, 8}, {0x11D47, 0x11D47, 8}, {0x11D8A, 0x11D8E, 25},
+    {0x11D90, 0x11D91, 8}, {0x11D93, 0x11D94, 25}, {0x11D95, 0x11D95, 8}, {0x11D96, 0x11D96, 25}, {0x11D97, 0x11D97, 8},
+    {0x11EF3, 0x11EF4, 8}, {0x11EF5, 0x11EF6, 25}, {0x13430, 0x13438, 4}, {0x16AF0, 0x16AF4, 8}, {0x16B30, 0x16B36, 8},
+    {0x16F4F, 0x16F4F, 8}, {0x16F51, 0x16F87, 25}, {0x16F8F, 0x16F92, 8}, {0x16FE0, 0x16FE3, 2}, {0x16FE4, 0x16FE4, 8},
+    {0x16FF0, 0x16FF1, 26}, {0x17000, 0x187F7, 2}, {0x18800, 0x18CD5, 2}, {0x18D00, 0x18D08, 2}, {0x1AFF0, 0x1AFF3, 2},
+    {0x1AFF5, 0x1AFFB, 2}, {0x1AFFD, 0x1AFFE, 2}, {0x1B000, 0x1B122, 2}, {0x1B150, 0x1B152, 2}, {0x1B164, 0x1B167, 2},
+    {0x1B170, 0x1B2FB, 2}, {0x1BC9D, 0x1BC9E, 8}, {0x1BCA0, 0x1BCA3, 4}, {0x1CF00, 0x1CF2D, 8}, {0x1CF30, 0x1CF46, 8},
+    {0x1D165, 0x1D166, 25}, {0x1D167, 0x1D169, 8}, {0x1D16D, 0x1D172, 25}, {0x1D173, 0x1D17A, 4}, {0x1D17B, 0x1D182, 8},
+    {0x1D185, 0x1D18B, 8}, {0x1D1AA, 0x1D1AD, 8}, {0x1D242, 0x1D244, 8}, {0x1DA00, 0x1DA36, 8}, {0x1DA3B, 0x1DA6C, 8},
+    {0x1DA75, 0x1DA75, 8}, {0x1DA84, 0x1DA84, 8}, {0x1DA9B, 0x1DA9F, 8}, {0x1DAA1, 0x1DAAF, 8}, {0x1E000, 0x1E006, 8},
+    {0x1E008, 0x1E018, 8}, {0x1E01B, 0x1E021, 8}, {0x1E023, 0x1E024, 8}, {0x1E026, 0x1E02A, 8}, {0x1E130, 0x1E136, 8},
+    {0x1E2AE, 0x1E2AE, 8}, {0x1E2EC, 0x1E2EF, 8}, {0x1E8D0, 0x1E8D6, 8}, {0x1E944, 0x1E94A, 8}, {0x1F000, 0x1F003, 21},
+    {0x1F004, 0x1F004, 22}, {0x1F005, 0x1F0CE, 21}, {0x1F0CF, 0x1F0CF, 22}, {0x1F0D0, 0x1F0FF, 21},
+    {0x1F10D, 0x1F10F, 21}, {0x1F12F, 0x1F12F, 21}, {0x1F16C, 0x1F171, 21}, {0x1F17E, 0x1F17F, 21},
+    {0x1F18E, 0x1F18E, 22}, {0x1F191, 0x1F19A, 22}, {0x1F1AD, 0x1F1E5, 21}, {0x1F1E6, 0x1F1FF, 17},
+    {0x1F200, 0x1F200, 2}, {0x1F201, 0x1F202, 22}, {0x1F203, 0x1F20F, 21}, {0x1F210, 0x1F219, 2},
+    {0x1F21A, 0x1F21A, 22}, {0x1F21B, 0x1F22E, 2}, {0x1F22F, 0x1F22F, 22}, {0x1F230, 0x1F231, 2},
+    {0x1F232, 0x1F23A, 22}, {0x1F23B, 0x1F23B, 2}, {0x1F23C, 0x1F23F, 21}, {0x1F240, 0x1F248, 2},
+    {0x1F249, 0x1F24F, 21}, {0x1F250, 0x1F251, 22}, {0x1F252, 0x1F25F, 21}, {0x1F260, 0x1F265, 22},
+    {0x1F266, 0x1F2FF, 21}, {0x1F300, 0x1F320, 22}, {0x1F321, 0x1F32C, 21}, {0x1F32D, 0x1F335, 22},
+    {0x1F336, 0x1F336, 21}, {0x1F337, 0x1F37C, 22}, {0x1F37D, 0x1F37D, 21}, {0x1F37E, 0x1F393, 22},
+    {0x1F394, 0x1F39F, 21}, {0x1F3A0, 0x1F3CA, 22}, {0x1F3CB, 0x1F3CE, 21}, {0x1F3CF, 0x1F3D3, 22},
+    {0x1F3D4, 0x1F3DF, 21}, {0x1F3E0, 0x1F3F0, 22}, {0x1F3F1, 0x1F3F3, 21}, {0x1F3F4, 0x1F3F4, 22},
+    {0x1F3F5, 0x1F3F7, 21}, {0x1F3F8, 0x1F3FA, 22}, {0x1F3FB, 0x1F3FF, 8}, {0x1F400, 0x1F43E, 22},
+    {0x1F43F, 0x1F43F, 21}, {0x1F440, 0x1F440, 22}, {0x1F441, 0x1F441, 21}, {0x1F442, 0x1F4FC, 22},
+    {0x1F4FD, 0x1F4FE, 21}, {0x1F4FF, 0x1F53D, 22}, {0x1F546, 0x1F54A, 21}, {0x1F54B, 0x1F54E, 22},
+    {0x1F54F, 0x1F54F, 21}, {0x1F550, 0x1F567, 22}, {0x1F568, 0x1F579, 21}, {0x1F57A, 0x1F57A, 22},
+    {0x1F57B, 0x1F594, 21}, {0x1F595, 0x1F596, 22}, {0x1F597, 0x1F5A3, 21}, {0x1F5A4, 0x1F5A4, 22},
+    {0x1F5A5, 0x1F5FA, 21}, {0x1F5FB, 0x1F64F, 22}, {0x1F680, 0x1F6C5, 22}, {0x1F6C6, 0x1F6CB, 21},
+    {0x1F6CC, 0x1F6CC, 22}, {0x1F6CD, 0x1F6CF, 21}, {0x1F6D0, 0x1F6D2, 22}, {0x1F6D3, 0x1F6D4, 21},
+    {0x1F6D5, 0x1F6D7, 22}, {0x1F6D8, 0x1F6DC, 21}, {0x1F6DD, 0x1F6DF, 22}, {0x1F6E0, 0x1F6EA, 21},
+    {0x1F6EB, 0x1F6EC, 22}, {0x1F6ED, 0x1F6F3, 21}, {0x1F6F4, 0x1F6FC, 22}, {0x1F6FD, 0x1F6FF, 21},
+    {0x1F774, 0x1F77F, 21}, {0x1F7D5, 0x1F7DF, 21}, {0x1F7E0, 0x1F7EB, 22}, {0x1F7EC, 0x1F7EF, 21},
+    {0x1F7F0, 0x1F7F0, 22}, {0x1F7F1, 0x1F7FF, 21}, {0x1F80C, 0x1F80F, 21}, {0x1F848, 0x1F84F, 21},
+    {0x1F85A, 0x1F85F, 21}, {0x1F888, 0x1F88F, 21}, {0x1F8AE, 0x1F8FF, 21}, {0x1F90C, 0x1F93A, 22},
+    {0x1F93C, 0x1F945, 22}, {0x1F947, 0x1F9FF, 22}, {0x1FA00, 0x1FA6F, 21}, {0x1FA70, 0x1FA74, 22},
+    {0x1FA75, 0x1FA77, 21}, {0x1FA78, 0x1FA7C, 22}, {0x1FA7D, 0x1FA7F, 21}, {0x1FA80, 0x1FA86, 22},
+    {0x1FA87, 0x1FA8F, 21}, {0x1FA90, 0x1FAAC, 22}, {0x1FAAD, 0x1FAAF, 21}, {0x1FAB0, 0x1FABA, 22},
+    {0x1FABB, 0x1FABF, 21}, {0x1FAC0, 0x1FAC5, 22}, {0x1FAC6, 0x1FACF, 21}, {0x1FAD0, 0x1FAD9, 22},
+    {0x1FADA, 0x1FADF, 21}, {0x1FAE0, 0x1FAE7, 22}, {0x1FAE8, 0x1FAEF, 21}, {0x1FAF0, 0x1FAF6, 22},
+    {0x1FAF7, 0x1FAFF, 21}, {0x1FC00, 0x1FFFD, 21}, {0x20000, 0x3FFFD, 2}, {0xE0001, 0xE0001, 4}, {0xE0020, 0xE007F, 4},
+    {0xE0100, 0xE01EF, 8},
+}};
+
+} // namespace eltau::utf8::detail
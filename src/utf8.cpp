@@ -0,0 +1,303 @@
+/*******************************************************************************
+ * @file utf8.cpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <eltau/utf8.hpp>
+
+#include "unicode_data.hpp"
+
+namespace eltau::utf8 {
+namespace {
+
+/*! Code points per second-level block. */
+constexpr std::size_t c_block_bits = 8;
+constexpr std::size_t c_block_size = std::size_t{1} << c_block_bits;
+/*! Number of first-level entries, covers the whole Unicode range. */
+constexpr std::size_t c_block_count = 0x110000 >> c_block_bits;
+
+using Block = std::array<std::uint8_t, c_block_size>;
+
+/*******************************************************************************
+ * @brief Two-level property table.
+ *
+ * `m_blocks[m_index[cp >> c_block_bits]][cp % c_block_size]` are the properties
+ * of `cp`. Blocks with uniform properties are shared, the rest is stored as-is -
+ * they are almost all unique anyway.
+ ******************************************************************************/
+template <std::size_t Capacity>
+struct PropTables {
+    std::array<std::uint8_t, c_block_count> m_index{};
+    std::array<Block, Capacity> m_blocks{};
+};
+
+/*******************************************************************************
+ * @brief Skip ranges that end before block @p idx.
+ *
+ * @param range Index of the first range to check, advanced.
+ ******************************************************************************/
+constexpr void
+skip_ranges(std::size_t idx, std::size_t& range) {
+    const auto& ranges = detail::c_prop_ranges;
+    while (range < ranges.size() && ranges[range].m_last < (idx << c_block_bits))
+        ++range;
+}
+
+/*******************************************************************************
+ * @brief Properties shared by all code points of block @p idx.
+ *
+ * @param range First range that can intersect the block, see skip_ranges().
+ * @return Negative if the properties differ.
+ ******************************************************************************/
+constexpr int
+uniform_props(std::size_t idx, std::size_t range) {
+    const auto& ranges = detail::c_prop_ranges;
+    const auto first = static_cast<char32_t>(idx << c_block_bits);
+    const auto last = static_cast<char32_t>(first + c_block_size - 1);
+
+    if (range == ranges.size() || ranges[range].m_first > last)
+        return detail::c_default_props;
+    if (ranges[range].m_first <= first && ranges[range].m_last >= last)
+        return ranges[range].m_props;
+    return -1;
+}
+
+/*******************************************************************************
+ * @brief Expand properties of block @p idx from the ranges.
+ *
+ * @param range First range that can intersect the block, see skip_ranges().
+ ******************************************************************************/
+constexpr Block
+make_block(std::size_t idx, std::size_t range) {
+    const auto& ranges = detail::c_prop_ranges;
+    const auto first = static_cast<char32_t>(idx << c_block_bits);
+    const auto last = static_cast<char32_t>(first + c_block_size - 1);
+
+    Block block{};
+    block.fill(detail::c_default_props);
+    for (auto r = range; r < ranges.size() && ranges[r].m_first <= last; ++r)
+        for (auto cp = std::max(first, ranges[r].m_first); cp <= std::min(last, ranges[r].m_last); ++cp)
+            block[cp - first] = ranges[r].m_props;
+    return block;
+}
+
+/*******************************************************************************
+ * @brief Build the tables, or just count the needed blocks if @p Capacity is 0.
+ ******************************************************************************/
+template <std::size_t Capacity>
+constexpr std::pair<PropTables<Capacity>, std::size_t>
+build_tables() {
+    PropTables<Capacity> tables;
+    std::size_t count = 0;
+    // Shared block for each uniform property value.
+    std::array<int, 256> uniform_blocks{};
+    uniform_blocks.fill(-1);
+
+    std::size_t range = 0;
+    for (std::size_t i = 0; i < c_block_count; ++i) {
+        skip_ranges(i, range);
+        std::size_t block = count;
+        if (const auto props = uniform_props(i, range); props >= 0) {
+            if (uniform_blocks[props] >= 0) {
+                block = static_cast<std::size_t>(uniform_blocks[props]);
+            } else {
+                uniform_blocks[props] = static_cast<int>(count++);
+                if constexpr (Capacity > 0)
+                    tables.m_blocks[block].fill(static_cast<std::uint8_t>(props));
+            }
+        } else {
+            ++count;
+            if constexpr (Capacity > 0)
+                tables.m_blocks[block] = make_block(i, range);
+        }
+        tables.m_index[i] = static_cast<std::uint8_t>(block);
+    }
+    return {tables, count};
+}
+
+/*! Number of needed blocks, sizes the final table. */
+constexpr std::size_t c_used_blocks = build_tables<0>().second;
+static_assert(c_used_blocks <= 256, "Block index must fit into uint8_t.");
+
+/*! Properties of all code points, generated at compile time. */
+constexpr auto c_tables = build_tables<c_used_blocks>().first;
+
+constexpr std::uint8_t
+props(char32_t cp) noexcept {
+    if (cp >= 0x110000)
+        return detail::c_default_props;
+    return c_tables.m_blocks[c_tables.m_index[cp >> c_block_bits]][cp % c_block_size];
+}
+
+static_assert((props(U'a') & 3) == 1 && (props(U'\u4E00') & 3) == 2 && (props(U'\u0301') & 3) == 0);
+static_assert(props(U'\U0001F600') >> 2 == static_cast<std::uint8_t>(GraphemeClass::ExtPict));
+
+} // namespace
+
+char32_t
+decode(std::string_view str, std::size_t& pos) noexcept {
+    const auto lead = static_cast<unsigned char>(str[pos]);
+    if (lead < 0x80) {
+        ++pos;
+        return lead;
+    }
+
+    std::size_t len = 0;
+    char32_t cp = 0;
+    char32_t min_cp = 0;
+    if ((lead & 0xE0U) == 0xC0U) {
+        len = 2;
+        cp = lead & 0x1FU;
+        min_cp = 0x80;
+    } else if ((lead & 0xF0U) == 0xE0U) {
+        len = 3;
+        cp = lead & 0x0FU;
+        min_cp = 0x800;
+    } else if ((lead & 0xF8U) == 0xF0U) {
+        len = 4;
+        cp = lead & 0x07U;
+        min_cp = 0x10000;
+    } else {
+        ++pos;
+        return c_replacement;
+    }
+
+    if (str.size() - pos < len) {
+        ++pos;
+        return c_replacement;
+    }
+    for (std::size_t i = 1; i < len; ++i) {
+        const auto b = static_cast<unsigned char>(str[pos + i]);
+        if ((b & 0xC0U) != 0x80U) {
+            ++pos;
+            return c_replacement;
+        }
+        cp = (cp << 6U) | (b & 0x3FU);
+    }
+    // Overlong encodings, surrogates and out-of-range values.
+    if (cp < min_cp || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) {
+        ++pos;
+        return c_replacement;
+    }
+    pos += len;
+    return cp;
+}
+
+std::size_t
+width(char32_t cp) noexcept {
+    return props(cp) & 3U;
+}
+
+GraphemeClass
+grapheme_class(char32_t cp) noexcept {
+    return static_cast<GraphemeClass>(props(cp) >> 2U);
+}
+
+std::size_t
+ascii_prefix(std::string_view str) noexcept {
+    std::size_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 16 <= str.size(); i += 16) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str.data() + i));
+        if (const auto mask = static_cast<unsigned>(_mm_movemask_epi8(chunk)); mask != 0)
+            return i + static_cast<std::size_t>(std::countr_zero(mask));
+    }
+#endif
+    constexpr std::uint64_t c_high_bits = 0x8080808080808080ULL;
+    for (; i + 8 <= str.size(); i += 8) {
+        std::uint64_t word = 0;
+        std::memcpy(&word, str.data() + i, sizeof(word));
+        if ((word & c_high_bits) != 0)
+            break;
+    }
+    while (i < str.size() && static_cast<unsigned char>(str[i]) < 0x80)
+        ++i;
+    return i;
+}
+
+bool
+is_ascii(std::string_view str) noexcept {
+    return ascii_prefix(str) == str.size();
+}
+
+Grapheme
+next_grapheme(std::string_view str, std::size_t pos) noexcept {
+    auto end = pos;
+    const auto base = decode(str, end);
+    const auto base_class = grapheme_class(base);
+
+    Grapheme g{.m_begin = pos, .m_length = 0, .m_width = 1, .m_control = false, .m_replaced = base == c_replacement};
+    // GB3-GB5: controls are never joined, apart from CR LF.
+    if (base_class == GraphemeClass::Control) {
+        if (base == '\r' && end < str.size() && str[end] == '\n')
+            ++end;
+        g.m_length = end - pos;
+        g.m_control = true;
+        return g;
+    }
+
+    g.m_width = std::max<std::size_t>(width(base), 1);
+    // Inside `ExtPict Extend*` or `... ZWJ` for GB11.
+    bool pict = base_class == GraphemeClass::ExtPict;
+    bool after_zwj = false;
+    // Odd number of regional indicators so far, GB12/13.
+    bool open_ri = base_class == GraphemeClass::RegionalIndicator;
+
+    while (end < str.size()) {
+        auto next_end = end;
+        const auto cp = decode(str, next_end);
+        const auto cls = grapheme_class(cp);
+
+        if (cls == GraphemeClass::Extend || cls == GraphemeClass::Zwj) { // GB9
+            // Emoji presentation selector.
+            if (cp == 0xFE0F && pict)
+                g.m_width = 2;
+        } else if (cls == GraphemeClass::SpacingMark) { // GB9a
+            pict = false;
+        } else if (cls == GraphemeClass::ExtPict && pict && after_zwj) { // GB11
+        } else if (cls == GraphemeClass::RegionalIndicator && open_ri) { // GB12, GB13
+            open_ri = false;
+            g.m_width = 2;
+        } else {
+            break;
+        }
+        after_zwj = cls == GraphemeClass::Zwj;
+        g.m_replaced = g.m_replaced || cp == c_replacement;
+        end = next_end;
+    }
+    g.m_length = end - pos;
+    return g;
+}
+
+std::size_t
+str_width(std::string_view str) noexcept {
+    std::size_t width = 0;
+    std::size_t pos = 0;
+    while (pos < str.size()) {
+        // All but the last ASCII character are whole graphemes, the last can be extended.
+        const auto ascii = ascii_prefix(str.substr(pos));
+        if (ascii > 1 || ascii == str.size() - pos) {
+            const auto n = ascii == str.size() - pos ? ascii : ascii - 1;
+            width += n;
+            pos += n;
+            continue;
+        }
+        const auto g = next_grapheme(str, pos);
+        width += g.m_width;
+        pos += g.m_length;
+    }
+    return width;
+}
+
+} // namespace eltau::utf8
@@ -0,0 +1,204 @@
+/*******************************************************************************
+ * @file virtual_list.cpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+#include <algorithm>
+#include <bit>
+
+#include <fmt/format.h>
+
+#include <eltau/exception.hpp>
+#include <eltau/virtual_list.hpp>
+
+namespace eltau {
+
+void
+PrefixSums::assign(std::size_t count, const std::function<std::size_t(std::size_t)>& value) {
+    m_tree.assign(count + 1, 0);
+    for (std::size_t i = 1; i <= count; ++i) {
+        m_tree[i] += value(i - 1);
+        // Propagate to the parent, O(n) in total.
+        if (const auto parent = i + (i & -i); parent <= count)
+            m_tree[parent] += m_tree[i];
+    }
+}
+
+std::size_t
+PrefixSums::size() const noexcept {
+    return m_tree.size() - 1;
+}
+
+void
+PrefixSums::set(std::size_t idx, std::size_t value) noexcept {
+    const auto old = at(idx);
+    for (auto i = idx + 1; i < m_tree.size(); i += i & -i)
+        m_tree[i] = m_tree[i] - old + value;
+}
+
+std::size_t
+PrefixSums::at(std::size_t idx) const noexcept {
+    return prefix(idx + 1) - prefix(idx);
+}
+
+std::size_t
+PrefixSums::prefix(std::size_t idx) const noexcept {
+    std::size_t sum = 0;
+    for (auto i = std::min(idx, size()); i > 0; i -= i & -i)
+        sum += m_tree[i];
+    return sum;
+}
+
+std::size_t
+PrefixSums::total() const noexcept {
+    return prefix(size());
+}
+
+std::size_t
+PrefixSums::find(std::size_t offset) const noexcept {
+    std::size_t pos = 0;
+    for (auto step = std::bit_floor(size()); step > 0; step >>= 1U) {
+        if (pos + step <= size() && m_tree[pos + step] <= offset) {
+            pos += step;
+            offset -= m_tree[pos];
+        }
+    }
+    return pos;
+}
+
+VirtualList::VirtualList(std::size_t count, RowFactory factory, RowHeight height) :
+    m_count(0), m_factory(std::move(factory)), m_height(std::move(height)) {
+    set_count(count);
+}
+
+void
+VirtualList::set_count(std::size_t count) {
+    m_count = count;
+    m_visible.clear();
+    if (m_height)
+        m_heights.assign(count, m_height);
+}
+
+std::size_t
+VirtualList::count() const noexcept {
+    return m_count;
+}
+
+void
+VirtualList::update_height(std::size_t row) {
+    if (m_height && row < m_count)
+        m_heights.set(row, m_height(row));
+}
+
+void
+VirtualList::refresh() noexcept {
+    m_visible.clear();
+}
+
+std::size_t
+VirtualList::content_height() const noexcept {
+    return m_height ? m_heights.total() : m_count;
+}
+
+std::size_t
+VirtualList::row_offset(std::size_t row) const noexcept {
+    return m_height ? m_heights.prefix(row) : std::min(row, m_count);
+}
+
+std::size_t
+VirtualList::row_at(std::size_t offset) const noexcept {
+    return m_height ? m_heights.find(offset) : std::min(offset, m_count);
+}
+
+void
+VirtualList::scroll_to(std::size_t offset) noexcept {
+    m_offset = offset;
+}
+
+void
+VirtualList::scroll_to_row(std::size_t row) noexcept {
+    m_offset = row_offset(row);
+}
+
+std::size_t
+VirtualList::offset() const noexcept {
+    return m_offset;
+}
+
+std::size_t
+VirtualList::live_rows() const noexcept {
+    return m_visible.size();
+}
+
+Vec2
+VirtualList::do_calc_pref_size(Vec2 max_size) {
+    return {.m_row = std::min(content_height(), max_size.m_row), .m_col = max_size.m_col};
+}
+
+void
+VirtualList::do_draw(DrawingWindow& window) {
+    const auto [rows, cols] = window.size();
+    const auto origin{window.origin()};
+    const auto total = content_height();
+    const auto offset = std::min(m_offset, total > rows ? total - rows : 0);
+    // Rows below the screen are neither created nor drawn.
+    const auto shown_rows = window.visible().size().m_row;
+
+    // Reuses the storage of the previous frame.
+    auto& visible = m_next;
+    visible.clear();
+    auto old = m_visible.begin();
+
+    std::size_t line = 0;
+    auto row = row_at(offset);
+    // Lines of the first row above the window.
+    auto skip = offset - row_offset(row);
+    for (; line < shown_rows && row < m_count; ++row) {
+        const auto h = m_height ? m_heights.at(row) : 1;
+        if (h == 0)
+            continue;
+
+        // Reuse the element if it was already visible, both are ordered by row.
+        while (old != m_visible.end() && old->first < row)
+            ++old;
+        auto elem = old != m_visible.end() && old->first == row ? std::move(old->second) : m_factory(row);
+        if (!elem)
+            throw EltauException{fmt::format("Factory returned null element for row {}", row)};
+
+        const auto shown = std::min(h - skip, shown_rows - line);
+        (void)elem->calc_pref_size({.m_row = h, .m_col = cols});
+        if (skip == 0) {
+            auto sub = window.sub_win({.m_row = line, .m_col = 0}, {.m_row = shown, .m_col = cols});
+            elem->draw(sub);
+        } else {
+            // Draw whole and copy the visible part.
+            Screen scratch{{.m_row = h, .m_col = cols}, window.scratch()};
+            DrawingWindow scratch_window{Window{{0, 0}, {h, cols}}, scratch, window.scratch()};
+            elem->draw(scratch_window);
+            for (std::size_t i = 0; i < shown; ++i) {
+                const auto src = scratch.line(skip + i);
+                auto dst = window.line(origin.m_row + line + i);
+                std::copy_n(src.begin(), std::min(src.size(), dst.size()), dst.begin());
+            }
+            // The row's children are not mapped, only the row itself.
+            if (auto* hits = window.hit_map())
+                hits->mark(window.sub_win({.m_row = line, .m_col = 0}, {.m_row = shown, .m_col = cols}).visible(),
+                           elem.get());
+        }
+        visible.emplace_back(row, std::move(elem));
+        line += shown;
+        skip = 0;
+    }
+
+    for (; line < shown_rows; ++line) {
+        for (auto& cell : window.line(origin.m_row + line)) {
+            cell = Cell{};
+            cell.m_char[0] = ' ';
+        }
+    }
+    std::swap(m_visible, visible);
+    // Rows that are no longer visible.
+    m_next.clear();
+}
+
+} // namespace eltau
@@ -0,0 +1,21 @@
+/*******************************************************************************
+ * @file screen_utils.hpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+#pragma once
+
+#include <string>
+
+#include <eltau/screen.hpp>
+
+/*******************************************************************************
+ * @brief Render one screen line into a string.
+ ******************************************************************************/
+inline std::string
+to_string(eltau::Screen::cLine line) {
+    std::string str;
+    for (const auto& c : line)
+        str += c.m_char.data();
+    return str;
+}
@@ -0,0 +1,206 @@
+/*******************************************************************************
+ * @file test_compositor.cpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+
+#include <memory>
+#include <string>
+
+#include <catch2/catch_test_macros.hpp>
+#include <eltau/compositor.hpp>
+#include <eltau/exception.hpp>
+
+#include "screen_utils.hpp"
+
+namespace et = eltau;
+
+namespace {
+/*! Fills its window with its character, counts the draws. */
+class Fill : public et::Element {
+public:
+    explicit Fill(char c) : m_char(c) {}
+
+    std::size_t m_measured = 0;
+    std::size_t m_drawn = 0;
+
+private:
+    et::Vec2
+    do_calc_pref_size(et::Vec2 max_size) override {
+        ++m_measured;
+        return max_size;
+    }
+    void
+    do_draw(et::DrawingWindow& window) override {
+        ++m_drawn;
+        for (std::size_t r = 0; r < window.size().m_row; ++r)
+            for (auto& cell : window.line(window.origin().m_row + r)) {
+                cell.m_char[0] = m_char;
+                cell.m_char[1] = 0;
+            }
+    }
+
+    char m_char;
+};
+
+/*! Number of cells in all the damaged rectangles. */
+std::size_t
+damaged_cells(const et::Compositor& compositor) {
+    std::size_t cells = 0;
+    for (const auto& rect : compositor.damage())
+        cells += rect.size().m_row * rect.size().m_col;
+    return cells;
+}
+} // namespace
+
+TEST_CASE("Compositor") {
+    et::Compositor compositor{{3, 6}};
+    auto base_elem = std::make_unique<Fill>('.');
+    auto& base = *base_elem;
+    const auto base_id = compositor.add_layer(std::move(base_elem), {{0, 0}, {3, 6}});
+
+    const auto& screen = compositor.compose();
+    REQUIRE(to_string(screen.line(0)) == "......");
+    REQUIRE(base.m_drawn == 1);
+
+    auto popup_elem = std::make_unique<Fill>('#');
+    auto& popup = *popup_elem;
+    const auto popup_id = compositor.add_layer(std::move(popup_elem), {{1, 1}, {2, 2}});
+
+    SECTION("Popups are composed over lower layers without redrawing them") {
+        (void)compositor.compose();
+        REQUIRE(to_string(screen.line(0)) == "......");
+        REQUIRE(to_string(screen.line(1)) == ".##...");
+        REQUIRE(to_string(screen.line(2)) == ".##...");
+        REQUIRE(base.m_drawn == 1);
+        REQUIRE(base.m_measured == 1);
+        REQUIRE(popup.m_drawn == 1);
+        REQUIRE(damaged_cells(compositor) == 4);
+
+        // Nothing changed.
+        (void)compositor.compose();
+        REQUIRE(compositor.damage().empty());
+    }
+    SECTION("Moving re-composes only the exposed rectangles") {
+        (void)compositor.compose();
+        compositor.move_layer(popup_id, {{0, 3}, {2, 2}});
+        (void)compositor.compose();
+        REQUIRE(to_string(screen.line(0)) == "...##.");
+        REQUIRE(to_string(screen.line(1)) == "...##.");
+        REQUIRE(to_string(screen.line(2)) == "......");
+        REQUIRE(base.m_drawn == 1);
+        REQUIRE(popup.m_drawn == 1);
+        REQUIRE(damaged_cells(compositor) == 8);
+
+        // Resizing lays the layer out again.
+        compositor.move_layer(popup_id, {{0, 3}, {1, 3}});
+        (void)compositor.compose();
+        REQUIRE(popup.m_drawn == 2);
+        REQUIRE(to_string(screen.line(0)) == "...###");
+        REQUIRE(to_string(screen.line(1)) == "......");
+    }
+    SECTION("Removing exposes lower layers") {
+        (void)compositor.compose();
+        REQUIRE(compositor.remove_layer(popup_id).get() == &popup);
+        (void)compositor.compose();
+        REQUIRE(to_string(screen.line(1)) == "......");
+        REQUIRE(compositor.layer_count() == 1);
+        REQUIRE(base.m_drawn == 1);
+    }
+    SECTION("Covered layers are not drawn") {
+        (void)compositor.add_layer(std::make_unique<Fill>('x'), {{0, 0}, {3, 6}});
+        compositor.invalidate(base_id);
+        compositor.invalidate(popup_id);
+        (void)compositor.compose();
+        REQUIRE(to_string(screen.line(1)) == "xxxxxx");
+        REQUIRE(base.m_drawn == 1);
+        REQUIRE(popup.m_drawn == 0);
+
+        // Drawn once exposed.
+        compositor.raise_layer(popup_id);
+        (void)compositor.compose();
+        REQUIRE(popup.m_drawn == 1);
+        REQUIRE(base.m_drawn == 1);
+        REQUIRE(to_string(screen.line(1)) == "x##xxx");
+    }
+    SECTION("Uncovered cells are blank") {
+        compositor.move_layer(base_id, {{0, 0}, {1, 6}});
+        (void)compositor.compose();
+        REQUIRE(to_string(screen.line(0)) == "......");
+        REQUIRE(to_string(screen.line(2)) == " ##   ");
+    }
+    SECTION("Areas are clipped by the screen") {
+        compositor.move_layer(popup_id, {{2, 5}, {4, 4}});
+        REQUIRE(compositor.area(popup_id) == et::Window{{2, 5}, {1, 1}});
+        (void)compositor.compose();
+        REQUIRE(to_string(screen.line(2)) == ".....#");
+    }
+    SECTION("Resizing clips the layers and re-composes everything") {
+        (void)compositor.compose();
+        compositor.resize({2, 2});
+        REQUIRE(compositor.area(base_id) == et::Window{{0, 0}, {2, 2}});
+        REQUIRE(compositor.area(popup_id) == et::Window{{1, 1}, {1, 1}});
+        (void)compositor.compose();
+        REQUIRE(to_string(screen.line(0)) == "..");
+        REQUIRE(to_string(screen.line(1)) == ".#");
+        REQUIRE(damaged_cells(compositor) == 4);
+        REQUIRE(base.m_drawn == 2);
+
+        // Growing restores the requested areas, it does not move the layers.
+        compositor.resize({3, 7});
+        REQUIRE(compositor.area(base_id) == et::Window{{0, 0}, {3, 6}});
+        REQUIRE(compositor.area(popup_id) == et::Window{{1, 1}, {2, 2}});
+        compositor.move_layer(base_id, {{0, 0}, {3, 7}});
+        (void)compositor.compose();
+        REQUIRE(to_string(screen.line(0)) == ".......");
+        REQUIRE(to_string(screen.line(1)) == ".##....");
+        REQUIRE(base.m_drawn == 3);
+    }
+    SECTION("Layers shrunk by a smaller screen grow back") {
+        compositor.resize({6, 20});
+        compositor.move_layer(base_id, {{0, 0}, {6, 20}});
+        compositor.move_layer(popup_id, {{1, 2}, {3, 12}});
+        (void)compositor.compose();
+
+        compositor.resize({6, 5});
+        REQUIRE(compositor.area(popup_id) == et::Window{{1, 2}, {3, 3}});
+        (void)compositor.compose();
+        compositor.resize({6, 20});
+        REQUIRE(compositor.area(base_id) == et::Window{{0, 0}, {6, 20}});
+        REQUIRE(compositor.area(popup_id) == et::Window{{1, 2}, {3, 12}});
+        (void)compositor.compose();
+        REQUIRE(to_string(screen.line(1)) == "..############......");
+
+        // Even from outside of the screen.
+        compositor.resize({1, 2});
+        REQUIRE(compositor.area(popup_id).size() == et::Vec2{0, 0});
+        (void)compositor.compose();
+        compositor.resize({6, 20});
+        REQUIRE(compositor.area(popup_id) == et::Window{{1, 2}, {3, 12}});
+        (void)compositor.compose();
+        REQUIRE(to_string(screen.line(3)) == "..############......");
+    }
+    SECTION("Pending damage stays bounded between frames") {
+        (void)compositor.compose();
+        for (int i = 0; i < 100; ++i)
+            compositor.invalidate(popup_id);
+        (void)compositor.compose();
+        REQUIRE(compositor.damage().size() == 1);
+
+        // Too many distinct rectangles re-compose the whole screen.
+        compositor.resize({3, 40});
+        (void)compositor.compose();
+        for (std::size_t i = 0; i <= et::Compositor::c_max_pending; ++i)
+            compositor.move_layer(popup_id, {{0, i}, {1, 1}});
+        (void)compositor.compose();
+        REQUIRE(compositor.damage().size() == 1);
+        REQUIRE(compositor.damage()[0] == et::Window{{0, 0}, {3, 40}});
+        REQUIRE(to_string(screen.line(0)) == "......" + std::string(10, ' ') + "#" + std::string(23, ' '));
+    }
+    SECTION("Unknown layers") {
+        REQUIRE_THROWS_AS(compositor.add_layer(nullptr, {{0, 0}, {1, 1}}), et::EltauException);
+        REQUIRE_THROWS_AS(compositor.invalidate(42), et::EltauException);
+        REQUIRE_THROWS_AS(compositor.remove_layer(42), et::EltauException);
+        REQUIRE(&compositor.root(base_id) == &base);
+    }
+}
@@ -4,8 +4,13 @@
  * @license	This file is released under ElTau project's license, see LICENSE.
  ******************************************************************************/
 
+#include <string>
+
 #include <catch2/catch_test_macros.hpp>
 #include <eltau/element.hpp>
+#include <eltau/text.hpp>
+
+#include "screen_utils.hpp"
 
 namespace et = eltau;
 
@@ -83,3 +88,131 @@ TEST_CASE("Element draw is called correctly") {
     DummyElement e;
     e.draw(exp_window);
 }
+
+TEST_CASE("Element draw is culled") {
+    class DummyElement : public et::Element {
+    private:
+        et::Vec2
+        do_calc_pref_size(et::Vec2 max_size) override {
+            return max_size;
+        }
+        void
+        do_draw(et::DrawingWindow& window) override {
+            (void)window;
+            FAIL_CHECK("do_draw must not be called");
+        }
+    };
+
+    et::Screen screen{{2, 2}};
+    DummyElement e;
+    et::DrawingWindow empty{et::Window{{0, 0}, {0, 2}}, screen};
+    e.draw(empty);
+    et::DrawingWindow clipped{et::Window{{2, 0}, {2, 2}}, screen};
+    e.draw(clipped);
+}
+
+namespace {
+/*! Fixed-size element filled with its character, does not befriend ElementAccess. */
+class Block : public et::Element {
+public:
+    Block(et::Vec2 size, char c) : m_size(size), m_char(c) {}
+
+private:
+    et::Vec2
+    do_calc_pref_size(et::Vec2 max_size) override {
+        return et::min(m_size, max_size);
+    }
+    void
+    do_draw(et::DrawingWindow& window) override {
+        for (std::size_t r = 0; r < window.size().m_row; ++r)
+            for (auto& cell : window.line(window.origin().m_row + r)) {
+                cell.m_char[0] = m_char;
+                cell.m_char[1] = 0;
+            }
+    }
+
+    et::Vec2 m_size;
+    char m_char;
+};
+
+/*! Counts calls, befriends ElementAccess. */
+class Counter : public et::Element {
+public:
+    explicit Counter(et::Vec2 size) : m_size(size) {}
+
+    std::size_t m_measured = 0;
+    std::size_t m_drawn = 0;
+
+private:
+    friend class et::ElementAccess;
+
+    et::Vec2
+    do_calc_pref_size(et::Vec2 max_size) override {
+        ++m_measured;
+        return et::min(m_size, max_size);
+    }
+    void
+    do_draw(et::DrawingWindow& window) override {
+        (void)window;
+        ++m_drawn;
+    }
+
+    et::Vec2 m_size;
+};
+
+} // namespace
+
+TEST_CASE("Static containers") {
+    SECTION("HContainer sums columns") {
+        et::HContainer c{Block{{2, 3}, 'a'}, Block{{1, 2}, 'b'}};
+        REQUIRE(c.calc_pref_size({10, 10}) == et::Vec2{2, 5});
+        REQUIRE(c.get<1>().get_last_pref_size() == et::Vec2{1, 2});
+        // The second one gets what remains.
+        REQUIRE(c.calc_pref_size({10, 4}) == et::Vec2{2, 4});
+        REQUIRE(c.get<1>().get_last_pref_size() == et::Vec2{1, 1});
+    }
+    SECTION("VContainer sums rows") {
+        et::VContainer c{Block{{2, 3}, 'a'}, Block{{1, 2}, 'b'}};
+        REQUIRE(c.calc_pref_size({10, 10}) == et::Vec2{3, 3});
+        REQUIRE(c.calc_pref_size({2, 10}) == et::Vec2{2, 3});
+        REQUIRE(c.get<1>().get_last_pref_size() == et::Vec2{0, 0});
+    }
+    SECTION("Nested containers draw children side by side") {
+        et::HContainer c{Block{{1, 1}, 'a'}, et::VContainer{Block{{1, 2}, 'b'}, Block{{2, 1}, 'c'}}, Block{{3, 1}, 'd'}};
+        REQUIRE(c.calc_pref_size({10, 10}) == et::Vec2{3, 4});
+
+        et::Screen screen{{3, 5}};
+        et::DrawingWindow window{et::Window{{0, 0}, {3, 5}}, screen};
+        c.draw(window);
+        REQUIRE(to_string(screen.line(0)) == "abbd+");
+        REQUIRE(to_string(screen.line(1)) == "accd+");
+        REQUIRE(to_string(screen.line(2)) == "accd+");
+    }
+    SECTION("Texts") {
+        et::VContainer c{et::HContainer{et::ascii::Text{"ab"}, et::ascii::Text{"c\nd"}}, et::ascii::Text{"efgh"}};
+        REQUIRE(c.calc_pref_size({10, 10}) == et::Vec2{3, 4});
+
+        et::Screen screen{{3, 4}};
+        et::DrawingWindow window{et::Window{{0, 0}, {3, 4}}, screen};
+        c.draw(window);
+        // Space right of the HContainer is not claimed by anyone.
+        REQUIRE(to_string(screen.line(0)) == "abc+");
+        REQUIRE(to_string(screen.line(1)) == "  d+");
+        REQUIRE(to_string(screen.line(2)) == "efgh");
+    }
+    SECTION("Children outside of the window are culled") {
+        et::HContainer c{Counter{{1, 3}}, Counter{{1, 2}}, Counter{{1, 2}}};
+        (void)c.calc_pref_size({1, 3});
+        REQUIRE(c.get<0>().m_measured == 1);
+        REQUIRE(c.get<1>().m_measured == 0);
+
+        // Measured for a larger screen than it is drawn to.
+        (void)c.calc_pref_size({1, 10});
+        et::Screen screen{{1, 4}};
+        et::DrawingWindow window{et::Window{{0, 0}, {1, 10}}, screen};
+        c.draw(window);
+        REQUIRE(c.get<0>().m_drawn == 1);
+        REQUIRE(c.get<1>().m_drawn == 1);
+        REQUIRE(c.get<2>().m_drawn == 0);
+    }
+}
@@ -0,0 +1,180 @@
+/*******************************************************************************
+ * @file test_event_loop.cpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+
+#include <array>
+#include <csignal>
+#include <string>
+#include <thread>
+
+#include <catch2/catch_test_macros.hpp>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <eltau/event_loop.hpp>
+
+namespace et = eltau;
+using namespace std::chrono_literals;
+
+namespace {
+/*******************************************************************************
+ * @brief Pipe closed at the end of the scope.
+ ******************************************************************************/
+struct Pipe {
+    Pipe() { REQUIRE(pipe(m_fds.data()) == 0); }
+    Pipe(const Pipe& other) = delete;
+    Pipe(Pipe&& other) noexcept = delete;
+    Pipe&
+    operator=(const Pipe& other) = delete;
+    Pipe&
+    operator=(Pipe&& other) noexcept = delete;
+    ~Pipe() noexcept {
+        for (auto fd : m_fds)
+            if (fd >= 0)
+                (void)close(fd);
+    }
+
+    std::array<int, 2> m_fds{-1, -1};
+};
+} // namespace
+
+TEST_CASE("EventLoop input") {
+    Pipe input;
+    et::EventLoop loop{input.m_fds[0]};
+    REQUIRE((fcntl(input.m_fds[0], F_GETFL) & O_NONBLOCK) != 0);
+
+    std::string received;
+    loop.on_input([&](std::string_view bytes) { received += bytes; });
+
+    SECTION("Nothing happens until timeout") {
+        REQUIRE(loop.poll(1ms) == 0);
+        REQUIRE(received.empty());
+    }
+    SECTION("Available bytes are read at once") {
+        REQUIRE(write(input.m_fds[1], "abc", 3) == 3);
+        REQUIRE(write(input.m_fds[1], "de", 2) == 2);
+        REQUIRE(loop.poll(-1ms) == 1);
+        REQUIRE(received == "abcde");
+    }
+    SECTION("Closed input is no longer watched") {
+        REQUIRE(write(input.m_fds[1], "x", 1) == 1);
+        (void)close(input.m_fds[1]);
+        input.m_fds[1] = -1;
+        REQUIRE(loop.poll(-1ms) == 1);
+        REQUIRE(received == "x");
+        REQUIRE(loop.poll(1ms) == 0);
+    }
+}
+
+TEST_CASE("EventLoop readers and writers") {
+    et::EventLoop loop{-1};
+    Pipe pipe;
+    int reads = 0;
+    int writes = 0;
+    // Both ends of the pipe, only the write end is ever writable.
+    loop.add_reader(pipe.m_fds[1], [&] { ++reads; });
+    REQUIRE_THROWS(loop.set_writer(pipe.m_fds[0], [&] { ++writes; }));
+
+    loop.set_writer(pipe.m_fds[1], [&] {
+        ++writes;
+        loop.set_writer(pipe.m_fds[1], {});
+    });
+    REQUIRE(loop.poll(-1ms) == 1);
+    REQUIRE(writes == 1);
+    REQUIRE(reads == 0);
+    REQUIRE(loop.poll(1ms) == 0);
+
+    loop.set_writer(pipe.m_fds[1], [&] { ++writes; });
+    loop.remove_reader(pipe.m_fds[1]);
+    REQUIRE(loop.poll(1ms) == 0);
+    REQUIRE(writes == 1);
+}
+
+TEST_CASE("EventLoop restores the input flags") {
+    Pipe input;
+    const auto flags = fcntl(input.m_fds[0], F_GETFL);
+    { et::EventLoop loop{input.m_fds[0]}; }
+    REQUIRE(fcntl(input.m_fds[0], F_GETFL) == flags);
+}
+
+TEST_CASE("EventLoop redraws") {
+    et::EventLoop loop{-1};
+    int renders = 0;
+    loop.on_render([&] { ++renders; });
+
+    SECTION("Requests in one batch render once") {
+        loop.request_redraw();
+        loop.request_redraw();
+        REQUIRE(loop.poll(-1ms) == 1);
+        REQUIRE(renders == 1);
+        REQUIRE(loop.poll(1ms) == 0);
+        REQUIRE(renders == 1);
+    }
+    SECTION("Other threads wake up the loop") {
+        std::thread other{[&] {
+            std::this_thread::sleep_for(10ms);
+            loop.request_redraw();
+        }};
+        (void)loop.poll(-1ms);
+        other.join();
+        REQUIRE(renders == 1);
+    }
+    SECTION("Timers request redraws") {
+        (void)loop.add_timer(1ms, 0ms, [&] { loop.request_redraw(); });
+        REQUIRE(loop.poll(-1ms) == 1);
+        REQUIRE(renders == 1);
+    }
+}
+
+TEST_CASE("EventLoop timers") {
+    et::EventLoop loop{-1};
+    int fired = 0;
+
+    SECTION("One-shot") {
+        const auto id = loop.add_timer(1ms, 0ms, [&] { ++fired; });
+        REQUIRE(loop.poll(-1ms) == 1);
+        REQUIRE(fired == 1);
+        REQUIRE(loop.poll(5ms) == 0);
+        REQUIRE(fired == 1);
+        loop.cancel_timer(id);
+    }
+    SECTION("Repeating until cancelled") {
+        et::EventLoop::TimerId id = -1;
+        id = loop.add_timer(1ms, 1ms, [&] {
+            if (++fired == 3)
+                loop.cancel_timer(id);
+        });
+        while (fired < 3)
+            (void)loop.poll(-1ms);
+        REQUIRE(loop.poll(5ms) == 0);
+        REQUIRE(fired == 3);
+    }
+    SECTION("Cancelled before expiring") {
+        const auto id = loop.add_timer(1ms, 0ms, [&] { ++fired; });
+        loop.cancel_timer(id);
+        REQUIRE(loop.poll(5ms) == 0);
+        REQUIRE(fired == 0);
+    }
+}
+
+TEST_CASE("EventLoop signals") {
+    et::EventLoop loop{-1};
+    int resizes = 0;
+    int renders = 0;
+    loop.on_resize([&] { ++resizes; });
+    loop.on_render([&] { ++renders; });
+
+    SECTION("SIGWINCH resizes and redraws") {
+        REQUIRE(raise(SIGWINCH) == 0);
+        REQUIRE(loop.poll(-1ms) == 1);
+        REQUIRE(resizes == 1);
+        REQUIRE(renders == 1);
+    }
+    SECTION("SIGTERM stops the loop") {
+        REQUIRE(raise(SIGTERM) == 0);
+        loop.run();
+        REQUIRE(loop.stopped());
+    }
+}
@@ -0,0 +1,137 @@
+/*******************************************************************************
+ * @file test_flat_tree.cpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <string>
+
+#include <catch2/catch_test_macros.hpp>
+#include <eltau/exception.hpp>
+#include <eltau/flat_tree.hpp>
+#include <eltau/text.hpp>
+
+#include "screen_utils.hpp"
+
+namespace et = eltau;
+
+using Kind = et::FlatTree::Kind;
+
+namespace {
+std::unique_ptr<et::Element>
+text(std::string_view str) {
+    return std::make_unique<et::ascii::Text>(str);
+}
+} // namespace
+
+TEST_CASE("FlatTree building") {
+    et::FlatTree tree;
+
+    SECTION("Leaves cannot be opened") { REQUIRE_THROWS_AS(tree.open(Kind::Leaf), et::EltauException); }
+    SECTION("Null leaf") { REQUIRE_THROWS_AS(tree.add(nullptr), et::EltauException); }
+    SECTION("Unbalanced close") { REQUIRE_THROWS_AS(tree.close(), et::EltauException); }
+    SECTION("Unclosed stack") {
+        (void)tree.open(Kind::HStack);
+        REQUIRE_THROWS_AS(tree.calc_pref_size({10, 10}), et::EltauException);
+        et::Screen screen{{1, 1}};
+        et::DrawingWindow window{et::Window{{0, 0}, {1, 1}}, screen};
+        REQUIRE_THROWS_AS(tree.draw(window), et::EltauException);
+    }
+    SECTION("Nodes are numbered in pre-order") {
+        REQUIRE(tree.open(Kind::VStack) == 0);
+        REQUIRE(tree.add(text("a")) == 1);
+        REQUIRE(tree.open(Kind::HStack) == 2);
+        REQUIRE(tree.add(text("b")) == 3);
+        tree.close();
+        tree.close();
+        REQUIRE(tree.size() == 4);
+        REQUIRE(tree.element(0) == nullptr);
+        REQUIRE(tree.element(1) != nullptr);
+    }
+    SECTION("Empty tree") { REQUIRE(tree.calc_pref_size({10, 10}) == et::Vec2{0, 0}); }
+}
+
+TEST_CASE("FlatTree layout") {
+    // Same as VContainer{HContainer{"ab", "c\nd"}, "efgh"}.
+    et::FlatTree tree;
+    (void)tree.open(Kind::VStack);
+    (void)tree.open(Kind::HStack);
+    const auto ab = tree.add(text("ab"));
+    const auto cd = tree.add(text("c\nd"));
+    tree.close();
+    const auto efgh = tree.add(text("efgh"));
+    tree.close();
+
+    REQUIRE(tree.calc_pref_size({10, 10}) == et::Vec2{3, 4});
+
+    et::Screen screen{{4, 6}};
+    et::DrawingWindow window{et::Window{{0, 0}, {4, 6}}, screen};
+    auto sub = window.sub_win({1, 1}, {3, 4});
+    tree.draw(sub);
+
+    REQUIRE(tree.placement(ab) == et::Window{{1, 1}, {2, 2}});
+    REQUIRE(tree.placement(cd) == et::Window{{1, 3}, {2, 1}});
+    REQUIRE(tree.placement(efgh) == et::Window{{3, 1}, {1, 4}});
+
+    REQUIRE(to_string(screen.line(0)) == "++++++");
+    REQUIRE(to_string(screen.line(1)) == "+abc++");
+    REQUIRE(to_string(screen.line(2)) == "+  d++");
+    REQUIRE(to_string(screen.line(3)) == "+efgh+");
+
+    SECTION("Children that do not fit are cut off") {
+        et::Screen small{{2, 2}};
+        et::DrawingWindow small_window{et::Window{{0, 0}, {2, 2}}, small};
+        REQUIRE(tree.calc_pref_size({2, 2}) == et::Vec2{2, 2});
+        tree.draw(small_window);
+        REQUIRE(tree.placement(cd) == et::Window{{0, 2}, {2, 0}});
+        REQUIRE(tree.placement(efgh) == et::Window{{2, 0}, {0, 2}});
+        REQUIRE(to_string(small.line(0)) == "ab");
+        REQUIRE(to_string(small.line(1)) == "  ");
+    }
+}
+
+TEST_CASE("FlatTree roots are stacked vertically") {
+    et::FlatTree tree;
+    (void)tree.add(text("ab"));
+    (void)tree.add(text("c"));
+    REQUIRE(tree.calc_pref_size({10, 10}) == et::Vec2{2, 2});
+}
+
+TEST_CASE("FlatTree culls subtrees outside of the screen") {
+    et::FlatTree tree;
+    (void)tree.open(Kind::HStack);
+    const auto left = tree.add(text("ab"));
+    const auto stack = tree.open(Kind::VStack);
+    const auto hidden = tree.add(text("cd"));
+    tree.close();
+    tree.close();
+
+    REQUIRE(tree.calc_pref_size({10, 10}) == et::Vec2{1, 4});
+    et::Screen screen{{1, 2}};
+    et::DrawingWindow window{et::Window{{0, 0}, {1, 4}}, screen};
+    tree.draw(window);
+    REQUIRE(to_string(screen.line(0)) == "ab");
+    REQUIRE(tree.placement(left) == et::Window{{0, 0}, {1, 2}});
+    REQUIRE(tree.placement(stack) == et::Window{{0, 2}, {1, 2}});
+    REQUIRE(tree.placement(hidden).empty());
+}
+
+TEST_CASE("FlatTree creates leaves in its resource") {
+    std::array<std::byte, 4096> buffer{};
+    std::pmr::monotonic_buffer_resource pool{buffer.data(), buffer.size(), std::pmr::null_memory_resource()};
+    et::FlatTree tree{std::allocator_arg, &pool};
+    const auto a = tree.emplace<et::ascii::Text>("a");
+    const auto b = tree.emplace<et::ascii::Text>("b");
+
+    const auto in_buffer = [&buffer](const et::Element* elem) {
+        const auto* ptr = reinterpret_cast<const std::byte*>(elem);
+        return ptr >= buffer.data() && ptr < buffer.data() + buffer.size();
+    };
+    REQUIRE(in_buffer(tree.element(a)));
+    REQUIRE(in_buffer(tree.element(b)));
+    REQUIRE(tree.calc_pref_size({10, 10}) == et::Vec2{2, 1});
+}
@@ -0,0 +1,139 @@
+/*******************************************************************************
+ * @file test_flex.cpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <eltau/exception.hpp>
+#include <eltau/flex.hpp>
+#include <eltau/text.hpp>
+
+#include "screen_utils.hpp"
+
+namespace et = eltau;
+
+namespace {
+std::vector<std::size_t>
+solve(et::FlexSolver& solver, std::size_t available, const std::vector<et::FlexItem>& items,
+      const std::vector<std::size_t>& prefs) {
+    const auto sizes = solver.solve(available, items, prefs);
+    return {sizes.begin(), sizes.end()};
+}
+} // namespace
+
+TEST_CASE("FlexSolver") {
+    et::FlexSolver solver;
+    using V = std::vector<std::size_t>;
+
+    SECTION("Without weights the preferred sizes are kept") {
+        REQUIRE(solve(solver, 10, {{}, {}}, {2, 3}) == V{2, 3});
+        REQUIRE(solve(solver, 3, {{}, {}}, {2, 3}) == V{2, 3});
+    }
+    SECTION("Limits are applied") {
+        REQUIRE(solve(solver, 10, {{.m_min = 4}, {.m_max = 1}}, {2, 3}) == V{4, 1});
+        // Max wins.
+        REQUIRE(solve(solver, 10, {{.m_min = 4, .m_max = 2}}, {3}) == V{2});
+    }
+    SECTION("Free space is split by weights") {
+        REQUIRE(solve(solver, 12, {{.m_weight = 1}, {.m_weight = 2}, {}}, {0, 0, 3}) == V{3, 6, 3});
+        // Remainder is handed out in order.
+        REQUIRE(solve(solver, 5, {{.m_weight = 1}, {.m_weight = 1}}, {0, 0}) == V{3, 2});
+    }
+    SECTION("Saturated items give their share to the others") {
+        REQUIRE(solve(solver, 10, {{.m_weight = 1, .m_max = 2}, {.m_weight = 1}}, {0, 0}) == V{2, 8});
+    }
+    SECTION("Missing space is taken by weights down to minimums") {
+        REQUIRE(solve(solver, 6, {{.m_weight = 1}, {.m_weight = 1, .m_min = 3}, {}}, {4, 4, 2}) == V{1, 3, 2});
+        // Cannot shrink enough.
+        REQUIRE(solve(solver, 2, {{.m_weight = 1}, {}}, {4, 4}) == V{0, 4});
+    }
+    SECTION("Solution is cached") {
+        const std::vector<et::FlexItem> items{{.m_weight = 1}, {}};
+        (void)solver.solve(10, items, V{1, 2});
+        (void)solver.solve(10, items, V{1, 2});
+        REQUIRE(solver.solve_count() == 1);
+        REQUIRE(solve(solver, 11, items, {1, 2}) == V{9, 2});
+        REQUIRE(solve(solver, 11, items, {1, 3}) == V{8, 3});
+        REQUIRE(solver.solve_count() == 3);
+        solver.invalidate();
+        (void)solver.solve(11, items, V{1, 3});
+        REQUIRE(solver.solve_count() == 4);
+    }
+}
+
+TEST_CASE("FlexContainer") {
+    et::Screen screen{{3, 8}};
+    et::DrawingWindow window{et::Window{{0, 0}, {3, 8}}, screen};
+
+    SECTION("Null child") {
+        et::FlexContainer flex{et::Direction::Horizontal};
+        REQUIRE_THROWS_AS(flex.add(nullptr), et::EltauException);
+        REQUIRE_THROWS_AS(flex.set_item(0, {}), et::EltauException);
+    }
+    SECTION("Weighted child takes the free space") {
+        et::FlexContainer flex{et::Direction::Horizontal};
+        (void)flex.add(std::make_unique<et::ascii::Text>("ab"));
+        (void)flex.add(std::make_unique<et::ascii::Text>("cd"), {.m_weight = 1, .m_align = et::Align::Stretch});
+        (void)flex.add(std::make_unique<et::ascii::Text>("e\nf"));
+        REQUIRE(flex.calc_pref_size({3, 8}) == et::Vec2{2, 5});
+        flex.draw(window);
+        REQUIRE(to_string(screen.line(0)) == "abcd   e");
+        REQUIRE(to_string(screen.line(1)) == "++     f");
+        REQUIRE(to_string(screen.line(2)) == "++     +");
+    }
+    SECTION("Without weights the children are packed") {
+        et::FlexContainer flex{et::Direction::Vertical};
+        (void)flex.add(std::make_unique<et::ascii::Text>("ab"));
+        (void)flex.add(std::make_unique<et::ascii::Text>("cde"), {.m_align = et::Align::End});
+        REQUIRE(flex.calc_pref_size({3, 8}) == et::Vec2{2, 3});
+    }
+    SECTION("Justify and align") {
+        et::FlexContainer flex{et::Direction::Vertical, et::Align::Center};
+        (void)flex.add(std::make_unique<et::ascii::Text>("ab"), {.m_align = et::Align::Center});
+        REQUIRE(flex.calc_pref_size({3, 8}) == et::Vec2{1, 2});
+        flex.draw(window);
+        REQUIRE(to_string(screen.line(0)) == "++++++++");
+        REQUIRE(to_string(screen.line(1)) == "+++ab+++");
+        REQUIRE(to_string(screen.line(2)) == "++++++++");
+    }
+    SECTION("Solution is reused until something changes") {
+        et::FlexContainer flex{et::Direction::Horizontal};
+        (void)flex.add(std::make_unique<et::ascii::Text>("ab"), {.m_weight = 1});
+        (void)flex.calc_pref_size({3, 8});
+        flex.draw(window);
+        (void)flex.calc_pref_size({3, 8});
+        flex.draw(window);
+        REQUIRE(flex.solver().solve_count() == 1);
+
+        auto smaller = window.sub_win({0, 0}, {3, 7});
+        flex.draw(smaller);
+        REQUIRE(flex.solver().solve_count() == 2);
+        flex.set_item(0, {.m_weight = 2});
+        flex.draw(smaller);
+        REQUIRE(flex.solver().solve_count() == 3);
+        // Preferred size of a child changed.
+        (void)flex.calc_pref_size({3, 1});
+        flex.draw(smaller);
+        REQUIRE(flex.solver().solve_count() == 4);
+    }
+    SECTION("Nested containers") {
+        auto inner = std::make_unique<et::FlexContainer>(et::Direction::Vertical);
+        (void)inner->add(std::make_unique<et::ascii::Text>("x"), {.m_weight = 1, .m_align = et::Align::End});
+        (void)inner->add(std::make_unique<et::ascii::Text>("yz"));
+
+        et::FlexContainer flex{et::Direction::Horizontal};
+        (void)flex.add(std::make_unique<et::ascii::Text>("a"), {.m_weight = 1});
+        (void)flex.add(std::move(inner), {.m_weight = 1, .m_align = et::Align::Stretch});
+        REQUIRE(flex.calc_pref_size({3, 8}) == et::Vec2{2, 3});
+        flex.draw(window);
+        // Columns split 4:4, rows of the inner one 2:1.
+        REQUIRE(to_string(screen.line(0)) == "a   +++x");
+        REQUIRE(to_string(screen.line(1)) == "+++++++ ");
+        REQUIRE(to_string(screen.line(2)) == "++++yz++");
+    }
+}
@@ -0,0 +1,130 @@
+/*******************************************************************************
+ * @file test_hit_map.cpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+
+#include <memory>
+#include <string>
+
+#include <catch2/catch_test_macros.hpp>
+#include <eltau/compositor.hpp>
+#include <eltau/flex.hpp>
+#include <eltau/hit_map.hpp>
+#include <eltau/text.hpp>
+#include <eltau/virtual_list.hpp>
+
+namespace et = eltau;
+
+TEST_CASE("HitMap") {
+    et::HitMap hits{{2, 3}};
+    et::ascii::Text a{"a"};
+    et::ascii::Text b{"b"};
+    REQUIRE(hits.at({0, 0}) == nullptr);
+
+    hits.mark({{0, 1}, {5, 5}}, &a);
+    hits.mark({{1, 2}, {1, 1}}, &b);
+    REQUIRE(hits.at({0, 0}) == nullptr);
+    REQUIRE(hits.at({0, 1}) == &a);
+    REQUIRE(hits.at({1, 1}) == &a);
+    REQUIRE(hits.at({1, 2}) == &b);
+    REQUIRE(hits.at({2, 2}) == nullptr);
+    REQUIRE(hits.at({0, 3}) == nullptr);
+
+    hits.mark({{0, 0}, {1, 3}}, nullptr);
+    REQUIRE(hits.at({0, 1}) == nullptr);
+    REQUIRE(hits.at({1, 2}) == &b);
+
+    hits.resize({3, 3});
+    REQUIRE(hits.size() == et::Vec2{3, 3});
+    REQUIRE(hits.at({1, 2}) == nullptr);
+}
+
+TEST_CASE("Drawing fills the hit map") {
+    et::Screen screen{{2, 6}};
+    et::HitMap hits{screen.size()};
+
+    SECTION("Dynamic containers") {
+        et::FlexContainer flex{et::Direction::Horizontal};
+        auto left = std::make_unique<et::ascii::Text>("ab");
+        auto right = std::make_unique<et::ascii::Text>("cd");
+        auto* left_ptr = left.get();
+        auto* right_ptr = right.get();
+        (void)flex.add(std::move(left));
+        (void)flex.add(std::move(right));
+        (void)flex.calc_pref_size({1, 6});
+
+        et::DrawingWindow window{{{1, 0}, {1, 6}}, screen, std::pmr::get_default_resource(), &hits};
+        flex.draw(window);
+        REQUIRE(hits.at({0, 0}) == nullptr);
+        REQUIRE(hits.at({1, 1}) == left_ptr);
+        REQUIRE(hits.at({1, 2}) == right_ptr);
+        REQUIRE(hits.at({1, 5}) == &flex);
+    }
+    SECTION("Static containers") {
+        et::HContainer hbox{et::ascii::Text{"ab"}, et::ascii::Text{"cd"}};
+        (void)hbox.calc_pref_size({2, 6});
+
+        et::DrawingWindow window{{{0, 0}, {2, 6}}, screen, std::pmr::get_default_resource(), &hits};
+        hbox.draw(window);
+        REQUIRE(hits.at({0, 0}) == &hbox.get<0>());
+        REQUIRE(hits.at({1, 3}) == &hbox.get<1>());
+        REQUIRE(hits.at({0, 5}) == &hbox);
+    }
+    SECTION("Rows of a virtual list") {
+        et::VirtualList list{
+            10, [](std::size_t row) { return std::make_unique<et::ascii::Text>(std::to_string(row) + "\nnext"); },
+            [](std::size_t) { return 2; }};
+        // The first row is cut off.
+        list.scroll_to(1);
+        (void)list.calc_pref_size({2, 6});
+
+        et::DrawingWindow window{{{0, 0}, {2, 6}}, screen, std::pmr::get_default_resource(), &hits};
+        list.draw(window);
+        REQUIRE(hits.at({0, 0}) != nullptr);
+        REQUIRE(hits.at({0, 0}) != &list);
+        REQUIRE(hits.at({0, 0}) == hits.at({0, 5}));
+        REQUIRE(hits.at({1, 0}) != hits.at({0, 0}));
+        REQUIRE(hits.at({1, 0}) != &list);
+    }
+    SECTION("Nothing is collected without a map") {
+        et::ascii::Text text{"ab"};
+        (void)text.calc_pref_size({2, 6});
+        et::DrawingWindow window{{{0, 0}, {2, 6}}, screen};
+        REQUIRE(window.hit_map() == nullptr);
+        REQUIRE(window.sub_win({0, 0}, {1, 1}).hit_map() == nullptr);
+        text.draw(window);
+    }
+}
+
+TEST_CASE("Compositor hit-testing") {
+    et::Compositor compositor{{4, 8}};
+    auto bottom = std::make_unique<et::ascii::Text>("bottom");
+    auto top = std::make_unique<et::ascii::Text>("top");
+    auto* bottom_ptr = bottom.get();
+    auto* top_ptr = top.get();
+
+    (void)compositor.add_layer(std::move(bottom), {{0, 0}, {4, 8}});
+    const auto popup = compositor.add_layer(std::move(top), {{1, 2}, {2, 4}});
+    REQUIRE(compositor.hit_test({0, 0}) == nullptr);
+
+    (void)compositor.compose();
+    const auto draws = compositor.draw_count();
+    REQUIRE(compositor.hit_test({0, 0}) == bottom_ptr);
+    REQUIRE(compositor.hit_test({1, 2}) == top_ptr);
+    REQUIRE(compositor.hit_test({2, 5}) == top_ptr);
+    REQUIRE(compositor.hit_test({3, 2}) == bottom_ptr);
+    REQUIRE(compositor.hit_test({4, 0}) == nullptr);
+
+    SECTION("Moved layers are not redrawn") {
+        compositor.move_layer(popup, {{2, 4}, {2, 4}});
+        (void)compositor.compose();
+        REQUIRE(compositor.draw_count() == draws);
+        REQUIRE(compositor.hit_test({1, 2}) == bottom_ptr);
+        REQUIRE(compositor.hit_test({3, 7}) == top_ptr);
+    }
+    SECTION("Removed layers") {
+        (void)compositor.remove_layer(popup);
+        REQUIRE(compositor.hit_test({1, 2}) == bottom_ptr);
+    }
+}
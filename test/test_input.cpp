@@ -0,0 +1,208 @@
+/*******************************************************************************
+ * @file test_input.cpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <eltau/input.hpp>
+
+namespace et = eltau;
+using namespace std::chrono_literals;
+
+namespace {
+using Type = et::InputEvent::Type;
+
+/*******************************************************************************
+ * @brief Pop all the queued events.
+ ******************************************************************************/
+std::vector<et::InputEvent>
+drain(et::InputDecoder& decoder) {
+    std::vector<et::InputEvent> events;
+    while (auto event = decoder.pop())
+        events.push_back(*event);
+    return events;
+}
+
+et::InputEvent
+key(et::Key key, std::uint8_t mods = 0, char32_t chr = 0) {
+    return {.m_type = Type::Key, .m_key = key, .m_mods = mods, .m_char = chr};
+}
+
+et::InputEvent
+chr(char32_t chr, std::uint8_t mods = 0) {
+    return key(et::Key::Char, mods, chr);
+}
+
+/*******************************************************************************
+ * @brief Decode @p bytes fed one byte at a time.
+ ******************************************************************************/
+std::vector<et::InputEvent>
+bytewise(std::string_view bytes) {
+    et::InputDecoder decoder;
+    std::vector<et::InputEvent> events;
+    for (std::size_t i = 0; i < bytes.size(); ++i) {
+        REQUIRE(decoder.feed(bytes.substr(i, 1)) == 1);
+        for (auto& event : drain(decoder))
+            events.push_back(event);
+    }
+    return events;
+}
+} // namespace
+
+TEST_CASE("InputDecoder keys") {
+    et::InputDecoder decoder;
+
+    SECTION("Characters") {
+        REQUIRE(decoder.feed("a\xC3\xA9\xE2\x82\xAC") == 6);
+        REQUIRE(drain(decoder) == std::vector{chr('a'), chr(U'é'), chr(U'€')});
+    }
+    SECTION("Control characters") {
+        REQUIRE(decoder.feed("\r\t\x7f\x03\x1f") == 5);
+        REQUIRE(drain(decoder) == std::vector{key(et::Key::Enter), key(et::Key::Tab), key(et::Key::Backspace),
+                                              chr('c', et::Ctrl), chr('_', et::Ctrl)});
+    }
+    SECTION("Sequences") {
+        REQUIRE(decoder.feed("\033[A\033OB\033[3~\033[15~\033OP\033[Z") == 21);
+        REQUIRE(drain(decoder) == std::vector{key(et::Key::Up), key(et::Key::Down), key(et::Key::Delete),
+                                              key(et::Key::F5), key(et::Key::F1), key(et::Key::Tab, et::Shift)});
+    }
+    SECTION("Modifiers") {
+        (void)decoder.feed("\033[1;5C\033[5;3~\033x\033\r");
+        REQUIRE(drain(decoder) == std::vector{key(et::Key::Right, et::Ctrl), key(et::Key::PageUp, et::Alt),
+                                              chr('x', et::Alt), key(et::Key::Enter, et::Alt)});
+    }
+    SECTION("Sub-parameters are ignored") {
+        (void)decoder.feed("\033[3:1~\033[1;5:1C\033[1:2;3A");
+        REQUIRE(drain(decoder) ==
+                std::vector{key(et::Key::Delete), key(et::Key::Right, et::Ctrl), key(et::Key::Up, et::Alt)});
+    }
+    SECTION("Unknown and malformed sequences are dropped") {
+        (void)decoder.feed("\033[99~\033[?1;2c\033[1\rx");
+        REQUIRE(drain(decoder) == std::vector{key(et::Key::Enter), chr('x')});
+    }
+    SECTION("Invalid UTF-8") {
+        (void)decoder.feed("\xC3x\xFF");
+        REQUIRE(drain(decoder) == std::vector{chr(U'�'), chr('x'), chr(U'�')});
+    }
+}
+
+TEST_CASE("InputDecoder sequences split across reads") {
+    const std::string input = "\033[1;5A\xE2\x82\xAC\033[<0;10;5M\033[200~ab\033[201~";
+    et::InputDecoder whole;
+    (void)whole.feed(input);
+    const auto expected = drain(whole);
+    REQUIRE(expected.size() == 5);
+
+    const auto events = bytewise(input);
+    // Paste is split per byte.
+    REQUIRE(events.size() == 6);
+    REQUIRE(std::vector(events.begin(), events.begin() + 3) ==
+            std::vector(expected.begin(), expected.begin() + 3));
+    REQUIRE(events[3].m_text == "a");
+    REQUIRE(events[4].m_text == "b");
+    REQUIRE(events[5].m_type == Type::PasteEnd);
+}
+
+TEST_CASE("InputDecoder lone ESC") {
+    const auto start = et::InputDecoder::Clock::time_point{};
+    et::InputDecoder decoder{10ms};
+
+    (void)decoder.feed("\033", start);
+    REQUIRE(decoder.size() == 0);
+    REQUIRE(decoder.deadline() == start + 10ms);
+
+    SECTION("Resolved after the timeout") {
+        REQUIRE_FALSE(decoder.expire(start + 5ms));
+        REQUIRE(decoder.expire(start + 10ms));
+        REQUIRE(drain(decoder) == std::vector{key(et::Key::Escape)});
+        REQUIRE_FALSE(decoder.deadline());
+    }
+    SECTION("Continued in time") {
+        (void)decoder.feed("[B", start + 5ms);
+        REQUIRE(drain(decoder) == std::vector{key(et::Key::Down)});
+    }
+    SECTION("Input after the timeout is not a sequence") {
+        (void)decoder.feed("[", start + 20ms);
+        REQUIRE(drain(decoder) == std::vector{key(et::Key::Escape), chr('[')});
+    }
+    SECTION("Double ESC") {
+        (void)decoder.feed("\033", start + 1ms);
+        REQUIRE(drain(decoder) == std::vector{key(et::Key::Escape)});
+        REQUIRE(decoder.deadline() == start + 11ms);
+    }
+}
+
+TEST_CASE("InputDecoder mouse") {
+    et::InputDecoder decoder;
+    (void)decoder.feed("\033[<0;10;5M\033[<2;1;1m\033[<52;3;4M\033[<65;1;2M");
+    const auto events = drain(decoder);
+    REQUIRE(events.size() == 4);
+
+    REQUIRE(events[0].m_type == Type::MousePress);
+    REQUIRE(events[0].m_button == et::MouseButton::Left);
+    REQUIRE(events[0].m_pos == et::Vec2{4, 9});
+
+    REQUIRE(events[1].m_type == Type::MouseRelease);
+    REQUIRE(events[1].m_button == et::MouseButton::Right);
+    REQUIRE(events[1].m_pos == et::Vec2{0, 0});
+
+    REQUIRE(events[2].m_type == Type::MouseMove);
+    REQUIRE(events[2].m_mods == (et::Shift | et::Ctrl));
+    REQUIRE(events[2].m_pos == et::Vec2{3, 2});
+
+    REQUIRE(events[3].m_button == et::MouseButton::WheelDown);
+}
+
+TEST_CASE("InputDecoder bracketed paste") {
+    et::InputDecoder decoder;
+
+    SECTION("Pasted text is not decoded") {
+        const std::string_view input = "\033[200~a\033[Ab\rc\033[201~x";
+        REQUIRE(decoder.feed(input) == input.size());
+        const auto events = drain(decoder);
+        REQUIRE(events.size() == 5);
+        REQUIRE(events[0].m_text == "a");
+        REQUIRE(events[1].m_text == "\033[");
+        REQUIRE(events[2].m_text == "Ab\rc");
+        REQUIRE(events[3].m_type == Type::PasteEnd);
+        REQUIRE(events[4] == chr('x'));
+    }
+    SECTION("Partial terminator across reads") {
+        (void)decoder.feed("\033[200~ab\033[20");
+        (void)decoder.feed("0xy\033[2");
+        (void)decoder.feed("01~");
+        std::string pasted;
+        for (const auto& event : drain(decoder)) {
+            if (event.m_type == Type::PasteEnd)
+                break;
+            REQUIRE(event.m_type == Type::Paste);
+            pasted += event.m_text;
+        }
+        REQUIRE(pasted == "ab\033[200xy");
+    }
+    SECTION("Large paste is decoded in few events") {
+        const std::string text(std::size_t{1} << 20U, 'p');
+        (void)decoder.feed("\033[200~");
+        REQUIRE(decoder.feed(text) == text.size());
+        REQUIRE(decoder.size() == 1);
+        REQUIRE(decoder.pop()->m_text.data() == text.data());
+    }
+}
+
+TEST_CASE("InputDecoder full queue") {
+    et::InputDecoder decoder;
+    const std::string input(et::InputDecoder::c_queue_size + 10, 'a');
+
+    const auto consumed = decoder.feed(input);
+    REQUIRE(consumed == et::InputDecoder::c_queue_size);
+    REQUIRE(decoder.size() == et::InputDecoder::c_queue_size);
+
+    (void)drain(decoder);
+    REQUIRE(decoder.feed(std::string_view{input}.substr(consumed)) == 10);
+    REQUIRE(decoder.size() == 10);
+}
@@ -0,0 +1,161 @@
+/*******************************************************************************
+ * @file test_line_index.cpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+
+#include <string>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <eltau/line_index.hpp>
+
+namespace et = eltau;
+
+using LineIndex = et::ascii::LineIndex;
+using Segment = LineIndex::Segment;
+
+using namespace std::string_view_literals;
+
+TEST_CASE("LineIndex paragraphs") {
+    SECTION("Empty text has no paragraphs") {
+        LineIndex index{""sv};
+        REQUIRE(index.paragraph_count() == 0);
+        REQUIRE(index.size(10) == et::Vec2{0, 0});
+        REQUIRE(index.line(0, 10) == Segment{});
+    }
+    SECTION("Newlines separate paragraphs") {
+        LineIndex index{"ab\n\ncde\n"sv};
+        REQUIRE(index.paragraph_count() == 4);
+        REQUIRE(index.paragraph(0) == Segment{.m_begin = 0, .m_length = 2});
+        REQUIRE(index.paragraph(1) == Segment{.m_begin = 3, .m_length = 0});
+        REQUIRE(index.paragraph(2) == Segment{.m_begin = 4, .m_length = 3});
+        REQUIRE(index.paragraph(3) == Segment{.m_begin = 8, .m_length = 0});
+        REQUIRE(index.paragraph(4) == Segment{});
+    }
+    SECTION("Rebuild replaces the index") {
+        LineIndex index{"a\nb"sv};
+        REQUIRE(index.size(10) == et::Vec2{2, 1});
+        index.rebuild("Hello");
+        REQUIRE(index.paragraph_count() == 1);
+        REQUIRE(index.size(10) == et::Vec2{1, 5});
+    }
+}
+
+TEST_CASE("LineIndex wrapped lines") {
+    LineIndex index{"Hello world\n\nab"sv};
+
+    SECTION("Unwrapped lines are paragraphs") {
+        REQUIRE(index.size(100) == et::Vec2{3, 11});
+        for (std::size_t i = 0; i < index.paragraph_count(); ++i)
+            REQUIRE(index.line(i, 100) == index.paragraph(i));
+    }
+    SECTION("Wrapped lines") {
+        REQUIRE(index.size(4) == et::Vec2{5, 4});
+        REQUIRE(index.line(0, 4) == Segment{.m_begin = 0, .m_length = 4});
+        REQUIRE(index.line(1, 4) == Segment{.m_begin = 4, .m_length = 4});
+        REQUIRE(index.line(2, 4) == Segment{.m_begin = 8, .m_length = 3});
+        REQUIRE(index.line(3, 4) == Segment{.m_begin = 12, .m_length = 0});
+        REQUIRE(index.line(4, 4) == Segment{.m_begin = 13, .m_length = 2});
+        REQUIRE(index.line(5, 4) == Segment{});
+    }
+    SECTION("Changing the limit re-wraps") {
+        REQUIRE(index.size(4) == et::Vec2{5, 4});
+        REQUIRE(index.size(11) == et::Vec2{3, 11});
+        REQUIRE(index.size(1) == et::Vec2{14, 1});
+        REQUIRE(index.size(0) == et::Vec2{14, 1});
+        REQUIRE(index.size(4) == et::Vec2{5, 4});
+    }
+}
+
+TEST_CASE("LineIndex incremental update") {
+    // Compare against a freshly built index for all wrap limits.
+    auto check = [](LineIndex& index, std::string_view text) {
+        LineIndex expected{text};
+        REQUIRE(index.paragraph_count() == expected.paragraph_count());
+        for (std::size_t i = 0; i < expected.paragraph_count(); ++i)
+            REQUIRE(index.paragraph(i) == expected.paragraph(i));
+        for (std::size_t limit = 1; limit <= text.size() + 1; ++limit) {
+            REQUIRE(index.size(limit) == expected.size(limit));
+            for (std::size_t r = 0; r < expected.size(limit).m_row; ++r)
+                REQUIRE(index.line(r, limit) == expected.line(r, limit));
+        }
+    };
+    // Edit with a cached layout.
+    auto edit = [&](std::string& text, std::size_t limit, std::size_t pos, std::size_t count, std::string_view str) {
+        LineIndex index{text};
+        (void)index.size(limit);
+        text.replace(pos, count, str);
+        index.update(text, pos, count, str.size());
+        REQUIRE(index.size(limit) == LineIndex{text}.size(limit));
+        check(index, text);
+    };
+
+    const std::string base{"Hello world\n\nab\nlonger paragraph"};
+    const auto limit = GENERATE(1, 3, 5, 11, 100);
+
+    SECTION("Append") {
+        auto text = base;
+        edit(text, limit, text.size(), 0, "more");
+        edit(text, limit, text.size(), 0, "\nnew line\n");
+        edit(text, limit, text.size(), 0, "");
+        edit(text, limit, text.size(), 0, "a much longer paragraph than all the others");
+    }
+    SECTION("Replace within a paragraph") {
+        auto text = base;
+        edit(text, limit, 2, 3, "y");
+        edit(text, limit, 0, 0, "prefix ");
+    }
+    SECTION("Replace across paragraphs") {
+        auto text = base;
+        edit(text, limit, 5, 10, "\n\nx\n");
+        edit(text, limit, 0, text.size() - 1, "");
+    }
+    SECTION("Shorten the longest paragraph") {
+        auto text = base;
+        edit(text, limit, 20, 10, "");
+    }
+    SECTION("From and to empty text") {
+        std::string text;
+        edit(text, limit, 0, 0, "ab\ncd");
+        edit(text, limit, 0, text.size(), "");
+    }
+}
+
+TEST_CASE("UTF-8 LineIndex") {
+    using Utf8Index = et::utf8::LineIndex;
+    using Utf8Segment = Utf8Index::Segment;
+
+    SECTION("Paragraph widths") {
+        Utf8Index index{"a\u4E00\n\u00E9"sv};
+        REQUIRE(index.paragraph_count() == 2);
+        REQUIRE(index.paragraph(0) == Utf8Segment{.m_begin = 0, .m_length = 4, .m_width = 3});
+        REQUIRE(index.paragraph(1) == Utf8Segment{.m_begin = 5, .m_length = 2, .m_width = 1});
+        REQUIRE(index.size(100) == et::Vec2{2, 3});
+    }
+    SECTION("Wide characters are not split") {
+        Utf8Index index{"\u4E00\u4E00\u4E00"sv};
+        REQUIRE(index.size(3) == et::Vec2{3, 2});
+        REQUIRE(index.line(1, 3) == Utf8Segment{.m_begin = 3, .m_length = 3, .m_width = 2});
+        // Does not fit at all, still one per line.
+        REQUIRE(index.size(1) == et::Vec2{3, 2});
+    }
+    SECTION("Combining marks stay with their base") {
+        Utf8Index index{"ae\u0301b"sv};
+        REQUIRE(index.size(2) == et::Vec2{2, 2});
+        REQUIRE(index.line(0, 2) == Utf8Segment{.m_begin = 0, .m_length = 4, .m_width = 2});
+        REQUIRE(index.line(1, 2) == Utf8Segment{.m_begin = 4, .m_length = 1, .m_width = 1});
+    }
+    SECTION("ASCII wraps like ascii::LineIndex") {
+        constexpr auto text{"Hello world\n\nab"sv};
+        Utf8Index index{text};
+        LineIndex ascii{text};
+        for (std::size_t limit = 1; limit < 13; ++limit) {
+            REQUIRE(index.size(limit) == ascii.size(limit));
+            for (std::size_t r = 0; r < index.size(limit).m_row; ++r) {
+                REQUIRE(index.line(r, limit).m_begin == ascii.line(r, limit).m_begin);
+                REQUIRE(index.line(r, limit).m_length == ascii.line(r, limit).m_length);
+            }
+        }
+    }
+}
@@ -0,0 +1,117 @@
+/*******************************************************************************
+ * @file test_log_view.cpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <thread>
+
+#include <catch2/catch_test_macros.hpp>
+#include <eltau/exception.hpp>
+#include <eltau/log_view.hpp>
+
+#include "screen_utils.hpp"
+
+namespace et = eltau;
+
+using namespace std::chrono_literals;
+
+namespace {
+/*! Wait for the background indexer. */
+bool
+wait_for(const std::function<bool()>& pred) {
+    const auto deadline = std::chrono::steady_clock::now() + 5s;
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() > deadline)
+            return false;
+        std::this_thread::sleep_for(1ms);
+    }
+    return true;
+}
+
+/*! Temporary file removed at the end of the test. */
+struct TempFile {
+    explicit TempFile(const std::string& content) :
+        m_path(std::filesystem::temp_directory_path() /
+               ("eltau_log_view_" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()))) {
+        append(content);
+    }
+    TempFile(const TempFile&) = delete;
+    TempFile&
+    operator=(const TempFile&) = delete;
+    ~TempFile() { std::filesystem::remove(m_path); }
+
+    void
+    append(const std::string& content) const {
+        std::ofstream file{m_path, std::ios::app | std::ios::binary};
+        file << content;
+    }
+
+    std::filesystem::path m_path;
+};
+} // namespace
+
+TEST_CASE("LogView indexing") {
+    SECTION("Missing file") { REQUIRE_THROWS_AS(et::LogView{"/nonexistent/eltau.log"}, et::EltauException); }
+    SECTION("Empty file") {
+        TempFile file{""};
+        et::LogView view{file.m_path.string()};
+        REQUIRE(view.line_count() == 0);
+        REQUIRE(view.line(0).empty());
+    }
+    SECTION("Lines") {
+        TempFile file{"first\n\nthird\nunterminated"};
+        et::LogView view{file.m_path.string()};
+        REQUIRE(wait_for([&] { return view.indexed_bytes() == 25; }));
+        REQUIRE(view.line_count() == 4);
+        REQUIRE(view.line(0) == "first");
+        REQUIRE(view.line(1).empty());
+        REQUIRE(view.line(3) == "unterminated");
+        REQUIRE(view.line(4).empty());
+    }
+    SECTION("Large file spanning several chunks") {
+        std::string content;
+        for (std::size_t i = 0; i < 200'000; ++i)
+            content += std::to_string(i) + '\n';
+        TempFile file{content};
+        et::LogView view{file.m_path.string()};
+        REQUIRE(wait_for([&] { return view.indexed_bytes() == content.size(); }));
+        REQUIRE(view.line_count() == 200'000);
+        REQUIRE(view.line(123'456) == "123456");
+    }
+}
+
+TEST_CASE("LogView follows the file") {
+    TempFile file{"a\nb\n"};
+    et::LogView view{file.m_path.string(), 1ms};
+    REQUIRE(wait_for([&] { return view.line_count() == 2; }));
+
+    file.append("c\x01\nd\n");
+    REQUIRE(wait_for([&] { return view.line_count() == 4; }));
+    REQUIRE(view.line(2) == "c\x01");
+
+    et::Screen screen{{2, 3}};
+    et::DrawingWindow window{et::Window{{0, 0}, {2, 3}}, screen};
+    REQUIRE(view.calc_pref_size({2, 3}) == et::Vec2{2, 3});
+
+    SECTION("Scrolled") {
+        view.scroll_to(1);
+        view.draw(window);
+        REQUIRE(to_string(screen.line(0)) == "b  ");
+        // Escaped like ascii::Text.
+        REQUIRE(to_string(screen.line(1)) == "c  ");
+    }
+    SECTION("Following") {
+        view.set_follow(true);
+        file.append("e\n");
+        REQUIRE(wait_for([&] { return view.line_count() == 5; }));
+        view.draw(window);
+        REQUIRE(to_string(screen.line(0)) == "d  ");
+        REQUIRE(to_string(screen.line(1)) == "e  ");
+    }
+}
@@ -0,0 +1,298 @@
+/*******************************************************************************
+ * @file test_memory.cpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <string>
+#include <thread>
+
+#include <catch2/catch_test_macros.hpp>
+#include <eltau/compositor.hpp>
+#include <eltau/flat_tree.hpp>
+#include <eltau/flex.hpp>
+#include <eltau/log_view.hpp>
+#include <eltau/memory.hpp>
+#include <eltau/text.hpp>
+#include <eltau/virtual_list.hpp>
+
+#include "screen_utils.hpp"
+
+namespace et = eltau;
+
+using namespace std::chrono_literals;
+
+namespace {
+/*! Global allocations of this thread are counted here, if set. */
+thread_local std::size_t* t_global_allocations = nullptr;
+} // namespace
+
+// Inert unless a GlobalAllocations scope is active on the calling thread. The
+// nothrow forms are replaced too, e.g. std::stable_sort uses them.
+void*
+operator new(std::size_t size, const std::nothrow_t& /*tag*/) noexcept {
+    if (t_global_allocations != nullptr)
+        ++*t_global_allocations;
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void*
+operator new(std::size_t size) {
+    if (void* ptr = operator new(size, std::nothrow))
+        return ptr;
+    throw std::bad_alloc{};
+}
+
+void
+operator delete(void* ptr, const std::nothrow_t& /*tag*/) noexcept {
+    std::free(ptr);
+}
+
+void
+operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void
+operator delete(void* ptr, std::size_t /*size*/) noexcept {
+    std::free(ptr);
+}
+
+namespace {
+/*******************************************************************************
+ * @brief Make @p resource the default one until the end of the scope.
+ ******************************************************************************/
+struct DefaultResource {
+    explicit DefaultResource(std::pmr::memory_resource* resource) :
+        m_previous(std::pmr::set_default_resource(resource)) {}
+    DefaultResource(const DefaultResource& other) = delete;
+    DefaultResource(DefaultResource&& other) noexcept = delete;
+    DefaultResource&
+    operator=(const DefaultResource& other) = delete;
+    DefaultResource&
+    operator=(DefaultResource&& other) noexcept = delete;
+    ~DefaultResource() noexcept { std::pmr::set_default_resource(m_previous); }
+
+    std::pmr::memory_resource* m_previous;
+};
+
+/*******************************************************************************
+ * @brief Count global operator new calls of this thread until the end of the scope.
+ ******************************************************************************/
+struct GlobalAllocations {
+    GlobalAllocations() noexcept { t_global_allocations = &m_count; }
+    GlobalAllocations(const GlobalAllocations& other) = delete;
+    GlobalAllocations(GlobalAllocations&& other) noexcept = delete;
+    GlobalAllocations&
+    operator=(const GlobalAllocations& other) = delete;
+    GlobalAllocations&
+    operator=(GlobalAllocations&& other) noexcept = delete;
+    ~GlobalAllocations() noexcept { t_global_allocations = nullptr; }
+
+    std::size_t m_count = 0;
+};
+
+/*! Temporary file removed at the end of the test. */
+struct TempFile {
+    explicit TempFile(const std::string& content) :
+        m_path(std::filesystem::temp_directory_path() /
+               ("eltau_memory_" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()))) {
+        std::ofstream{m_path, std::ios::binary} << content;
+    }
+    TempFile(const TempFile&) = delete;
+    TempFile&
+    operator=(const TempFile&) = delete;
+    ~TempFile() { std::filesystem::remove(m_path); }
+
+    std::filesystem::path m_path;
+};
+} // namespace
+
+TEST_CASE("CountingResource") {
+    et::CountingResource counting;
+    {
+        std::pmr::vector<int> vec{&counting};
+        vec.resize(10);
+        REQUIRE(counting.allocations() == 1);
+        REQUIRE(counting.bytes() == 10 * sizeof(int));
+    }
+    REQUIRE(counting.allocations() == 1);
+    REQUIRE(counting.bytes() == 0);
+}
+
+TEST_CASE("FrameArena") {
+    et::CountingResource upstream;
+    et::FrameArena arena{64, &upstream};
+    REQUIRE(arena.capacity() == 64);
+    REQUIRE(upstream.allocations() == 1);
+
+    SECTION("Fitting frames use only the owned buffer") {
+        for (int i = 0; i < 3; ++i) {
+            (void)arena.resource()->allocate(32);
+            arena.reset();
+        }
+        REQUIRE(upstream.allocations() == 1);
+    }
+    SECTION("Buffer grows to fit the last frame") {
+        (void)arena.resource()->allocate(48);
+        (void)arena.resource()->allocate(48);
+        REQUIRE(upstream.allocations() == 2);
+        arena.reset();
+        REQUIRE(arena.capacity() > 96);
+        const auto allocations = upstream.allocations();
+
+        (void)arena.resource()->allocate(48);
+        (void)arena.resource()->allocate(48);
+        arena.reset();
+        REQUIRE(upstream.allocations() == allocations);
+    }
+}
+
+TEST_CASE("Elements in a memory resource") {
+    et::CountingResource pool;
+
+    SECTION("Elements are returned to their resource") {
+        auto text = et::make_element<et::ascii::Text>(&pool, "Text longer than small strings.");
+        // Element, shared string and its buffer.
+        REQUIRE(pool.allocations() == 3);
+        text->append(" Edits use the same resource.");
+        REQUIRE(pool.allocations() == 4);
+
+        std::unique_ptr<et::Element> elem = std::move(text);
+        elem.reset();
+        REQUIRE(pool.bytes() == 0);
+    }
+    SECTION("Containers keep children in their resource") {
+        auto flex = et::make_element<et::FlexContainer>(&pool, et::Direction::Horizontal);
+        const auto allocations = pool.allocations();
+        (void)flex->add(et::make_element<et::ascii::Text>(&pool, "a"));
+        REQUIRE(pool.allocations() > allocations + 1);
+
+        et::Screen screen{{1, 3}};
+        et::DrawingWindow window{et::Window{{0, 0}, {1, 3}}, screen};
+        (void)flex->calc_pref_size({1, 3});
+        flex->draw(window);
+        REQUIRE(to_string(screen.line(0)) == "a++");
+
+        flex.reset();
+        REQUIRE(pool.bytes() == 0);
+    }
+    SECTION("Copies keep their line index in their resource") {
+        et::ascii::Text text{"First line\nsecond line"};
+        (void)text.calc_pref_size({2, 12});
+
+        et::CountingResource heap;
+        const DefaultResource guard{&heap};
+        auto copy = et::make_element<et::ascii::Text>(&pool, text);
+        REQUIRE(copy->calc_pref_size({2, 12}) == et::Vec2{2, 11});
+        REQUIRE(heap.allocations() == 0);
+        // Element and the line index.
+        REQUIRE(pool.allocations() > 1);
+
+        copy.reset();
+        REQUIRE(pool.bytes() == 0);
+    }
+    SECTION("Heap elements") {
+        auto text = std::make_unique<et::ascii::Text>("abc");
+        REQUIRE(pool.allocations() == 0);
+    }
+}
+
+TEST_CASE("Texts rebuilt every frame allocate only from the arena") {
+    et::CountingResource heap;
+    const DefaultResource guard{&heap};
+    et::FrameArena arena;
+    const std::string content{"A paragraph of a long text wrapped into lines.\nAnother one."};
+    et::Screen screen{{6, 12}, std::pmr::new_delete_resource()};
+
+    const auto frame = [&] {
+        {
+            auto text = et::make_element<et::ascii::Text>(arena.resource(), et::c_borrow, content, 12);
+            (void)text->calc_pref_size(screen.size());
+            et::DrawingWindow window{et::Window{{0, 0}, screen.size()}, screen, arena.resource()};
+            text->draw(window);
+        }
+        arena.reset();
+    };
+    frame();
+    REQUIRE(to_string(screen.line(0)) == "A paragraph ");
+    REQUIRE(to_string(screen.line(4)) == "Another one.");
+
+    const auto before = heap.allocations();
+    for (int i = 0; i < 10; ++i)
+        frame();
+    REQUIRE(heap.allocations() == before);
+}
+
+TEST_CASE("Steady-state frames do not allocate") {
+    // Upstream of everything that is not given a resource explicitly, including
+    // the compositor's arena.
+    et::CountingResource heap;
+    const DefaultResource guard{&heap};
+    std::pmr::unsynchronized_pool_resource pool{std::pmr::new_delete_resource()};
+    et::Compositor compositor{{6, 20}};
+
+    auto root = et::make_element<et::FlexContainer>(&pool, et::Direction::Vertical);
+    (void)root->add(et::make_element<et::ascii::Text>(&pool, "Header above a tree"));
+
+    auto tree = et::make_element<et::FlatTree>(&pool);
+    (void)tree->open(et::FlatTree::Kind::HStack);
+    (void)tree->emplace<et::ascii::Text>("left ");
+    (void)tree->emplace<et::ascii::Text>("right");
+    tree->close();
+    (void)root->add(std::move(tree));
+
+    auto list = et::make_element<et::VirtualList>(
+        &pool, 100,
+        [&pool](std::size_t row) { return et::make_element<et::ascii::Text>(&pool, std::to_string(row) + "\nnext"); },
+        [](std::size_t) { return 2; });
+    // Top row is cut off, it is drawn through the scratch memory.
+    list->scroll_to(3);
+    (void)root->add(std::move(list), {.m_weight = 1});
+    const auto layer = compositor.add_layer(std::move(root), {{0, 0}, {6, 20}});
+
+    // The indexer allocates on its own thread, the draws must not.
+    const TempFile file{"first\nsecond\nlast\n"};
+    auto log_elem = std::make_unique<et::LogView>(file.m_path.string(), 1ms);
+    auto& log = *log_elem;
+    const auto log_layer = compositor.add_layer(std::move(log_elem), {{4, 10}, {2, 10}});
+    const auto deadline = std::chrono::steady_clock::now() + 5s;
+    while (log.line_count() < 3 && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(1ms);
+    REQUIRE(log.line_count() == 3);
+
+    const auto frame = [&] {
+        compositor.invalidate(layer);
+        compositor.invalidate(log_layer);
+        (void)compositor.compose();
+    };
+    frame();
+    frame();
+    const auto& screen = compositor.screen();
+    REQUIRE(to_string(screen.line(0)) == "Header above a tree ");
+    REQUIRE(to_string(screen.line(1)) == "left right          ");
+    REQUIRE(to_string(screen.line(2)) == "next                ");
+    REQUIRE(to_string(screen.line(3)) == "2                   ");
+    REQUIRE(to_string(screen.line(4)) == "next      first     ");
+    REQUIRE(to_string(screen.line(5)) == "3         second    ");
+
+    const auto before = heap.allocations();
+    const auto capacity = compositor.arena().capacity();
+    std::size_t global_allocations = 0;
+    {
+        const GlobalAllocations counting;
+        for (int i = 0; i < 10; ++i)
+            frame();
+        global_allocations = counting.m_count;
+    }
+    REQUIRE(global_allocations == 0);
+    REQUIRE(heap.allocations() == before);
+    REQUIRE(compositor.arena().capacity() == capacity);
+}
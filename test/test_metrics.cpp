@@ -0,0 +1,132 @@
+/*******************************************************************************
+ * @file test_metrics.cpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <eltau/exception.hpp>
+#include <eltau/metrics.hpp>
+
+#include "screen_utils.hpp"
+
+namespace et = eltau;
+using namespace std::chrono_literals;
+
+namespace {
+/*******************************************************************************
+ * @brief Lay out and draw @p elem over the whole @p screen.
+ ******************************************************************************/
+void
+draw(et::Element& elem, et::Screen& screen) {
+    (void)elem.calc_pref_size(screen.size());
+    et::DrawingWindow window{{{0, 0}, screen.size()}, screen};
+    elem.draw(window);
+}
+} // namespace
+
+TEST_CASE("Counter sums the shards of all threads") {
+    static_assert(alignof(et::Counter) == et::c_cache_line);
+    et::Counter counter;
+    REQUIRE(counter.load() == 0);
+
+    constexpr std::size_t c_threads = 8;
+    constexpr std::size_t c_adds = 100000;
+    std::vector<std::thread> workers;
+    for (std::size_t t = 0; t < c_threads; ++t)
+        workers.emplace_back([&counter] {
+            for (std::size_t i = 0; i < c_adds; ++i)
+                counter.add();
+        });
+    for (auto& worker : workers)
+        worker.join();
+    counter.add(5);
+    REQUIRE(counter.load() == c_threads * c_adds + 5);
+}
+
+TEST_CASE("RateMeter smooths the rate") {
+    const et::RateMeter::Clock::time_point start{1h};
+    et::RateMeter meter{1s};
+    REQUIRE(meter.sample(100, start) == 0.0);
+    // Repeated samples are merged.
+    REQUIRE(meter.sample(200, start) == 0.0);
+
+    // 100 per 100ms, weighted by 1 - e^-0.1.
+    const auto first = meter.sample(110, start + 100ms);
+    REQUIRE(first == Catch::Approx(100.0 * (1.0 - std::exp(-0.1))));
+    REQUIRE(meter.rate() == first);
+
+    // A steady rate is converged to.
+    for (int i = 2; i <= 100; ++i)
+        (void)meter.sample(100 + static_cast<std::uint64_t>(i) * 10, start + i * 100ms);
+    REQUIRE(meter.rate() == Catch::Approx(100.0).epsilon(0.001));
+}
+
+TEST_CASE("ProgressBar") {
+    const auto done = std::make_shared<et::Counter>();
+    et::ProgressBar bar{done, 10};
+    et::Screen screen{{2, 14}};
+
+    draw(bar, screen);
+    REQUIRE(to_string(screen.line(0)) == "[       ]   0%");
+    REQUIRE(to_string(screen.line(1)) == "              ");
+
+    done->add(5);
+    // Sampled when drawn, not when measured.
+    (void)bar.calc_pref_size(screen.size());
+    REQUIRE(to_string(screen.line(0)) == "[       ]   0%");
+    draw(bar, screen);
+    REQUIRE(to_string(screen.line(0)) == "[###    ]  50%");
+    REQUIRE(bar.get_last_pref_size() == et::Vec2{1, 14});
+
+    done->add(20);
+    draw(bar, screen);
+    REQUIRE(to_string(screen.line(0)) == "[#######] 100%");
+
+    bar.set_total(100);
+    et::Screen narrow{{1, 6}};
+    draw(bar, narrow);
+    REQUIRE(to_string(narrow.line(0)) == " 25%  ");
+
+    bar.set_total(0);
+    draw(bar, narrow);
+    REQUIRE(to_string(narrow.line(0)) == "  0%  ");
+
+    REQUIRE_THROWS_AS(et::ProgressBar(nullptr, 1), et::EltauException);
+}
+
+TEST_CASE("Counter labels") {
+    const auto counter = std::make_shared<et::Counter>();
+    counter->add(42);
+    et::Screen screen{{1, 12}};
+
+    et::CounterLabel label{counter, "files"};
+    REQUIRE(label.calc_pref_size({3, 20}) == et::Vec2{1, 9});
+    draw(label, screen);
+    REQUIRE(to_string(screen.line(0)) == "files: 42   ");
+    // Measured as of the last draw.
+    counter->add(100);
+    REQUIRE(label.calc_pref_size({3, 20}) == et::Vec2{1, 9});
+    draw(label, screen);
+    REQUIRE(to_string(screen.line(0)) == "files: 142  ");
+    REQUIRE(label.calc_pref_size({3, 20}) == et::Vec2{1, 10});
+
+    et::CounterLabel bare{counter, ""};
+    REQUIRE(bare.calc_pref_size({3, 20}) == et::Vec2{1, 3});
+
+    et::RateLabel rate{counter};
+    draw(rate, screen);
+    REQUIRE(to_string(screen.line(0)) == "0.0/s       ");
+    REQUIRE(rate.rate() == 0.0);
+
+    REQUIRE_THROWS_AS(et::CounterLabel(nullptr, "x"), et::EltauException);
+    REQUIRE_THROWS_AS(et::RateLabel(nullptr), et::EltauException);
+}
@@ -203,6 +203,106 @@ TEST_CASE("Window cell and line equality") {
     }
 }
 
+TEST_CASE("Cells are stored row-major") {
+    const et::Vec2 size{3, 4};
+    et::Screen s{size};
+    for (std::size_t r = 0; r < size.m_row; ++r)
+        for (std::size_t c = 0; c < size.m_col; ++c)
+            REQUIRE(s[{.m_row = r, .m_col = c}] == &s.line(r)[c]);
+}
+
+TEST_CASE("Screen resize") {
+    et::Screen s{{3, 4}};
+    const auto id = [](std::size_t r, std::size_t c) { return static_cast<char>('a' + r * 4 + c); };
+    for (std::size_t r = 0; r < 3; ++r)
+        for (std::size_t c = 0; c < 4; ++c)
+            s[{r, c}]->m_char[0] = id(r, c);
+    // Content of the overlap is kept, the rest is new.
+    const auto check = [&](et::Vec2 size) {
+        REQUIRE(s.size() == size);
+        for (std::size_t r = 0; r < size.m_row; ++r)
+            for (std::size_t c = 0; c < size.m_col; ++c)
+                REQUIRE(s[{r, c}]->m_char[0] == (r < 3 && c < 4 ? id(r, c) : '+'));
+    };
+    const auto* storage = s.line(0).data();
+
+    SECTION("Narrower") {
+        s.resize({3, 2});
+        check({3, 2});
+    }
+    SECTION("Wider") {
+        s.resize({3, 7});
+        check({3, 7});
+    }
+    SECTION("Shorter and wider") {
+        s.resize({2, 6});
+        check({2, 6});
+        REQUIRE(s.line(0).data() == storage);
+    }
+    SECTION("Taller and narrower") {
+        s.resize({5, 3});
+        check({5, 3});
+    }
+    SECTION("Capacity is reused") {
+        s.resize({1, 1});
+        check({1, 1});
+        s.resize({2, 5});
+        REQUIRE(s.line(0).data() == storage);
+        REQUIRE(s[{0, 0}]->m_char[0] == 'a');
+        REQUIRE(s[{1, 0}]->m_char[0] == '+');
+    }
+    SECTION("Empty") {
+        s.resize({0, 0});
+        REQUIRE(s.line(0).empty());
+        s.resize({3, 4});
+        REQUIRE(s[{2, 3}]->m_char[0] == '+');
+    }
+}
+
+TEST_CASE("Window intersection") {
+    const et::Window win{{1, 2}, {3, 4}};
+
+    REQUIRE(!win.empty());
+    REQUIRE(et::Window{{1, 2}, {0, 4}}.empty());
+    REQUIRE(et::Window{{1, 2}, {3, 0}}.empty());
+
+    REQUIRE(win.intersect(win) == win);
+    REQUIRE(win.intersect({{0, 0}, {2, 3}}) == et::Window{{1, 2}, {1, 1}});
+    REQUIRE(win.intersect({{2, 3}, {10, 10}}) == et::Window{{2, 3}, {2, 3}});
+    REQUIRE(win.intersect({{4, 0}, {10, 10}}).empty());
+    REQUIRE(win.intersect({{0, 6}, {10, 10}}).empty());
+}
+
+TEST_CASE("DrawingWindow visible part") {
+    et::Screen s{{4, 6}};
+
+    REQUIRE(et::DrawingWindow{et::Window{{1, 2}, {2, 3}}, s}.visible() == et::Window{{1, 2}, {2, 3}});
+    REQUIRE(et::DrawingWindow{et::Window{{2, 4}, {5, 5}}, s}.visible() == et::Window{{2, 4}, {2, 2}});
+    REQUIRE(et::DrawingWindow{et::Window{{0, 6}, {2, 2}}, s}.visible().empty());
+}
+
+TEST_CASE("DrawingWindow lines") {
+    constexpr et::Vec2 size{4, 6};
+    et::Screen s{size};
+
+    SECTION("Lines are restricted to the window") {
+        et::DrawingWindow dwin{et::Window{{1, 2}, {2, 3}}, s};
+        REQUIRE(dwin.line(0).empty());
+        REQUIRE(dwin.line(1).data() == s[{1, 2}]);
+        REQUIRE(dwin.line(1).size() == 3);
+        REQUIRE(dwin.line(2).data() == s[{2, 2}]);
+        REQUIRE(dwin.line(3).empty());
+    }
+    SECTION("Lines are restricted to the screen") {
+        et::DrawingWindow dwin{et::Window{{2, 4}, {5, 5}}, s};
+        REQUIRE(dwin.line(3).size() == 2);
+        REQUIRE(dwin.line(4).empty());
+
+        et::DrawingWindow outside{et::Window{{0, size.m_col}, {2, 2}}, s};
+        REQUIRE(outside.line(0).empty());
+    }
+}
+
 TEST_CASE("DrawingWindow captures correct window") {
 
     constexpr et::Vec2 origin{10, 1};
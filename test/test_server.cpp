@@ -0,0 +1,224 @@
+/*******************************************************************************
+ * @file test_server.cpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <fcntl.h>
+#include <poll.h>
+#include <pty.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <eltau/server.hpp>
+#include <eltau/text.hpp>
+
+namespace et = eltau;
+using namespace std::chrono_literals;
+
+namespace {
+/*******************************************************************************
+ * @brief Pseudo-terminal, the server serves the slave, the test is the client.
+ ******************************************************************************/
+struct Pty {
+    Pty() {
+        winsize size{.ws_row = 4, .ws_col = 20, .ws_xpixel = 0, .ws_ypixel = 0};
+        REQUIRE(openpty(&m_master, &m_slave, nullptr, nullptr, &size) == 0);
+    }
+    Pty(const Pty& other) = delete;
+    Pty(Pty&& other) noexcept = delete;
+    Pty&
+    operator=(const Pty& other) = delete;
+    Pty&
+    operator=(Pty&& other) noexcept = delete;
+    ~Pty() noexcept {
+        close_master();
+        (void)close(m_slave);
+    }
+
+    void
+    close_master() noexcept {
+        if (m_master >= 0)
+            (void)close(std::exchange(m_master, -1));
+    }
+
+    /*******************************************************************************
+     * @brief Type @p input into the terminal.
+     ******************************************************************************/
+    void
+    type(std::string_view input) const {
+        REQUIRE(write(m_master, input.data(), input.size()) == static_cast<ssize_t>(input.size()));
+    }
+
+    /*******************************************************************************
+     * @brief Everything written by the server so far.
+     ******************************************************************************/
+    std::string
+    output() const {
+        std::string out;
+        std::array<char, 1024> buffer{};
+        pollfd fd{.fd = m_master, .events = POLLIN, .revents = 0};
+        while (::poll(&fd, 1, 50) == 1) {
+            const auto len = read(m_master, buffer.data(), buffer.size());
+            if (len <= 0)
+                break;
+            out.append(buffer.data(), static_cast<std::size_t>(len));
+        }
+        return out;
+    }
+
+    int m_master = -1;
+    int m_slave = -1;
+};
+
+bool
+contains(std::string_view haystack, std::string_view needle) {
+    return haystack.find(needle) != std::string_view::npos;
+}
+} // namespace
+
+TEST_CASE("Server draws sessions independently") {
+    et::EventLoop loop{-1};
+    et::Server server{loop};
+    Pty first_pty;
+    Pty second_pty;
+
+    auto first_text = std::make_unique<et::ascii::Text>("first");
+    auto& first = *first_text;
+    const auto first_id = server.add_session(first_pty.m_slave, std::move(first_text));
+    const auto second_id = server.add_session(second_pty.m_slave, std::make_unique<et::ascii::Text>("second"));
+    REQUIRE(server.session_count() == 2);
+    REQUIRE((fcntl(first_pty.m_slave, F_GETFL) & O_NONBLOCK) != 0);
+
+    (void)loop.poll(-1ms);
+    const auto first_out = first_pty.output();
+    REQUIRE(contains(first_out, "\033[?1049h"));
+    REQUIRE(contains(first_out, "first"));
+    REQUIRE_FALSE(contains(first_out, "second"));
+    REQUIRE(contains(second_pty.output(), "second"));
+    // The size is queried from the pty.
+    REQUIRE(server.terminal(first_id).compositor().screen().size() == et::Vec2{4, 20});
+
+    first.replace(0, std::string::npos, "changed");
+    server.terminal(first_id).compositor().invalidate(server.terminal(first_id).root_layer());
+    server.request_redraw(first_id);
+    (void)loop.poll(-1ms);
+    REQUIRE(contains(first_pty.output(), "changed"));
+    // Untouched sessions are not drawn.
+    REQUIRE(second_pty.output().empty());
+
+    server.resize(second_id, {2, 10});
+    REQUIRE(server.terminal(second_id).compositor().screen().size() == et::Vec2{2, 10});
+    REQUIRE_THROWS(server.terminal(-1));
+}
+
+TEST_CASE("Server dispatches input of sessions") {
+    et::EventLoop loop{-1};
+    et::Server server{loop};
+    Pty first_pty;
+    Pty second_pty;
+    const auto first_id = server.add_session(first_pty.m_slave, std::make_unique<et::ascii::Text>("a"));
+    const auto second_id = server.add_session(second_pty.m_slave, std::make_unique<et::ascii::Text>("b"));
+
+    std::vector<std::pair<et::Server::SessionId, char32_t>> typed;
+    server.on_input([&](et::Server::SessionId id, const et::InputEvent& event) {
+        typed.emplace_back(id, event.m_char);
+        if (event.m_char == 'q')
+            server.remove_session(id);
+    });
+
+    // The ptys are in raw mode, the bytes arrive at once.
+    first_pty.type("ab");
+    second_pty.type("c");
+    while (typed.size() < 3)
+        (void)loop.poll(-1ms);
+    REQUIRE(typed.size() == 3);
+    REQUIRE(std::count(typed.begin(), typed.end(), std::pair{first_id, U'a'}) == 1);
+    REQUIRE(std::count(typed.begin(), typed.end(), std::pair{first_id, U'b'}) == 1);
+    REQUIRE(std::count(typed.begin(), typed.end(), std::pair{second_id, U'c'}) == 1);
+
+    SECTION("Sessions may be removed by their input") {
+        first_pty.type("qx");
+        while (server.session_count() == 2)
+            (void)loop.poll(-1ms);
+        REQUIRE(typed.back() == std::pair{first_id, U'q'});
+        // The terminal is restored.
+        REQUIRE((fcntl(first_pty.m_slave, F_GETFL) & O_NONBLOCK) == 0);
+        termios term{};
+        REQUIRE(tcgetattr(first_pty.m_slave, &term) == 0);
+        REQUIRE((term.c_lflag & ICANON) != 0);
+        REQUIRE(contains(first_pty.output(), "\033[?1049l"));
+    }
+    SECTION("Lone ESC is resolved by a timer") {
+        typed.clear();
+        second_pty.type("\033");
+        while (typed.empty())
+            (void)loop.poll(-1ms);
+        REQUIRE(typed == std::vector{std::pair{second_id, char32_t{0}}});
+    }
+    SECTION("ESC arriving while the timer is set gets its own deadline") {
+        typed.clear();
+        second_pty.type("\033");
+        (void)loop.poll(-1ms);
+        // Completes the first ESC, the second one outlives its timer.
+        std::this_thread::sleep_for(15ms);
+        second_pty.type("[A\033");
+        const auto until = std::chrono::steady_clock::now() + 1s;
+        while (typed.size() < 2 && std::chrono::steady_clock::now() < until)
+            (void)loop.poll(10ms);
+        REQUIRE(typed.size() == 2);
+    }
+}
+
+TEST_CASE("Server waits for slow clients") {
+    et::EventLoop loop{-1};
+    et::Server server{loop};
+    Pty pty;
+    // More than the pty accepts at once.
+    const std::string content(200'000, 'x');
+    const auto id = server.add_session(pty.m_slave, std::make_unique<et::ascii::Text>(content), et::Vec2{500, 400});
+    (void)loop.poll(-1ms);
+    auto& terminal = server.terminal(id);
+    REQUIRE(terminal.output_pending());
+
+    // Nothing to do until the client reads.
+    REQUIRE(loop.poll(20ms) == 0);
+    std::string out;
+    while (terminal.output_pending()) {
+        out += pty.output();
+        (void)loop.poll(100ms);
+    }
+    out += pty.output();
+    REQUIRE(std::count(out.begin(), out.end(), 'x') == static_cast<std::ptrdiff_t>(content.size()));
+}
+
+TEST_CASE("Server removes sessions closed by clients") {
+    et::EventLoop loop{-1};
+    et::Server server{loop};
+    std::vector<et::Server::SessionId> closed;
+    server.on_close([&](et::Server::SessionId id) { closed.push_back(id); });
+
+    std::vector<std::unique_ptr<Pty>> ptys;
+    for (int i = 0; i < 10; ++i) {
+        ptys.push_back(std::make_unique<Pty>());
+        (void)server.add_session(ptys.back()->m_slave, std::make_unique<et::ascii::Text>("session"), et::Vec2{2, 8});
+    }
+    (void)loop.poll(-1ms);
+    // Sizes are not queried when given.
+    REQUIRE(server.terminal(ptys[0]->m_slave).compositor().screen().size() == et::Vec2{2, 8});
+
+    ptys[3]->close_master();
+    while (closed.empty())
+        (void)loop.poll(-1ms);
+    REQUIRE(closed == std::vector{ptys[3]->m_slave});
+    REQUIRE(server.session_count() == 9);
+}
@@ -0,0 +1,135 @@
+/*******************************************************************************
+ * @file test_shape_cache.cpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+
+#include <memory>
+#include <string>
+
+#include <catch2/catch_test_macros.hpp>
+#include <eltau/shape_cache.hpp>
+#include <eltau/text.hpp>
+
+#include "screen_utils.hpp"
+
+namespace et = eltau;
+
+using namespace std::string_view_literals;
+
+TEST_CASE("ShapeCache lookups") {
+    et::ShapeCache cache;
+
+    SECTION("Miss shapes the text") {
+        const auto& cells = cache.shape("CPU\x01", et::Style::Bold, 10);
+        REQUIRE(cells.size() == et::Vec2{1, 4});
+        REQUIRE(to_string(cells.line(0)) == "CPU ");
+        REQUIRE(cells.line(0)[0].m_style == et::Style::Bold);
+        REQUIRE(cache.stats().m_misses == 1);
+        REQUIRE(cache.stats().m_hits == 0);
+        REQUIRE(cache.stats().m_entries == 1);
+        REQUIRE(cache.stats().m_bytes > 0);
+    }
+    SECTION("Same key hits") {
+        std::string label{"OK"};
+        (void)cache.shape(label, et::Style::Bold, 10);
+        // Equal content in a different buffer.
+        const auto& cells = cache.shape(std::string{"OK"}, et::Style::Bold, 10);
+        REQUIRE(to_string(cells.line(0)) == "OK");
+        REQUIRE(cache.stats().m_hits == 1);
+        REQUIRE(cache.stats().hit_rate() == 0.5);
+    }
+    SECTION("Style and wrap limit are part of the key") {
+        (void)cache.shape("abcd", et::Style::Bold, 10);
+        (void)cache.shape("abcd", et::Style::Dim, 10);
+        const auto& wrapped = cache.shape("abcd", et::Style::Dim, 2);
+        REQUIRE(wrapped.size() == et::Vec2{2, 2});
+        REQUIRE(to_string(wrapped.line(1)) == "cd");
+        REQUIRE(cache.stats().m_misses == 3);
+        // Limits above the length are equivalent.
+        (void)cache.shape("abcd", et::Style::Dim, 4);
+        REQUIRE(cache.stats().m_hits == 1);
+    }
+    SECTION("Clear keeps statistics") {
+        (void)cache.shape("abcd", et::Style::Bold, 10);
+        cache.clear();
+        REQUIRE(cache.stats().m_entries == 0);
+        REQUIRE(cache.stats().m_bytes == 0);
+        REQUIRE(cache.stats().m_misses == 1);
+        (void)cache.shape("abcd", et::Style::Bold, 10);
+        REQUIRE(cache.stats().m_misses == 2);
+    }
+    SECTION("Long texts are not cacheable") {
+        et::ShapeCache small{et::ShapeCache::c_default_max_bytes, 3};
+        REQUIRE(small.cacheable("abc"));
+        REQUIRE_FALSE(small.cacheable("abcd"));
+    }
+}
+
+TEST_CASE("ShapeCache eviction") {
+    et::ShapeCache probe;
+    (void)probe.shape("a", et::Style{}, 10);
+    const auto entry_bytes = probe.stats().m_bytes;
+
+    // Room for exactly two one-character entries.
+    et::ShapeCache cache{2 * entry_bytes};
+    (void)cache.shape("a", et::Style{}, 10);
+    (void)cache.shape("b", et::Style{}, 10);
+    REQUIRE(cache.stats().m_evictions == 0);
+
+    // Touch "a" so "b" is the least recently used.
+    (void)cache.shape("a", et::Style{}, 10);
+    (void)cache.shape("c", et::Style{}, 10);
+    REQUIRE(cache.stats().m_evictions == 1);
+    REQUIRE(cache.stats().m_entries == 2);
+    REQUIRE(cache.stats().m_bytes == 2 * entry_bytes);
+
+    const auto hits = cache.stats().m_hits;
+    (void)cache.shape("a", et::Style{}, 10);
+    REQUIRE(cache.stats().m_hits == hits + 1);
+    (void)cache.shape("b", et::Style{}, 10);
+    REQUIRE(cache.stats().m_hits == hits + 1);
+
+    SECTION("The most recent entry is kept even if too large") {
+        et::ShapeCache tiny{1};
+        const auto& cells = tiny.shape("abc", et::Style{}, 10);
+        REQUIRE(to_string(cells.line(0)) == "abc");
+        REQUIRE(tiny.stats().m_entries == 1);
+        (void)tiny.shape("def", et::Style{}, 10);
+        REQUIRE(tiny.stats().m_entries == 1);
+        REQUIRE(tiny.stats().m_evictions == 1);
+    }
+}
+
+TEST_CASE("Text drawn through ShapeCache") {
+    auto cache = std::make_shared<et::ShapeCache>();
+    et::Screen screen{{3, 4}};
+    et::DrawingWindow window{et::Window{{0, 0}, {3, 4}}, screen};
+
+    et::ascii::Text text{"Hello\x02", 3};
+    text.set_style(et::Style::Underline);
+    text.set_shape_cache(cache);
+
+    REQUIRE(text.calc_pref_size({10, 10}) == et::Vec2{2, 3});
+    text.draw(window);
+    REQUIRE(to_string(screen.line(0)) == "Hel ");
+    REQUIRE(to_string(screen.line(1)) == "lo  ");
+    REQUIRE(to_string(screen.line(2)) == "    ");
+    REQUIRE(screen.line(2)[3].m_style == et::Style::Underline);
+
+    // Second label with the same text is a hit.
+    et::ascii::Text other{"Hello\x02", 3};
+    other.set_style(et::Style::Underline);
+    other.set_shape_cache(cache);
+    et::Screen expected{{3, 4}};
+    et::DrawingWindow expected_window{et::Window{{0, 0}, {3, 4}}, expected};
+    const auto hits = cache->stats().m_hits;
+    other.draw(expected_window);
+    REQUIRE(cache->stats().m_hits == hits + 1);
+
+    // Same output as without the cache.
+    text.set_shape_cache(nullptr);
+    text.draw(expected_window);
+    for (std::size_t r = 0; r < 3; ++r)
+        REQUIRE(to_string(screen.line(r)) == to_string(expected.line(r)));
+}
@@ -0,0 +1,132 @@
+/*******************************************************************************
+ * @file test_shared_subtree.cpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+
+#include <memory>
+#include <string>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <eltau/compositor.hpp>
+#include <eltau/exception.hpp>
+#include <eltau/flex.hpp>
+#include <eltau/shared_subtree.hpp>
+#include <eltau/text.hpp>
+
+#include "screen_utils.hpp"
+
+namespace et = eltau;
+
+namespace {
+/*! Prefers half of the space, counts the layouts. */
+class Half : public et::Element {
+public:
+    std::size_t m_measured = 0;
+
+private:
+    et::Vec2
+    do_calc_pref_size(et::Vec2 max_size) override {
+        ++m_measured;
+        return {max_size.m_row / 2, max_size.m_col / 2};
+    }
+    void
+    do_draw(et::DrawingWindow& /*window*/) override {}
+};
+} // namespace
+
+TEST_CASE("SharedSubtree is drawn once per size and version") {
+    const auto subtree = std::make_shared<et::SharedSubtree>(std::make_unique<et::ascii::Text>("shared\npanel"));
+    REQUIRE(subtree->version() == 0);
+
+    // Two sessions of the same size and one smaller.
+    et::Compositor first{{3, 8}};
+    et::Compositor second{{3, 8}};
+    et::Compositor small{{2, 4}};
+    auto shared = std::make_unique<et::SharedElement>(subtree);
+    auto& shown = *shared;
+    const auto first_layer = first.add_layer(std::move(shared), {{0, 0}, {3, 8}});
+    (void)second.add_layer(std::make_unique<et::SharedElement>(subtree), {{0, 0}, {3, 8}});
+    (void)small.add_layer(std::make_unique<et::SharedElement>(subtree), {{0, 0}, {2, 4}});
+
+    (void)first.compose();
+    (void)second.compose();
+    REQUIRE(subtree->draw_count() == 1);
+    (void)small.compose();
+    REQUIRE(subtree->draw_count() == 2);
+
+    REQUIRE(to_string(second.screen().line(0)) == "shared  ");
+    REQUIRE(to_string(second.screen().line(1)) == "panel   ");
+    REQUIRE(to_string(small.screen().line(0)) == "shar");
+
+    SECTION("Changes start a new version") {
+        subtree->update([](et::Element& root) { static_cast<et::ascii::Text&>(root).replace(0, 6, "SHARED"); });
+        REQUIRE(subtree->version() == 1);
+        REQUIRE(shown.stale());
+
+        first.invalidate(first_layer);
+        (void)first.compose();
+        REQUIRE_FALSE(shown.stale());
+        REQUIRE(subtree->draw_count() == 3);
+        REQUIRE(to_string(first.screen().line(0)) == "SHARED  ");
+    }
+    SECTION("Whole subtree can be replaced") {
+        subtree->replace(std::make_unique<et::ascii::Text>("new"));
+        REQUIRE(subtree->version() == 1);
+        REQUIRE(to_string(subtree->render({1, 4}).line(0)) == "new ");
+        REQUIRE_THROWS_AS(subtree->replace(nullptr), et::EltauException);
+    }
+}
+
+TEST_CASE("SharedSubtree caches layouts") {
+    auto half = std::make_unique<Half>();
+    auto& measured = half->m_measured;
+    et::SharedSubtree subtree{std::move(half), 2};
+
+    REQUIRE(subtree.pref_size({10, 20}) == et::Vec2{5, 10});
+    REQUIRE(subtree.pref_size({10, 20}) == et::Vec2{5, 10});
+    REQUIRE(measured == 1);
+    REQUIRE(subtree.pref_size({4, 4}) == et::Vec2{2, 2});
+    REQUIRE(measured == 2);
+
+    // The oldest size is evicted.
+    REQUIRE(subtree.pref_size({6, 6}) == et::Vec2{3, 3});
+    REQUIRE(subtree.pref_size({4, 4}) == et::Vec2{2, 2});
+    REQUIRE(measured == 3);
+    REQUIRE(subtree.pref_size({10, 20}) == et::Vec2{5, 10});
+    REQUIRE(measured == 4);
+
+    subtree.update([](et::Element&) {});
+    REQUIRE(subtree.pref_size({10, 20}) == et::Vec2{5, 10});
+    REQUIRE(measured == 5);
+}
+
+TEST_CASE("SharedSubtree clears the previous version") {
+    auto text = std::make_unique<et::ascii::Text>("abcdef");
+    auto& shown = *text;
+    auto flex = std::make_unique<et::FlexContainer>(et::Direction::Horizontal);
+    (void)flex->add(std::move(text));
+    et::SharedSubtree subtree{std::move(flex)};
+
+    REQUIRE(to_string(subtree.render({1, 8}).line(0)) == "abcdef  ");
+    // The container leaves the space after the shorter text undrawn.
+    subtree.update([&shown](et::Element&) { shown.replace(2, 4, ""); });
+    REQUIRE(to_string(subtree.render({1, 8}).line(0)) == "ab      ");
+}
+
+TEST_CASE("SharedElement clips the cached cells") {
+    const auto subtree = std::make_shared<et::SharedSubtree>(std::make_unique<et::ascii::Text>("abcd\nefgh"));
+    et::SharedElement elem{subtree};
+
+    et::Screen screen{{3, 4}};
+    et::DrawingWindow window{{{1, 2}, {2, 4}}, screen};
+    (void)elem.calc_pref_size({2, 4});
+    elem.draw(window);
+    REQUIRE(to_string(screen.line(0)) == "++++");
+    REQUIRE(to_string(screen.line(1)) == "++ab");
+    REQUIRE(to_string(screen.line(2)) == "++ef");
+
+    REQUIRE_THROWS_AS(et::SharedElement{nullptr}, et::EltauException);
+    REQUIRE_THROWS_AS(et::SharedSubtree{nullptr}, et::EltauException);
+}
@@ -0,0 +1,106 @@
+/*******************************************************************************
+ * @file test_table.cpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+
+#include <string>
+
+#include <catch2/catch_test_macros.hpp>
+#include <eltau/exception.hpp>
+#include <eltau/table.hpp>
+
+#include "screen_utils.hpp"
+
+namespace et = eltau;
+
+TEST_CASE("Table") {
+    et::Table table{{{.m_title = "id"}, {.m_title = "name"}}};
+
+    SECTION("Rows and cells") {
+        REQUIRE(table.column_count() == 2);
+        REQUIRE(table.add_row({"1", "one"}) == 0);
+        REQUIRE(table.add_row({"2"}) == 1);
+        REQUIRE(table.row_count() == 2);
+        REQUIRE(table.cell(1, 1).empty());
+        table.set_cell(1, 1, "two");
+        REQUIRE(table.cell(1, 1) == "two");
+
+        REQUIRE_THROWS_AS(table.add_row({"3", "three", "x"}), et::EltauException);
+        REQUIRE_THROWS_AS(table.set_row(2, {}), et::EltauException);
+        REQUIRE_THROWS_AS(table.set_cell(0, 2, ""), et::EltauException);
+        REQUIRE_THROWS_AS(table.cell(2, 0), et::EltauException);
+        REQUIRE_THROWS_AS(table.sort(2), et::EltauException);
+    }
+    SECTION("Natural widths are kept up-to-date") {
+        REQUIRE(table.natural_width(0) == 2);
+        REQUIRE(table.natural_width(1) == 4);
+        (void)table.add_row({"1", "abcdef"});
+        (void)table.add_row({"10", "abcdefgh"});
+        REQUIRE(table.natural_width(1) == 8);
+        // Widest cell shrinks, the next widest one is used.
+        table.set_cell(1, 1, "ab");
+        REQUIRE(table.natural_width(1) == 6);
+        table.set_row(0, {"12345", "a"});
+        REQUIRE(table.natural_width(0) == 5);
+        REQUIRE(table.natural_width(1) == 4);
+        REQUIRE(table.natural_width(2) == 0);
+    }
+    SECTION("Sorting permutes only the displayed order") {
+        (void)table.add_row({"b", "1"});
+        (void)table.add_row({"a", "2"});
+        (void)table.add_row({"b", "0"});
+        table.sort(0);
+        REQUIRE(table.displayed(0) == 1);
+        REQUIRE(table.displayed(1) == 0);
+        REQUIRE(table.displayed(2) == 2);
+        table.sort(1, true);
+        REQUIRE(table.displayed(0) == 1);
+        REQUIRE(table.displayed(2) == 2);
+        REQUIRE(table.displayed(3) == 3);
+        REQUIRE(table.cell(0, 0) == "b");
+    }
+    SECTION("Draw") {
+        et::Screen screen{{3, 10}};
+        et::DrawingWindow window{et::Window{{0, 0}, {3, 10}}, screen};
+        (void)table.add_row({"1", "one"});
+        REQUIRE(table.calc_pref_size({3, 10}) == et::Vec2{2, 7});
+        table.draw(window);
+        REQUIRE(to_string(screen.line(0)) == "id name   ");
+        REQUIRE(screen.line(0)[0].m_style == et::Style::Bold);
+        REQUIRE(to_string(screen.line(1)) == "1  one    ");
+        REQUIRE(to_string(screen.line(2)) == "          ");
+    }
+    SECTION("Weights and truncation") {
+        et::Table weighted{{{.m_title = "a", .m_flex = {.m_weight = 1}}, {.m_title = "b", .m_flex = {.m_max = 2}}}};
+        (void)weighted.add_row({"x", "long"});
+        et::Screen screen{{2, 6}};
+        et::DrawingWindow window{et::Window{{0, 0}, {2, 6}}, screen};
+        REQUIRE(weighted.calc_pref_size({2, 10}) == et::Vec2{2, 4});
+        weighted.draw(window);
+        REQUIRE(to_string(screen.line(0)) == "a   b ");
+        REQUIRE(to_string(screen.line(1)) == "x   lo");
+        REQUIRE(weighted.solver().solve_count() == 1);
+        // Unrelated changes keep the column widths.
+        weighted.set_cell(0, 0, "y");
+        weighted.draw(window);
+        REQUIRE(weighted.solver().solve_count() == 1);
+    }
+    SECTION("Only the visible rows and columns are drawn") {
+        for (int i = 0; i < 100; ++i)
+            (void)table.add_row({std::to_string(i), "n" + std::to_string(i)});
+        et::Screen screen{{3, 4}};
+        et::DrawingWindow window{et::Window{{0, 0}, {3, 4}}, screen};
+        table.scroll_to(50);
+        table.scroll_to_column(1);
+        table.draw(window);
+        REQUIRE(to_string(screen.line(0)) == "name");
+        REQUIRE(to_string(screen.line(1)) == "n50 ");
+        REQUIRE(to_string(screen.line(2)) == "n51 ");
+        // Clamped to fill the view.
+        table.scroll_to(1000);
+        table.draw(window);
+        REQUIRE(to_string(screen.line(1)) == "n98 ");
+        REQUIRE(to_string(screen.line(2)) == "n99 ");
+    }
+}
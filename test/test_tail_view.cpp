@@ -0,0 +1,82 @@
+/*******************************************************************************
+ * @file test_tail_view.cpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include <catch2/catch_test_macros.hpp>
+#include <eltau/tail_view.hpp>
+
+#include "screen_utils.hpp"
+
+namespace et = eltau;
+
+TEST_CASE("TailView shows the last lines") {
+    et::TailView tail{4, 64};
+    et::Screen screen{{3, 5}};
+    et::DrawingWindow window{et::Window{{0, 0}, {3, 5}}, screen};
+
+    SECTION("Fewer lines than rows") {
+        tail.append("a\tb");
+        REQUIRE(tail.calc_pref_size({3, 5}) == et::Vec2{1, 5});
+        tail.draw(window);
+        REQUIRE(to_string(screen.line(0)) == "a b  ");
+        REQUIRE(to_string(screen.line(1)) == "     ");
+    }
+    SECTION("Ring wraps around") {
+        for (int i = 0; i < 10; ++i)
+            tail.append("line" + std::to_string(i));
+        REQUIRE(tail.appended() == 10);
+        REQUIRE(tail.calc_pref_size({10, 5}) == et::Vec2{4, 5});
+        tail.draw(window);
+        REQUIRE(to_string(screen.line(0)) == "line7");
+        REQUIRE(to_string(screen.line(2)) == "line9");
+    }
+    SECTION("Lines evicted from the arena are empty") {
+        et::TailView small{4, 8};
+        small.append("aaaa");
+        small.append("bbb");
+        small.append("cc");
+        small.draw(window);
+        REQUIRE(to_string(screen.line(0)) == "     ");
+        REQUIRE(to_string(screen.line(1)) == "bbb  ");
+        REQUIRE(to_string(screen.line(2)) == "cc   ");
+    }
+    SECTION("Too long line is cut off") {
+        et::TailView small{4, 3};
+        small.append("abcdef");
+        small.draw(window);
+        REQUIRE(to_string(screen.line(0)) == "abc  ");
+    }
+}
+
+TEST_CASE("TailView concurrent producer") {
+    et::TailView tail{64, 512};
+    et::Screen screen{{8, 12}};
+    et::DrawingWindow window{et::Window{{0, 0}, {8, 12}}, screen};
+
+    std::atomic<bool> done{false};
+    std::jthread producer{[&] {
+        for (std::size_t i = 0; i < 20'000; ++i)
+            tail.append("line " + std::to_string(i));
+        done = true;
+    }};
+
+    // Every drawn line is either intact or discarded.
+    while (!done) {
+        tail.draw(window);
+        for (std::size_t r = 0; r < 8; ++r) {
+            const auto line = to_string(screen.line(r));
+            if (line.find_first_not_of(' ') == std::string::npos)
+                continue;
+            REQUIRE(line.starts_with("line "));
+            REQUIRE(line.find_first_not_of("0123456789 ", 5) == std::string::npos);
+        }
+    }
+    tail.draw(window);
+    REQUIRE(to_string(screen.line(7)) == "line 19999  ");
+}
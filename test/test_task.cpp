@@ -0,0 +1,195 @@
+/*******************************************************************************
+ * @file test_task.cpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <eltau/shared_state.hpp>
+#include <eltau/task.hpp>
+
+namespace et = eltau;
+using namespace std::chrono_literals;
+
+namespace {
+et::Task
+sleeper(et::Scheduler& sched, std::chrono::milliseconds delay, std::vector<int>& log, int id) {
+    log.push_back(-id);
+    co_await sched.sleep_for(delay);
+    log.push_back(id);
+}
+
+et::Task
+animation(et::Scheduler& sched, int frames, int& counter) {
+    for (int i = 0; i < frames; ++i) {
+        co_await sched.next_frame();
+        ++counter;
+    }
+}
+
+et::Task
+reader(et::Scheduler& sched, std::string& typed) {
+    while (true) {
+        const auto event = co_await sched.next_input();
+        if (event.m_key == et::Key::Enter)
+            co_return;
+        typed += static_cast<char>(event.m_char);
+    }
+}
+
+et::Task
+observer(et::Scheduler& sched, et::SharedState<int>& state, std::vector<int>& seen) {
+    while (true) {
+        co_await sched.changed(state);
+        seen.push_back(state.get());
+    }
+}
+
+et::Task
+thrower(et::Scheduler& sched) {
+    co_await sched.sleep_for(1ms);
+    throw std::runtime_error{"task failed"};
+}
+
+/*! Sets the flag when destroyed. */
+struct Guard {
+    explicit Guard(bool* flag) : m_flag(flag) {}
+    Guard(const Guard& other) = delete;
+    Guard(Guard&& other) noexcept = delete;
+    Guard&
+    operator=(const Guard& other) = delete;
+    Guard&
+    operator=(Guard&& other) noexcept = delete;
+    ~Guard() noexcept { *m_flag = true; }
+    bool* m_flag;
+};
+
+et::Task
+forever(et::Scheduler& sched, bool& destroyed) {
+    const Guard guard{&destroyed};
+    co_await sched.next_input();
+}
+
+/*******************************************************************************
+ * @brief Poll @p loop until @p sched has no tasks.
+ ******************************************************************************/
+void
+run_all(et::EventLoop& loop, et::Scheduler& sched) {
+    while (sched.task_count() > 0)
+        (void)loop.poll(-1ms);
+}
+} // namespace
+
+TEST_CASE("Tasks sleep") {
+    et::EventLoop loop{-1};
+    et::Scheduler sched{loop};
+    std::vector<int> log;
+
+    sched.spawn(sleeper(sched, 20ms, log, 2));
+    sched.spawn(sleeper(sched, 1ms, log, 1));
+    sched.spawn(sleeper(sched, 0ms, log, 3));
+    // Run until the first suspension, past deadlines do not suspend.
+    REQUIRE(log == std::vector{-2, -1, -3, 3});
+    REQUIRE(sched.task_count() == 2);
+
+    run_all(loop, sched);
+    REQUIRE(log == std::vector{-2, -1, -3, 3, 1, 2});
+}
+
+TEST_CASE("Tasks await frames") {
+    et::EventLoop loop{-1};
+    et::Scheduler sched{loop, 5ms};
+    int renders = 0;
+    loop.on_render([&] { ++renders; });
+
+    int first = 0;
+    int second = 0;
+    sched.spawn(animation(sched, 3, first));
+    sched.spawn(animation(sched, 3, second));
+
+    const auto start = et::Scheduler::Clock::now();
+    run_all(loop, sched);
+    REQUIRE(first == 3);
+    REQUIRE(second == 3);
+    // Both tasks share the frames, each followed by one redraw.
+    REQUIRE(renders == 3);
+    REQUIRE(et::Scheduler::Clock::now() - start >= 10ms);
+}
+
+TEST_CASE("Tasks await input") {
+    et::EventLoop loop{-1};
+    et::Scheduler sched{loop};
+    std::string typed;
+    sched.spawn(reader(sched, typed));
+
+    et::InputDecoder decoder;
+    (void)decoder.feed("ab\rc");
+    while (const auto event = decoder.pop())
+        sched.dispatch(*event);
+    REQUIRE(typed == "ab");
+    REQUIRE(sched.task_count() == 0);
+}
+
+TEST_CASE("Tasks await state changes") {
+    et::EventLoop loop{-1};
+    et::Scheduler sched{loop};
+    et::SharedState<int> state{0};
+    std::vector<int> seen;
+    sched.spawn(observer(sched, state, seen));
+
+    state.set(1);
+    state.update([](int& value) { value += 1; });
+    REQUIRE(state.version() == 2);
+    REQUIRE(seen.empty());
+
+    // Both changes are observed at once.
+    (void)loop.poll(-1ms);
+    REQUIRE(seen == std::vector{2});
+
+    state.set(3);
+    (void)loop.poll(-1ms);
+    REQUIRE(seen == std::vector{2, 3});
+}
+
+TEST_CASE("Task failures") {
+    et::EventLoop loop{-1};
+    et::Scheduler sched{loop};
+    sched.spawn(thrower(sched));
+    REQUIRE_THROWS_AS(run_all(loop, sched), std::runtime_error);
+    REQUIRE(sched.task_count() == 0);
+}
+
+TEST_CASE("Suspended tasks are destroyed with the scheduler") {
+    et::EventLoop loop{-1};
+    bool destroyed = false;
+    et::SharedState<int> state{0};
+    std::vector<int> seen;
+    {
+        et::Scheduler sched{loop};
+        sched.spawn(forever(sched, destroyed));
+        sched.spawn(observer(sched, state, seen));
+        REQUIRE(sched.task_count() == 2);
+    }
+    REQUIRE(destroyed);
+    // Nobody waits anymore.
+    state.set(1);
+    REQUIRE(seen.empty());
+}
+
+TEST_CASE("Thousands of tasks") {
+    et::EventLoop loop{-1};
+    et::Scheduler sched{loop, 1ms};
+    std::vector<int> counters(1000, 0);
+    for (auto& counter : counters)
+        sched.spawn(animation(sched, 2, counter));
+    REQUIRE(sched.task_count() == counters.size());
+
+    run_all(loop, sched);
+    for (const auto counter : counters)
+        REQUIRE(counter == 2);
+}
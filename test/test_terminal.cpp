@@ -0,0 +1,137 @@
+/*******************************************************************************
+ * @file test_terminal.cpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+
+#include <array>
+#include <chrono>
+#include <csignal>
+#include <memory>
+#include <string>
+
+#include <catch2/catch_test_macros.hpp>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <eltau/event_loop.hpp>
+#include <eltau/exception.hpp>
+#include <eltau/terminal.hpp>
+#include <eltau/text.hpp>
+
+namespace et = eltau;
+using namespace std::chrono_literals;
+
+namespace {
+/*******************************************************************************
+ * @brief Pipe capturing the output of a terminal.
+ ******************************************************************************/
+struct Capture {
+    Capture() {
+        REQUIRE(pipe(m_fds.data()) == 0);
+        REQUIRE(fcntl(m_fds[0], F_SETFL, O_NONBLOCK) == 0);
+    }
+    Capture(const Capture& other) = delete;
+    Capture(Capture&& other) noexcept = delete;
+    Capture&
+    operator=(const Capture& other) = delete;
+    Capture&
+    operator=(Capture&& other) noexcept = delete;
+    ~Capture() noexcept {
+        for (auto fd : m_fds)
+            (void)close(fd);
+    }
+
+    /*******************************************************************************
+     * @brief Output written since the last call.
+     ******************************************************************************/
+    std::string
+    take() const {
+        std::string out;
+        std::array<char, 1024> buffer{};
+        ssize_t len = 0;
+        while ((len = read(m_fds[0], buffer.data(), buffer.size())) > 0)
+            out.append(buffer.data(), static_cast<std::size_t>(len));
+        return out;
+    }
+
+    int
+    fd() const noexcept {
+        return m_fds[1];
+    }
+
+    std::array<int, 2> m_fds{-1, -1};
+};
+} // namespace
+
+TEST_CASE("EagerTerminal writes to its descriptor") {
+    Capture capture;
+    {
+        et::EagerTerminal term{std::make_unique<et::ascii::Text>("ab"), -1, capture.fd(), et::Vec2{2, 3}};
+        REQUIRE(capture.take() == "\033[?1049h");
+
+        term.draw();
+        REQUIRE(capture.take() == "\033[1;1Hab \033[2;1H   ");
+        REQUIRE_FALSE(term.output_pending());
+        // Nothing changed.
+        term.draw();
+        REQUIRE(capture.take().empty());
+    }
+    REQUIRE(capture.take() == "\033[?1049l");
+}
+
+TEST_CASE("EagerTerminal keeps its size if it cannot be queried") {
+    Capture capture;
+    et::EventLoop loop{-1};
+    et::EagerTerminal term{std::make_unique<et::ascii::Text>("ab"), -1, capture.fd(), et::Vec2{2, 3}};
+    term.attach(loop);
+
+    // The size of a pipe cannot be queried.
+    REQUIRE(raise(SIGWINCH) == 0);
+    const auto until = std::chrono::steady_clock::now() + 2 * et::EagerTerminal::c_resize_debounce;
+    while (std::chrono::steady_clock::now() < until)
+        REQUIRE_NOTHROW(loop.poll(10ms));
+    REQUIRE(term.compositor().screen().size() == et::Vec2{2, 3});
+}
+
+TEST_CASE("InlineTerminal draws at the cursor") {
+    Capture capture;
+    auto text = std::make_unique<et::ascii::Text>("ab\ncd");
+    auto& shown = *text;
+    {
+        et::InlineTerminal term{std::move(text), 3, capture.fd(), 4};
+        // Reserves the rows, the cursor returns to the top.
+        REQUIRE(capture.take() == "\r\n\n\033[2A");
+
+        term.draw();
+        REQUIRE(capture.take() == "\rab  \033[1B\rcd  \033[1B\r    \033[2A\r");
+
+        SECTION("Only the changes are written with relative moves") {
+            shown.replace(4, 1, "x");
+            term.compositor().invalidate(term.root_layer());
+            term.draw();
+            const auto out = capture.take();
+            REQUIRE(out.find("cx") != std::string::npos);
+            REQUIRE(out.find('H') == std::string::npos);
+            REQUIRE(out.back() == '\r');
+        }
+        SECTION("Logged lines are inserted above the region") {
+            term.log("done\n");
+            REQUIRE(capture.take() == "\033[2B\n\033[3A\033[1L" "done\r\n");
+
+            term.log("wrapped\nx\ty");
+            REQUIRE(capture.take() == "\033[2B\n\n\n\033[5A\033[3L" "wrap\r\nped\r\nxy\r\n");
+            // The region is not repainted.
+            term.draw();
+            REQUIRE(capture.take().empty());
+        }
+    }
+    // The cursor ends below the region.
+    REQUIRE(capture.take() == "\033[2B\r\n");
+}
+
+TEST_CASE("InlineTerminal needs a row") {
+    Capture capture;
+    REQUIRE_THROWS_AS(et::InlineTerminal(std::make_unique<et::ascii::Text>("a"), 0, capture.fd(), 4),
+                      et::EltauException);
+}
@@ -4,9 +4,15 @@
  * @license	This file is released under ElTau project's license, see LICENSE.
  ******************************************************************************/
 
+#include <memory>
+#include <string>
+
 #include <catch2/catch_test_macros.hpp>
+#include <eltau/exception.hpp>
 #include <eltau/text.hpp>
 
+#include "screen_utils.hpp"
+
 namespace et = eltau;
 
 using Text = et::ascii::Text;
@@ -126,3 +132,187 @@ SCENARIO("Text size calculation") {
         }
     }
 }
+
+SCENARIO("Text drawing") {
+    GIVEN("Wrapped multiline text") {
+        Text text{"Hello world\nab", 4};
+        et::Screen screen{{6, 6}};
+
+        WHEN("Drawn to the preferred size") {
+            const auto size = text.calc_pref_size(screen.size());
+            et::DrawingWindow win{et::Window{{1, 1}, size}, screen};
+            text.draw(win);
+
+            THEN("Lines are wrapped and padded") {
+                REQUIRE(size == et::Vec2{.m_row = 4, .m_col = 4});
+                REQUIRE(to_string(screen.line(1)).substr(1, 4) == "Hell");
+                REQUIRE(to_string(screen.line(2)).substr(1, 4) == "o wo");
+                REQUIRE(to_string(screen.line(3)).substr(1, 4) == "rld ");
+                REQUIRE(to_string(screen.line(4)).substr(1, 4) == "ab  ");
+            }
+            THEN("Nothing outside the window is touched") {
+                REQUIRE(to_string(screen.line(0)) == "++++++");
+                REQUIRE(to_string(screen.line(5)) == "++++++");
+                for (std::size_t r = 1; r < 5; ++r) {
+                    REQUIRE(screen.line(r)[0].m_char[0] == '+');
+                    REQUIRE(screen.line(r)[5].m_char[0] == '+');
+                }
+            }
+        }
+        WHEN("Drawn to a smaller window") {
+            et::DrawingWindow win{et::Window{{0, 0}, {2, 3}}, screen};
+            text.draw(win);
+
+            THEN("The rest is cut off") {
+                REQUIRE(to_string(screen.line(0)) == "Hel+++");
+                REQUIRE(to_string(screen.line(1)) == "lo +++");
+                REQUIRE(to_string(screen.line(2)) == "++++++");
+            }
+        }
+    }
+    GIVEN("Non-printable ASCIIs") {
+        Text text{"a\x02z"};
+        et::Screen screen{{1, 3}};
+        et::DrawingWindow win{et::Window{{0, 0}, screen.size()}, screen};
+        text.draw(win);
+
+        THEN("They are escaped") { REQUIRE(to_string(screen.line(0)) == "a z"); }
+    }
+}
+
+SCENARIO("Text construction without copies") {
+    GIVEN("Shared text") {
+        auto str = std::make_shared<const std::string>("Hello\nworld");
+        Text text{str};
+
+        THEN("The text is shared, not copied") { REQUIRE(str.use_count() == 2); }
+        THEN("Size is calculated from the shared text") { REQUIRE(text.calc_pref_size({10, 10}) == et::Vec2{2, 5}); }
+        WHEN("The text outlives other owners") {
+            str.reset();
+            et::Screen screen{{1, 5}};
+            et::DrawingWindow win{et::Window{{0, 0}, screen.size()}, screen};
+            text.draw(win);
+            THEN("It is still valid") { REQUIRE(to_string(screen.line(0)) == "Hello"); }
+        }
+    }
+    GIVEN("Null shared text") {
+        Text text{std::shared_ptr<const std::string>{}};
+        THEN("It is empty") { REQUIRE(text.calc_pref_size({10, 10}) == et::Vec2{0, 0}); }
+    }
+    GIVEN("Borrowed text") {
+        std::string buffer{"ab\x01"};
+        Text text{et::c_borrow, buffer};
+
+        WHEN("The buffer is changed in-place") {
+            buffer[0] = 'x';
+            et::Screen screen{{1, 3}};
+            et::DrawingWindow win{et::Window{{0, 0}, screen.size()}, screen};
+            text.draw(win);
+            THEN("Drawing reflects the change and escapes lazily") { REQUIRE(to_string(screen.line(0)) == "xb "); }
+            THEN("The buffer itself is not escaped") { REQUIRE(buffer[2] == '\x01'); }
+        }
+    }
+}
+
+SCENARIO("UTF-8 Text") {
+    using Utf8Text = et::utf8::Text;
+
+    GIVEN("Mixed-width text") {
+        Utf8Text text{"a\u4E00b\ne\u0301\u2764\uFE0F"};
+        et::Screen screen{{2, 5}};
+
+        WHEN("Size is calculated") {
+            THEN("Display widths are used") { REQUIRE(text.calc_pref_size({10, 10}) == et::Vec2{2, 4}); }
+            THEN("Wrapping keeps clusters whole") { REQUIRE(text.calc_pref_size({10, 2}) == et::Vec2{5, 2}); }
+        }
+        WHEN("Drawn") {
+            et::DrawingWindow win{et::Window{{0, 0}, screen.size()}, screen};
+            text.draw(win);
+            THEN("Wide clusters take two cells") {
+                const auto l = screen.line(0);
+                REQUIRE(std::string{l[0].m_char.data()} == "a");
+                REQUIRE(std::string{l[1].m_char.data()} == "\u4E00");
+                REQUIRE(l[2].m_char[0] == 0);
+                REQUIRE(std::string{l[3].m_char.data()} == "b");
+                REQUIRE(std::string{l[4].m_char.data()} == " ");
+            }
+            THEN("Combining sequences share a cell") {
+                REQUIRE(to_string(screen.line(1)) == "e\u0301\u2764\uFE0F  ");
+                REQUIRE(screen.line(1)[2].m_char[0] == 0);
+            }
+        }
+    }
+    GIVEN("Text with a wide character at the edge") {
+        Utf8Text text{"ab\u4E00"};
+        et::Screen screen{{1, 3}};
+        et::DrawingWindow win{et::Window{{0, 0}, screen.size()}, screen};
+        text.draw(win);
+        THEN("It is replaced by a space") { REQUIRE(to_string(screen.line(0)) == "ab "); }
+    }
+    GIVEN("Invalid and control characters") {
+        Utf8Text text{"\xFF\x01x"};
+        et::Screen screen{{1, 3}};
+        et::DrawingWindow win{et::Window{{0, 0}, screen.size()}, screen};
+        text.draw(win);
+        THEN("They are replaced and escaped") { REQUIRE(to_string(screen.line(0)) == "\uFFFD x"); }
+    }
+    GIVEN("Long ASCII text") {
+        const std::string str(100, 'x');
+        Utf8Text text{et::c_borrow, str, 30};
+        THEN("It is wrapped like ascii::Text") {
+            Text ascii{et::c_borrow, str, 30};
+            REQUIRE(text.calc_pref_size({10, 50}) == ascii.calc_pref_size({10, 50}));
+        }
+    }
+}
+
+SCENARIO("Text editing") {
+    GIVEN("A log text") {
+        Text text{"first\nsecond", 8};
+        REQUIRE(text.calc_pref_size({10, 10}) == et::Vec2{2, 6});
+
+        WHEN("Lines are appended") {
+            text.append("\nthird line");
+            THEN("Size is updated") { REQUIRE(text.calc_pref_size({10, 10}) == et::Vec2{4, 8}); }
+        }
+        WHEN("A part is replaced") {
+            text.replace(0, 6, "");
+            et::Screen screen{{1, 6}};
+            et::DrawingWindow win{et::Window{{0, 0}, screen.size()}, screen};
+            text.draw(win);
+            THEN("Size and content are updated") {
+                REQUIRE(text.calc_pref_size({10, 10}) == et::Vec2{1, 6});
+                REQUIRE(to_string(screen.line(0)) == "second");
+            }
+        }
+        WHEN("Replaced range is out of range") {
+            THEN("It throws") { REQUIRE_THROWS_AS(text.replace(13, 0, "x"), et::EltauException); }
+            THEN("Count is clamped") {
+                text.replace(6, 100, "2nd");
+                REQUIRE(text.calc_pref_size({10, 10}) == et::Vec2{2, 5});
+            }
+        }
+    }
+    GIVEN("Shared text") {
+        auto str = std::make_shared<const std::string>("abc");
+        Text text{str};
+        WHEN("Edited") {
+            text.append("def");
+            THEN("The shared text is not modified") {
+                REQUIRE(*str == "abc");
+                REQUIRE(text.calc_pref_size({10, 10}) == et::Vec2{1, 6});
+            }
+        }
+    }
+    GIVEN("Copied text") {
+        Text text{"abc"};
+        Text copy{text};
+        WHEN("The copy is edited") {
+            copy.append("d");
+            THEN("The original is not modified") {
+                REQUIRE(text.calc_pref_size({10, 10}) == et::Vec2{1, 3});
+                REQUIRE(copy.calc_pref_size({10, 10}) == et::Vec2{1, 4});
+            }
+        }
+    }
+}
@@ -0,0 +1,150 @@
+/*******************************************************************************
+ * @file test_timer_wheel.cpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+
+#include <memory>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <eltau/timer_wheel.hpp>
+
+namespace et = eltau;
+using namespace std::chrono_literals;
+
+namespace {
+/*! Arbitrary fake start of the wheels. */
+const et::TimerWheel::Clock::time_point c_start{1h};
+
+/*******************************************************************************
+ * @brief Advance @p wheel to @p now, return the expired entries in order.
+ ******************************************************************************/
+std::vector<et::TimerWheel::Entry*>
+advance(et::TimerWheel& wheel, et::TimerWheel::Clock::time_point now) {
+    std::vector<et::TimerWheel::Entry*> expired;
+    wheel.advance(now, [&](et::TimerWheel::Entry& entry) { expired.push_back(&entry); });
+    return expired;
+}
+} // namespace
+
+TEST_CASE("TimerWheel rounds deadlines up to ticks") {
+    et::TimerWheel wheel{10ms, c_start};
+    REQUIRE(wheel.tick() == 10ms);
+    REQUIRE_FALSE(wheel.next_deadline());
+
+    et::TimerWheel::Entry first;
+    et::TimerWheel::Entry second;
+    et::TimerWheel::Entry third;
+    wheel.schedule(first, c_start + 11ms);
+    wheel.schedule(second, c_start + 20ms);
+    wheel.schedule(third, c_start + 21ms);
+    REQUIRE(wheel.size() == 3);
+    REQUIRE(first.pending());
+    REQUIRE(wheel.next_deadline() == c_start + 20ms);
+
+    // Never early.
+    REQUIRE(advance(wheel, c_start + 19ms).empty());
+    // Timers within one tick expire together.
+    REQUIRE(advance(wheel, c_start + 20ms) == std::vector{&first, &second});
+    REQUIRE_FALSE(first.pending());
+    REQUIRE(wheel.size() == 1);
+    REQUIRE(wheel.next_deadline() == c_start + 30ms);
+
+    REQUIRE(advance(wheel, c_start + 35ms) == std::vector{&third});
+    REQUIRE(wheel.size() == 0);
+    REQUIRE_FALSE(wheel.next_deadline());
+}
+
+TEST_CASE("TimerWheel expires past deadlines at the next tick") {
+    et::TimerWheel wheel{10ms, c_start};
+    REQUIRE(advance(wheel, c_start + 100ms).empty());
+
+    et::TimerWheel::Entry entry;
+    wheel.schedule(entry, c_start);
+    REQUIRE(wheel.next_deadline() == c_start + 110ms);
+    REQUIRE(advance(wheel, c_start + 105ms).empty());
+    REQUIRE(advance(wheel, c_start + 110ms) == std::vector{&entry});
+}
+
+TEST_CASE("TimerWheel cancels and reschedules") {
+    et::TimerWheel wheel{1ms, c_start};
+    et::TimerWheel::Entry kept;
+    et::TimerWheel::Entry cancelled;
+    wheel.schedule(kept, c_start + 5ms);
+    wheel.schedule(cancelled, c_start + 5ms);
+
+    cancelled.cancel();
+    REQUIRE_FALSE(cancelled.pending());
+    REQUIRE(wheel.size() == 1);
+    // No-op.
+    cancelled.cancel();
+
+    wheel.schedule(kept, c_start + 8ms);
+    REQUIRE(wheel.size() == 1);
+    REQUIRE(advance(wheel, c_start + 7ms).empty());
+    REQUIRE(advance(wheel, c_start + 8ms) == std::vector{&kept});
+
+    SECTION("Expired entries can be scheduled again") {
+        wheel.schedule(kept, c_start + 9ms);
+        REQUIRE(advance(wheel, c_start + 9ms) == std::vector{&kept});
+    }
+    SECTION("Rescheduling from the handler") {
+        wheel.schedule(kept, c_start + 9ms);
+        int count = 0;
+        wheel.advance(c_start + 20ms, [&](et::TimerWheel::Entry& entry) {
+            if (++count < 3)
+                wheel.schedule(entry, c_start + 21ms);
+        });
+        REQUIRE(count == 1);
+        REQUIRE(advance(wheel, c_start + 21ms) == std::vector{&kept});
+    }
+}
+
+TEST_CASE("TimerWheel cascades distant timers") {
+    et::TimerWheel wheel{1ms, c_start};
+    std::vector<std::unique_ptr<et::TimerWheel::Entry>> entries;
+    // One per level and beyond the span of all levels.
+    const std::vector<std::chrono::milliseconds> delays{3ms, 100ms, 5000ms, 300000ms, 20000000ms};
+    for (const auto delay : delays) {
+        entries.push_back(std::make_unique<et::TimerWheel::Entry>());
+        wheel.schedule(*entries.back(), c_start + delay);
+    }
+    REQUIRE(wheel.size() == delays.size());
+
+    for (std::size_t i = 0; i < delays.size(); ++i) {
+        INFO(i);
+        REQUIRE(advance(wheel, c_start + delays[i] - 1ms).empty());
+        REQUIRE(advance(wheel, c_start + delays[i]) == std::vector{entries[i].get()});
+        REQUIRE(wheel.size() == delays.size() - i - 1);
+    }
+}
+
+TEST_CASE("TimerWheel jumps over idle time") {
+    et::TimerWheel wheel{1ms, c_start};
+    // Would take forever tick by tick.
+    REQUIRE(advance(wheel, c_start + 1000h).empty());
+
+    et::TimerWheel::Entry entry;
+    wheel.schedule(entry, c_start + 1000h + 2ms);
+    REQUIRE(wheel.next_deadline() <= c_start + 1000h + 2ms);
+    REQUIRE(advance(wheel, c_start + 1000h + 2ms) == std::vector{&entry});
+}
+
+TEST_CASE("TimerWheel entries unschedule themselves") {
+    auto wheel = std::make_unique<et::TimerWheel>(1ms, c_start);
+    et::TimerWheel::Entry outliving;
+    {
+        et::TimerWheel::Entry entry;
+        wheel->schedule(entry, c_start + 3ms);
+        wheel->schedule(outliving, c_start + 3ms);
+        REQUIRE(wheel->size() == 2);
+    }
+    REQUIRE(wheel->size() == 1);
+    REQUIRE(advance(*wheel, c_start + 3ms) == std::vector{&outliving});
+
+    wheel->schedule(outliving, c_start + 5ms);
+    wheel.reset();
+    REQUIRE_FALSE(outliving.pending());
+}
@@ -0,0 +1,142 @@
+/*******************************************************************************
+ * @file test_utf8.cpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <eltau/utf8.hpp>
+
+namespace utf8 = eltau::utf8;
+
+using namespace std::string_view_literals;
+
+TEST_CASE("UTF-8 decoding") {
+    SECTION("Valid sequences") {
+        constexpr auto str{"aé一\U0001F600"sv};
+        std::size_t pos = 0;
+        REQUIRE(utf8::decode(str, pos) == U'a');
+        REQUIRE(pos == 1);
+        REQUIRE(utf8::decode(str, pos) == U'é');
+        REQUIRE(pos == 3);
+        REQUIRE(utf8::decode(str, pos) == U'一');
+        REQUIRE(pos == 6);
+        REQUIRE(utf8::decode(str, pos) == U'\U0001F600');
+        REQUIRE(pos == 10);
+    }
+    SECTION("Invalid sequences advance by one byte") {
+        for (auto str : {"\x80"sv, "\xC3"sv, "\xC3("sv, "\xC0\xAF"sv, "\xED\xA0\x80"sv, "\xF4\x90\x80\x80"sv}) {
+            std::size_t pos = 0;
+            REQUIRE(utf8::decode(str, pos) == utf8::c_replacement);
+            REQUIRE(pos == 1);
+        }
+    }
+}
+
+TEST_CASE("UTF-8 code point properties") {
+    REQUIRE(utf8::width(U'a') == 1);
+    REQUIRE(utf8::width(U'é') == 1);
+    REQUIRE(utf8::width(U'一') == 2);
+    REQUIRE(utf8::width(U'Ａ') == 2);
+    REQUIRE(utf8::width(U'\U0001F600') == 2);
+    REQUIRE(utf8::width(U'\u0301') == 0);
+    REQUIRE(utf8::width(U'\u200D') == 0);
+    REQUIRE(utf8::width(0x110000) == 1);
+    // Unassigned, wide only in the CJK planes.
+    REQUIRE(utf8::width(0x378) == 1);
+    REQUIRE(utf8::width(0x1FFFE) == 1);
+    REQUIRE(utf8::width(0xE0000) == 1);
+    REQUIRE(utf8::width(0x2FFFD) == 2);
+
+    REQUIRE(utf8::grapheme_class(U'a') == utf8::GraphemeClass::Other);
+    REQUIRE(utf8::grapheme_class(U'\n') == utf8::GraphemeClass::Control);
+    REQUIRE(utf8::grapheme_class(U'\u0301') == utf8::GraphemeClass::Extend);
+    REQUIRE(utf8::grapheme_class(U'\u200D') == utf8::GraphemeClass::Zwj);
+    REQUIRE(utf8::grapheme_class(U'\U0001F1E8') == utf8::GraphemeClass::RegionalIndicator);
+    REQUIRE(utf8::grapheme_class(U'❤') == utf8::GraphemeClass::ExtPict);
+}
+
+TEST_CASE("ASCII prefix") {
+    REQUIRE(utf8::ascii_prefix(""sv) == 0);
+    REQUIRE(utf8::is_ascii(""sv));
+
+    std::string str(100, 'a');
+    REQUIRE(utf8::ascii_prefix(str) == str.size());
+    REQUIRE(utf8::is_ascii(str));
+    for (std::size_t i : {0, 7, 8, 15, 16, 17, 63, 99}) {
+        auto s = str;
+        s[i] = '\xC3';
+        REQUIRE(utf8::ascii_prefix(s) == i);
+        REQUIRE(!utf8::is_ascii(s));
+    }
+}
+
+TEST_CASE("Grapheme segmentation") {
+    auto graphemes = [](std::string_view str) {
+        std::vector<utf8::Grapheme> res;
+        for (std::size_t pos = 0; pos < str.size(); pos += res.back().m_length)
+            res.push_back(utf8::next_grapheme(str, pos));
+        return res;
+    };
+
+    SECTION("ASCII") {
+        auto gs = graphemes("ab"sv);
+        REQUIRE(gs.size() == 2);
+        REQUIRE(gs[1] == utf8::Grapheme{.m_begin = 1, .m_length = 1, .m_width = 1});
+    }
+    SECTION("Combining marks are joined") {
+        auto gs = graphemes("e\u0301x"sv);
+        REQUIRE(gs.size() == 2);
+        REQUIRE(gs[0] == utf8::Grapheme{.m_begin = 0, .m_length = 3, .m_width = 1});
+    }
+    SECTION("Wide characters") {
+        auto gs = graphemes("一二"sv);
+        REQUIRE(gs.size() == 2);
+        REQUIRE(gs[0].m_width == 2);
+        REQUIRE(gs[1].m_width == 2);
+    }
+    SECTION("Emoji ZWJ sequence") {
+        // Woman, ZWJ, laptop.
+        auto gs = graphemes("\U0001F469\u200D\U0001F4BBa"sv);
+        REQUIRE(gs.size() == 2);
+        REQUIRE(gs[0].m_length == 11);
+        REQUIRE(gs[0].m_width == 2);
+    }
+    SECTION("Emoji presentation selector") {
+        auto gs = graphemes("❤\uFE0F"sv);
+        REQUIRE(gs.size() == 1);
+        REQUIRE(gs[0].m_width == 2);
+    }
+    SECTION("Regional indicators pair up") {
+        auto gs = graphemes("\U0001F1E8\U0001F1FF\U0001F1E8"sv);
+        REQUIRE(gs.size() == 2);
+        REQUIRE(gs[0].m_length == 8);
+        REQUIRE(gs[0].m_width == 2);
+        REQUIRE(gs[1].m_width == 1);
+    }
+    SECTION("Controls are separate") {
+        auto gs = graphemes("\r\n\t\u0301"sv);
+        REQUIRE(gs.size() == 3);
+        REQUIRE(gs[0] == utf8::Grapheme{.m_begin = 0, .m_length = 2, .m_width = 1, .m_control = true});
+        REQUIRE(gs[1].m_control);
+        REQUIRE(gs[2].m_width == 1);
+    }
+    SECTION("Invalid sequences") {
+        auto gs = graphemes("\xFF"
+                            "a"sv);
+        REQUIRE(gs.size() == 2);
+        REQUIRE(gs[0].m_replaced);
+        REQUIRE(!gs[1].m_replaced);
+    }
+}
+
+TEST_CASE("String width") {
+    REQUIRE(utf8::str_width(""sv) == 0);
+    REQUIRE(utf8::str_width("Hello"sv) == 5);
+    REQUIRE(utf8::str_width("e\u0301"sv) == 1);
+    REQUIRE(utf8::str_width("ab一c"sv) == 5);
+    REQUIRE(utf8::str_width("0123456789abcdefghij\u0301"sv) == 20);
+}
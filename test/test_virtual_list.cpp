@@ -0,0 +1,151 @@
+/*******************************************************************************
+ * @file test_virtual_list.cpp
+ * @copyright Copyright 2022 Jan Waltl.
+ * @license	This file is released under ElTau project's license, see LICENSE.
+ ******************************************************************************/
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <eltau/exception.hpp>
+#include <eltau/text.hpp>
+#include <eltau/virtual_list.hpp>
+
+#include "screen_utils.hpp"
+
+namespace et = eltau;
+
+TEST_CASE("PrefixSums") {
+    const std::vector<std::size_t> values{3, 0, 1, 4, 1, 5, 9, 2, 6};
+    et::PrefixSums sums;
+    sums.assign(values.size(), [&](std::size_t i) { return values[i]; });
+
+    REQUIRE(sums.size() == values.size());
+    std::size_t expected = 0;
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        REQUIRE(sums.prefix(i) == expected);
+        REQUIRE(sums.at(i) == values[i]);
+        expected += values[i];
+    }
+    REQUIRE(sums.total() == expected);
+
+    SECTION("Find") {
+        REQUIRE(sums.find(0) == 0);
+        REQUIRE(sums.find(2) == 0);
+        // Zero-sized values are skipped.
+        REQUIRE(sums.find(3) == 2);
+        REQUIRE(sums.find(4) == 3);
+        REQUIRE(sums.find(expected - 1) == values.size() - 1);
+        REQUIRE(sums.find(expected) == values.size());
+    }
+    SECTION("Set") {
+        sums.set(1, 2);
+        REQUIRE(sums.at(1) == 2);
+        REQUIRE(sums.prefix(2) == 5);
+        REQUIRE(sums.total() == expected + 2);
+        REQUIRE(sums.find(4) == 1);
+    }
+    SECTION("Empty") {
+        sums.assign(0, [](std::size_t) { return 1; });
+        REQUIRE(sums.total() == 0);
+        REQUIRE(sums.find(0) == 0);
+    }
+}
+
+TEST_CASE("VirtualList creates only visible rows") {
+    constexpr std::size_t c_rows = 1'000'000;
+    std::size_t created = 0;
+    et::VirtualList list{c_rows, [&](std::size_t row) {
+                             ++created;
+                             return std::make_unique<et::ascii::Text>(std::to_string(row));
+                         }};
+
+    et::Screen screen{{3, 7}};
+    et::DrawingWindow window{et::Window{{0, 0}, {3, 7}}, screen};
+
+    REQUIRE(list.calc_pref_size({3, 7}) == et::Vec2{3, 7});
+    list.scroll_to_row(500'000);
+    list.draw(window);
+    REQUIRE(created == 3);
+    REQUIRE(list.live_rows() == 3);
+    REQUIRE(to_string(screen.line(0)) == "500000 ");
+    REQUIRE(to_string(screen.line(2)) == "500002 ");
+
+    SECTION("Visible rows are reused") {
+        list.scroll_to(500'001);
+        list.draw(window);
+        REQUIRE(created == 4);
+        REQUIRE(to_string(screen.line(0)) == "500001 ");
+        list.refresh();
+        list.draw(window);
+        REQUIRE(created == 7);
+    }
+    SECTION("Scrolling past the end shows the last rows") {
+        list.scroll_to(c_rows + 10);
+        list.draw(window);
+        REQUIRE(to_string(screen.line(2)) == "999999 ");
+    }
+    SECTION("Rows below the screen are not created") {
+        et::Screen small{{2, 7}};
+        et::DrawingWindow clipped{et::Window{{0, 0}, {3, 7}}, small};
+        list.refresh();
+        list.draw(clipped);
+        REQUIRE(list.live_rows() == 2);
+        REQUIRE(to_string(small.line(1)) == "500001 ");
+    }
+    SECTION("Short list is padded") {
+        list.set_count(1);
+        list.draw(window);
+        REQUIRE(list.live_rows() == 1);
+        REQUIRE(to_string(screen.line(0)) == "0      ");
+        REQUIRE(to_string(screen.line(1)) == "       ");
+    }
+}
+
+TEST_CASE("VirtualList with variable heights") {
+    // Row i is i % 3 lines tall and shows its index on every line.
+    std::vector<std::size_t> heights;
+    for (std::size_t i = 0; i < 10; ++i)
+        heights.push_back(i % 3);
+    et::VirtualList list{
+        heights.size(),
+        [&](std::size_t row) {
+            std::string str;
+            for (std::size_t i = 0; i < heights[row]; ++i)
+                str += (i > 0 ? "\n" : "") + std::to_string(row);
+            return std::make_unique<et::ascii::Text>(str);
+        },
+        [&](std::size_t row) { return heights[row]; }};
+
+    REQUIRE(list.content_height() == 9);
+    REQUIRE(list.row_offset(4) == 3);
+    REQUIRE(list.row_at(3) == 4);
+    REQUIRE(list.row_at(2) == 2);
+
+    et::Screen screen{{3, 1}};
+    et::DrawingWindow window{et::Window{{0, 0}, {3, 1}}, screen};
+
+    SECTION("Row cut off at the top") {
+        // Offset 2 is the second line of row 2.
+        list.scroll_to(2);
+        list.draw(window);
+        REQUIRE(to_string(screen.line(0)) == "2");
+        REQUIRE(to_string(screen.line(1)) == "4");
+        REQUIRE(to_string(screen.line(2)) == "5");
+    }
+    SECTION("Height update") {
+        heights[1] = 3;
+        list.update_height(1);
+        REQUIRE(list.content_height() == 11);
+        list.scroll_to_row(1);
+        list.draw(window);
+        REQUIRE(to_string(screen.line(0)) == "1");
+        REQUIRE(to_string(screen.line(2)) == "1");
+    }
+    SECTION("Null row") {
+        et::VirtualList bad{1, [](std::size_t) { return nullptr; }};
+        REQUIRE_THROWS_AS(bad.draw(window), et::EltauException);
+    }
+}